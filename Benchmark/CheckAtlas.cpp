@@ -0,0 +1,116 @@
+/// \file CheckAtlas.cpp
+/// \brief Checks and timed cases for the sprite atlas.
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "Checks.h"
+#include "AtlasFile.h"
+#include "Image.h"
+#include "SpriteSizes.h"
+#include "ComponentIncludes.h"
+
+/// Check that an atlas matches the sprite images, that is, that every
+/// sprite is in it, the same size as its image file, with the same pixels.
+/// \param atlas Atlas manifest.
+/// \param page Atlas pages.
+/// \param fname Image file name of each sprite type.
+/// \return true if the atlas matches.
+
+static bool CheckAtlas(const CAtlasFile& atlas, const std::vector<CImage>& page,
+  const std::vector<std::string>& fname)
+{
+  for(UINT i=0; i<(UINT)eSprite::Size; i++){ //for each sprite type
+    const CAtlasRecord* p = atlas.Get((eSprite)i); //where it is in the atlas
+    CImage image; //its image file
+
+    if(p == nullptr || !image.LoadPNG(fname[i]) ||
+      image.GetWidth() != p->m_nWidth || image.GetHeight() != p->m_nHeight)
+    {
+      fprintf(stderr, "Atlas is missing %s or has the wrong size\n", GetSpriteName((eSprite)i));
+      return false;
+    } //if
+
+    for(UINT y=0; y<p->m_nHeight; y++)
+      if(memcmp(page[p->m_nPage].GetPixel(p->m_nLeft, p->m_nTop + y),
+        image.GetPixel(0, y), 4*(size_t)p->m_nWidth) != 0)
+      {
+        fprintf(stderr, "Atlas does not match %s\n", fname[i].c_str());
+        return false;
+      } //if
+  } //for
+
+  return true;
+} //CheckAtlas
+
+/// Time loading the sprite images, each from its own file and all of them
+/// from the atlas pages, and loading the sprite sizes from the image files
+/// and from the atlas manifest, after checking that the atlas matches the
+/// image files. Image loading gets fewer iterations, since it takes a while.
+/// If the settings or the atlas cannot be loaded, the cases are skipped.
+/// \param r Report.
+/// \param settings Path to `gamesettings.xml`.
+/// \param fatlas Path to atlas manifest.
+/// \param iterations Number of iterations.
+/// \return true unless the atlas check failed.
+
+bool RunAtlas(CReport& r, const std::string& settings, const std::string& fatlas,
+  UINT iterations)
+{
+  if(!r.IsSelected("atlas"))return true;
+
+  std::vector<std::string> fname; //image file names
+  CAtlasFile atlas; //atlas manifest
+
+  if(!CSpriteSizes::GetImageFiles(settings, fname) || !atlas.Load(fatlas)){
+    fprintf(stderr, "Skipping atlas: cannot load %s or %s\n", settings.c_str(), fatlas.c_str());
+    return true;
+  } //if
+
+  std::vector<CImage> image((size_t)eSprite::Size); //sprite images
+  std::vector<CImage> page(atlas.GetPageCount()); //atlas pages
+
+  for(UINT i=0; i<atlas.GetPageCount(); i++)
+    if(!page[i].LoadPNG(atlas.GetPageFileName(i))){
+      fprintf(stderr, "Cannot load atlas page %s\n", atlas.GetPageFileName(i).c_str());
+      return false;
+    } //if
+
+  if(!CheckAtlas(atlas, page, fname))
+    return false;
+
+  const size_t n = (size_t)eSprite::Size; //number of sprites
+  const UINT nFew = std::max(1U, std::min(iterations, 10U)); //iterations for images
+
+  const double fImages = r.Time("atlas load images", n, nFew, [&](){
+    for(UINT i=0; i<(UINT)eSprite::Size; i++)
+      image[i].LoadPNG(fname[i]);
+  });
+
+  const double fPages = r.Time("atlas load pages", n, nFew, [&](){
+    CAtlasFile a; //atlas manifest
+    a.Load(fatlas);
+
+    for(UINT i=0; i<a.GetPageCount(); i++)
+      page[i].LoadPNG(a.GetPageFileName(i));
+  });
+
+  CSpriteSizes sizes; //sprite size table
+
+  const double fSizes = r.Time("atlas sizes images", n, iterations,
+    [&](){sizes.Load(settings);});
+
+  const double fManifest = r.Time("atlas sizes manifest", n, iterations, [&](){
+    CAtlasFile a; //atlas manifest
+    a.Load(fatlas);
+    sizes.Load(a);
+  });
+
+  r.PrintSpeedup("Atlas image load", fImages, fPages);
+  r.PrintSpeedup("Atlas size load", fSizes, fManifest);
+
+  return true;
+} //RunAtlas
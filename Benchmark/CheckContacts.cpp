@@ -0,0 +1,270 @@
+/// \file CheckContacts.cpp
+/// \brief Checks and timed cases for the contact listener and contact queue.
+
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "Checks.h"
+#include "ContactListener.h"
+#include "ContactQueue.h"
+#include "ImpactParticles.h"
+#include "VoicePool.h"
+#include "ComponentIncludes.h"
+
+/// \brief The contact benchmark.
+///
+/// The contact benchmark makes a synthetic set of contacts, each between a
+/// pair of overlapping balls whose fixtures are tagged with sprite types
+/// taken in turn from a list of the kinds of object in a level. Some of
+/// the pairs are ones that the game responds to and some are not. One
+/// contact in four has new contact points, and one in eight is between
+/// bodies moving fast enough to be heard, which is more than a level
+/// usually has in one step.
+
+class CContactBenchmark:
+  public CCommon{
+
+  private:
+    CMyListener m_cListener; ///< Contact listener.
+    CVoicePool m_cVoicePool; ///< Voice pool for the bonks.
+    CImpactParticles m_cParticles; ///< Impact particles for the collisions.
+    std::vector<b2Contact*> m_stdContact; ///< Contacts.
+    std::vector<b2Manifold> m_stdOld; ///< Old manifold for each contact.
+
+  public:
+    CContactBenchmark(CContext& c, UINT n, const std::string& settings); ///< Constructor.
+    ~CContactBenchmark(); ///< Destructor.
+
+    void Run(CReport& r, UINT iterations); ///< Run all cases.
+}; //CContactBenchmark
+
+/// Make the contacts by creating pairs of overlapping balls in a grid with
+/// no gravity, and stepping Physics World by no time at all, which finds
+/// the contacts and their manifolds without moving anything. The old
+/// manifold of a contact with new points is empty, and the old manifold
+/// of any other contact is the same as its current manifold.
+/// \param c Simulation context.
+/// \param n Number of contacts.
+/// \param settings Path to `gamesettings.xml`, for the voices of the bonk.
+
+CContactBenchmark::CContactBenchmark(CContext& c, UINT n, const std::string& settings):
+  CCommon(c),
+  m_cListener(c)
+{
+  m_pPhysicsWorld = new b2World(b2Vec2(0, 0));
+  m_pVoicePool = &m_cVoicePool;
+  m_cVoicePool.Load(settings);
+  m_pImpactParticles = &m_cParticles;
+
+  const eSprite type[] = {
+    eSprite::Ball, eSprite::Block, eSprite::Stick, eSprite::Pig, eSprite::Platform,
+    eSprite::Pin, eSprite::Ramp, eSprite::Bumper, eSprite::Basket, eSprite::Heavyball
+  }; //sprite types to take in turn
+
+  const UINT nTypes = sizeof(type)/sizeof(eSprite); //number of sprite types
+
+  b2CircleShape circle; //shape for all balls
+  circle.m_radius = 0.5f;
+
+  for(UINT i=0; i<n; i++){ //for each pair
+    const b2Vec2 pos(3.0f*(i%256), 3.0f*(i/256)); //position of pair
+
+    for(UINT j=0; j<2; j++){ //for each ball in pair
+      b2BodyDef bd; //body definition
+      bd.type = b2_dynamicBody;
+      bd.position = pos + b2Vec2(0.5f*j, 0);
+
+      b2Body* p = m_pPhysicsWorld->CreateBody(&bd);
+      b2Fixture* f = p->CreateFixture(&circle, 1.0f);
+      f->GetUserData().pointer = GetFixtureTag(type[j == 0? i%nTypes: (i/nTypes)%nTypes]);
+      p->SetLinearVelocity(b2Vec2(j == 0 && i%8 == 0? 20.0f: 1.0f, 0));
+    } //for
+  } //for
+
+  m_pPhysicsWorld->Step(0, 6, 2); //find contacts
+
+  for(b2Contact* p=m_pPhysicsWorld->GetContactList(); p; p=p->GetNext()) //for each contact
+    if(p->IsTouching()){
+      b2Manifold m = *p->GetManifold(); //old manifold
+      if(m_stdContact.size()%4 == 0)m.pointCount = 0; //so that every point is new
+      m_stdContact.push_back(p);
+      m_stdOld.push_back(m);
+    } //if
+} //constructor
+
+/// Delete Physics World, which destroys the bodies and contacts.
+
+CContactBenchmark::~CContactBenchmark(){
+  delete m_pPhysicsWorld;
+  m_pPhysicsWorld = nullptr;
+  m_pVoicePool = nullptr;
+  m_pImpactParticles = nullptr;
+} //destructor
+
+/// Time the contact listener's PreSolve() on every contact, followed by its
+/// responses to the contacts recorded, playing the sounds, and moving the
+/// impact particles, as in one frame of one step of Physics World.
+/// \param r Report.
+/// \param iterations Number of iterations.
+
+void CContactBenchmark::Run(CReport& r, UINT iterations){
+  r.Time("presolve", m_stdContact.size(), iterations, [&](){
+    for(size_t i=0; i<m_stdContact.size(); i++) //for each contact
+      m_cListener.PreSolve(m_stdContact[i], &m_stdOld[i]);
+
+    m_cListener.ProcessEvents();
+    m_cVoicePool.Flush(m_fTime += fStepTime);
+    m_cParticles.Step(fStepTime);
+  });
+} //Run
+
+/// Make a contact benchmark with a number of contacts, then time it.
+/// \param r Report.
+/// \param objects Number of contacts.
+/// \param settings Path to `gamesettings.xml`, for the voices of the bonk.
+/// \param iterations Number of iterations.
+
+void RunPreSolve(CReport& r, UINT objects, const std::string& settings, UINT iterations){
+  if(!r.IsSelected("presolve"))return;
+
+  CContext cContext; //the simulation context
+  CContactBenchmark cBenchmark(cContext, objects, settings); //the contact benchmark
+  cBenchmark.Run(r, iterations);
+} //RunPreSolve
+
+/// Merge contact events for the same pair of bodies the old way, looking
+/// for each event's pair among the events merged so far.
+/// \param v Events, oldest first.
+/// \param merged [out] Merged events, in the order their pairs first appeared.
+
+static void MergeByScan(const std::vector<CContactEvent>& v,
+  std::vector<CContactEvent>& merged)
+{
+  merged.clear();
+
+  for(const CContactEvent& e: v){ //for each event, oldest first
+    CContactEvent* pMerged = nullptr; //merged event for the same pair, if any
+
+    for(CContactEvent& m: merged) //look for the same pair
+      if((m.m_pBodyA == e.m_pBodyA && m.m_pBodyB == e.m_pBodyB) ||
+        (m.m_pBodyA == e.m_pBodyB && m.m_pBodyB == e.m_pBodyA))
+      {
+        pMerged = &m;
+        break;
+      } //if
+
+    if(pMerged == nullptr)merged.push_back(e);
+
+    else{
+      if(e.m_fSpeed > pMerged->m_fSpeed){
+        pMerged->m_vPos = e.m_vPos;
+        pMerged->m_vNormal = e.m_vNormal;
+        pMerged->m_fSpeed = e.m_fSpeed;
+      } //if
+
+      pMerged->m_nPair |= e.m_nPair;
+    } //else
+  } //for
+} //MergeByScan
+
+/// Make a contact event between two of a set of stand-in bodies, which are
+/// never looked at, only compared.
+/// \param body Stand-in bodies.
+/// \param a Index of body A.
+/// \param b Index of body B.
+/// \param speed Collision speed.
+/// \param pair Pair interest flags.
+/// \return The contact event.
+
+static CContactEvent MakeEvent(std::vector<char>& body, UINT a, UINT b,
+  float speed, UINT pair)
+{
+  CContactEvent e; //contact event
+  e.m_pBodyA = (b2Body*)&body[a];
+  e.m_pBodyB = (b2Body*)&body[b];
+  e.m_vPos = b2Vec2(speed, (float)a);
+  e.m_fSpeed = speed;
+  e.m_nPair = pair;
+  return e;
+} //MakeEvent
+
+/// Check that the contact queue drops only events that may be dropped when
+/// it is full, that events that must be kept take the place of those or
+/// overflow, and that merging events by sorting them gives the same result
+/// as merging them the old way.
+/// \return true if the contact queue did all that.
+
+static bool CheckContactQueue(){
+  const UINT KEEP = 2; //flag for events that must be kept
+  std::vector<char> body(512); //stand-in bodies
+  std::vector<CContactEvent> pushed, merged; //events pushed and merged the old way
+  std::unique_ptr<CContactQueue> q(new CContactQueue); //contact queue
+  q->SetKeep(KEEP);
+
+  for(UINT i=0; i<300; i++){ //more sounds than fit, some pairs in both orders
+    const UINT a = i%100, b = 100 + i%37; //bodies
+    const CContactEvent e = MakeEvent(body, i&1? a: b, i&1? b: a, (float)(i%53), 1);
+    if(q->Push(e))pushed.push_back(e);
+  } //for
+
+  for(UINT i=0; i<3; i++) //game logic when full
+    q->Push(MakeEvent(body, 200 + i, 300, 10.0f, KEEP));
+
+  for(UINT i=0; i<3; i++) //they replaced the newest sounds
+    pushed[pushed.size() - 1 - i] = MakeEvent(body, 200 + i, 300, 10.0f, KEEP);
+
+  const UINT nDropped = q->GetDropped(); //44 that didn't fit, 3 replaced
+  MergeByScan(pushed, merged);
+  const std::vector<CContactEvent>& v = q->Drain(); //merged the new way
+  bool bSame = v.size() == merged.size();
+
+  for(size_t i=0; bSame && i<v.size(); i++)
+    bSame = v[i].m_pBodyA == merged[i].m_pBodyA && v[i].m_pBodyB == merged[i].m_pBodyB &&
+      v[i].m_fSpeed == merged[i].m_fSpeed && v[i].m_vPos == merged[i].m_vPos &&
+      v[i].m_nPair == merged[i].m_nPair;
+
+  for(UINT i=0; i<260; i++) //more game logic than fits
+    q->Push(MakeEvent(body, i, 300 + i%2, 10.0f, KEEP));
+
+  const UINT nKept = q->GetCount(); //all of them
+  const UINT nMerged = (UINT)q->Drain().size(); //one per pair
+
+  if(!bSame || nDropped != 47 || nKept != 260 || nMerged != 260 || q->GetDropped() != 47){
+    fprintf(stderr, "Contact queue: %s old way, dropped %u, kept %u, merged %u\n",
+      bSame? "same as": "different from", nDropped, nKept, nMerged);
+    return false;
+  } //if
+
+  return true;
+} //CheckContactQueue
+
+/// Check the contact queue, then time merging a full queue of events for
+/// 128 pairs of bodies the old way and by sorting.
+/// \param r Report.
+/// \param iterations Number of iterations.
+/// \return true unless the check failed.
+
+bool RunContactQueue(CReport& r, UINT iterations){
+  if(!r.IsSelected("queue"))return true;
+  if(!CheckContactQueue())return false;
+
+  const UINT n = 256; //number of events
+  std::vector<char> body(256); //stand-in bodies
+  std::vector<CContactEvent> events, merged; //events and merged events
+  std::unique_ptr<CContactQueue> q(new CContactQueue); //contact queue
+
+  for(UINT i=0; i<n; i++)
+    events.push_back(MakeEvent(body, i%128, 128 + (i*7)%128, (float)(i%31), 1));
+
+  const double t0 = r.Time("queue merge scan", n, iterations,
+    [&](){MergeByScan(events, merged);});
+
+  const double t1 = r.Time("queue merge sort", n, iterations,
+    [&](){q->Drain();},
+    [&](){for(const CContactEvent& e: events)q->Push(e);});
+
+  r.PrintSpeedup("contact queue merge", t0, t1);
+  return true;
+} //RunContactQueue
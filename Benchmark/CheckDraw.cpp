@@ -0,0 +1,639 @@
+/// \file CheckDraw.cpp
+/// \brief Checks and timed cases for the draw pass.
+
+#include <algorithm>
+#include <cstdio>
+#include <random>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include "Checks.h"
+#include "Object.h"
+#include "Outline.h"
+#include "OutlineDrawer.h"
+#include "TransformCache.h"
+#include "ComponentIncludes.h"
+
+/// \brief A line record.
+///
+/// What the recording renderer keeps for each line that it is asked to draw.
+
+struct CLineRecord{
+  eSprite m_eSprite = eSprite::Size; ///< Sprite type.
+  Vector2 m_vStart; ///< Start in renderer coordinates.
+  Vector2 m_vEnd; ///< End in renderer coordinates.
+}; //CLineRecord
+
+/// \brief The recording renderer.
+///
+/// The recording renderer draws body outlines with the same outline drawer
+/// as the game's renderer, but instead of drawing each line and sprite it
+/// records it, so that outline drawing can be timed and checked without a
+/// window.
+
+class CRecordingRenderer: public COutlineDrawer<CRecordingRenderer>{
+  friend class COutlineDrawer<CRecordingRenderer>;
+
+  private:
+    float m_fLineWidth = 3.0f; ///< Width of the line sprite.
+
+    std::vector<CLineRecord> m_stdLine; ///< Lines drawn.
+    std::vector<CDrawRecord> m_stdSprite; ///< Sprites drawn.
+
+    void DrawLine(eSprite t, const Vector2& p0, const Vector2& p1); ///< Record a line.
+    void Draw(eSprite t, const Vector2& p, float a); ///< Record a sprite.
+    float GetWidth(eSprite t) const; ///< Get width of a sprite.
+
+  public:
+    void Clear(); ///< Forget everything drawn.
+
+    size_t GetCount() const; ///< Get number of lines and sprites drawn.
+    bool operator==(const CRecordingRenderer& r) const; ///< Whether the same was drawn.
+}; //CRecordingRenderer
+
+/// Record a line.
+/// \param t Sprite type.
+/// \param p0 Start in renderer coordinates.
+/// \param p1 End in renderer coordinates.
+
+void CRecordingRenderer::DrawLine(eSprite t, const Vector2& p0, const Vector2& p1){
+  m_stdLine.push_back({t, p0, p1});
+} //DrawLine
+
+/// Record a sprite.
+/// \param t Sprite type.
+/// \param p Position in renderer coordinates.
+/// \param a Orientation.
+
+void CRecordingRenderer::Draw(eSprite t, const Vector2& p, float a){
+  m_stdSprite.push_back({t, p.x, p.y, a});
+} //Draw
+
+/// Reader function for the width of a sprite. Only line sprites are drawn,
+/// so every sprite is as wide as the line sprite.
+/// \param t Sprite type.
+/// \return Width in renderer units.
+
+float CRecordingRenderer::GetWidth(eSprite t) const{
+  return m_fLineWidth;
+} //GetWidth
+
+/// Forget all of the lines and sprites drawn, keeping the memory.
+
+void CRecordingRenderer::Clear(){
+  m_stdLine.clear();
+  m_stdSprite.clear();
+} //Clear
+
+/// Reader function for the number of lines and sprites drawn.
+/// \return Number of lines and sprites drawn since the last Clear().
+
+size_t CRecordingRenderer::GetCount() const{
+  return m_stdLine.size() + m_stdSprite.size();
+} //GetCount
+
+/// Compare what was drawn with what another recording renderer drew. The
+/// lines and sprites need not be in the same order, so long as the same
+/// ones were drawn, since the batch draws all of the circles last.
+/// \param r Recording renderer.
+/// \return true if they drew exactly the same lines and sprites.
+
+bool CRecordingRenderer::operator==(const CRecordingRenderer& r) const{
+  if(m_stdLine.size() != r.m_stdLine.size() || m_stdSprite.size() != r.m_stdSprite.size())
+    return false;
+
+  auto lineless = [](const CLineRecord& a, const CLineRecord& b){
+    return std::make_tuple(a.m_eSprite, a.m_vStart.x, a.m_vStart.y, a.m_vEnd.x, a.m_vEnd.y) <
+      std::make_tuple(b.m_eSprite, b.m_vStart.x, b.m_vStart.y, b.m_vEnd.x, b.m_vEnd.y);
+  }; //lineless
+
+  auto spriteless = [](const CDrawRecord& a, const CDrawRecord& b){
+    return std::make_tuple(a.m_eSprite, a.m_fX, a.m_fY, a.m_fAngle) <
+      std::make_tuple(b.m_eSprite, b.m_fX, b.m_fY, b.m_fAngle);
+  }; //spriteless
+
+  std::vector<CLineRecord> l0(m_stdLine), l1(r.m_stdLine); //lines, to be sorted
+  std::vector<CDrawRecord> s0(m_stdSprite), s1(r.m_stdSprite); //sprites, to be sorted
+
+  std::sort(l0.begin(), l0.end(), lineless);
+  std::sort(l1.begin(), l1.end(), lineless);
+  std::sort(s0.begin(), s0.end(), spriteless);
+  std::sort(s1.begin(), s1.end(), spriteless);
+
+  for(size_t i=0; i<l0.size(); i++) //for each line
+    if(lineless(l0[i], l1[i]) || lineless(l1[i], l0[i]))
+      return false;
+
+  for(size_t i=0; i<s0.size(); i++) //for each sprite
+    if(spriteless(s0[i], s1[i]) || spriteless(s1[i], s0[i]))
+      return false;
+
+  return true;
+} //operator==
+
+/// \brief The draw benchmark.
+///
+/// The draw benchmark fills Physics World with objects and times the ways
+/// of getting their transforms and outlines ready to draw, and of drawing
+/// the outlines.
+
+class CBenchmark:
+  public CCommon{
+
+  private:
+    std::vector<CObject*> m_stdObject; ///< Objects, as in the object list.
+    CTransformCache m_cTransforms; ///< Transform cache for the same objects.
+    std::vector<CDrawRecord> m_stdRecord; ///< Sprite batch records.
+
+    COutline m_cOutline; ///< Outline builder.
+    std::vector<Vector2> m_stdLine; ///< Lines drawn one side at a time, two vertices per line.
+    std::vector<Vector2> m_stdCircleCenter; ///< Centers of circles drawn one at a time.
+    std::vector<float> m_stdCircleRadius; ///< Radii of circles drawn one at a time.
+
+    CRecordingRenderer m_cPerBody; ///< Records outlines drawn one body at a time.
+    CRecordingRenderer m_cBatch; ///< Records outlines drawn in a batch.
+
+    void DrawPerObject(); ///< Fill records one object at a time.
+    void DrawFromCache(); ///< Fill records from the transform cache.
+    bool Check(); ///< Check the two ways agree.
+
+    void OutlinePerEdge(); ///< Build outlines one side at a time.
+    void OutlineBatch(); ///< Build outlines in a batch.
+    bool CompareOutlines(); ///< Compare outlines built both ways.
+    bool CheckOutlines(); ///< Check the two ways of building outlines agree.
+
+    void SleepMost(); ///< Put most bodies to sleep.
+    void Nudge(); ///< Move the bodies that are awake.
+    void DrawKept(); ///< Gather transforms and update kept outlines.
+    bool CheckSleeping(); ///< Check the ways agree when most bodies are asleep.
+
+    void DrawOutlinesPerBody(); ///< Draw outlines one body at a time.
+    void DrawOutlinesBatch(); ///< Draw outlines in a batch.
+    bool CheckDrawOutlines(); ///< Check the two ways of drawing outlines agree.
+    bool CompareCulled(const std::vector<UINT>& v, bool bCull); ///< Compare some outlines drawn both ways.
+    bool CheckCulledOutlines(); ///< Check drawing some outlines from a kept batch.
+
+  public:
+    CBenchmark(CContext& c, UINT n); ///< Constructor.
+    ~CBenchmark(); ///< Destructor.
+
+    bool Run(CReport& r, UINT iterations); ///< Run all cases.
+}; //CBenchmark
+
+/// Create a Physics World with no gravity and fill it with dynamic balls
+/// and blocks, alternately, scattered around the window, each with a
+/// rotation. The object list is
+/// shuffled so that consecutive objects are not next to each other in
+/// memory, as happens in the game when objects are created and destroyed
+/// over time.
+/// \param c Simulation context.
+/// \param n Number of objects.
+
+CBenchmark::CBenchmark(CContext& c, UINT n):
+  CCommon(c)
+{
+  m_pPhysicsWorld = new b2World(b2Vec2(0, 0));
+
+  std::mt19937 stdRandom(1); //fixed seed, so that runs are comparable
+
+  b2CircleShape circle; //shape for all balls
+  circle.m_radius = RW2PW(22);
+
+  b2PolygonShape box; //shape for all blocks
+  box.SetAsBox(RW2PW(20), RW2PW(20));
+
+  std::vector<std::pair<CObject*, b2Body*>> stdPair; //objects and their bodies
+
+  for(UINT i=0; i<n; i++){ //for each object
+    b2BodyDef bd; //body definition
+    bd.type = b2_dynamicBody;
+    bd.position.Set(RW2PW((int)(stdRandom()%1024)), RW2PW((int)(stdRandom()%768)));
+    bd.angle = XM_2PI*(stdRandom()%360)/360.0f;
+
+    const bool bBall = i%2 == 0; //alternate balls and blocks
+    b2Body* p = m_pPhysicsWorld->CreateBody(&bd);
+
+    if(bBall)p->CreateFixture(&circle, 1.0f);
+    else p->CreateFixture(&box, 1.0f);
+
+    stdPair.push_back(std::make_pair(new CObject(bBall? eSprite::Ball: eSprite::Block, p), p));
+  } //for
+
+  std::shuffle(stdPair.begin(), stdPair.end(), stdRandom);
+
+  for(auto const& p: stdPair){ //for each object in list order
+    m_stdObject.push_back(p.first);
+    m_cTransforms.Add(p.first->GetSpriteType(), p.second);
+  } //for
+
+  m_stdRecord.resize(n);
+} //constructor
+
+/// Delete the objects, then Physics World, which destroys their bodies.
+
+CBenchmark::~CBenchmark(){
+  for(auto const& p: m_stdObject) //for each object
+    delete p;
+
+  delete m_pPhysicsWorld;
+  m_pPhysicsWorld = nullptr;
+} //destructor
+
+/// Fill in the sprite batch records the way that the object manager used
+/// to, asking each object for its own position and orientation.
+
+void CBenchmark::DrawPerObject(){
+  for(size_t i=0; i<m_stdObject.size(); i++){ //for each object
+    const CObject* p = m_stdObject[i];
+    const Vector2 v = p->GetPos(); //position in renderer units
+
+    CDrawRecord& r = m_stdRecord[i];
+    r.m_eSprite = p->GetSpriteType();
+    r.m_fX = v.x;
+    r.m_fY = v.y;
+    r.m_fAngle = p->GetAngle();
+  } //for
+} //DrawPerObject
+
+/// Fill in the sprite batch records the way that the object manager does
+/// now, gathering all of the transforms first and then reading them from
+/// the arrays in the transform cache.
+
+void CBenchmark::DrawFromCache(){
+  m_cTransforms.Gather();
+
+  const size_t n = m_cTransforms.GetSize(); //number of objects
+  const float* x = m_cTransforms.GetX(); //x coordinates
+  const float* y = m_cTransforms.GetY(); //y coordinates
+  const float* a = m_cTransforms.GetAngle(); //orientations
+
+  for(size_t i=0; i<n; i++){ //for each object
+    CDrawRecord& r = m_stdRecord[i];
+    r.m_eSprite = m_cTransforms.GetSprite(i);
+    r.m_fX = x[i];
+    r.m_fY = y[i];
+    r.m_fAngle = a[i];
+  } //for
+} //DrawFromCache
+
+/// Check that filling in the records from the transform cache gives the
+/// same results as filling them in one object at a time.
+/// \return true if they are the same.
+
+bool CBenchmark::Check(){
+  DrawPerObject();
+  const std::vector<CDrawRecord> stdExpected = m_stdRecord;
+  DrawFromCache();
+
+  for(size_t i=0; i<m_stdRecord.size(); i++){ //for each record
+    const CDrawRecord& r0 = stdExpected[i];
+    const CDrawRecord& r1 = m_stdRecord[i];
+
+    if(r0.m_eSprite != r1.m_eSprite || r0.m_fX != r1.m_fX ||
+      r0.m_fY != r1.m_fY || r0.m_fAngle != r1.m_fAngle)
+    {
+      fprintf(stderr, "Record %u differs\n", (UINT)i);
+      return false;
+    } //if
+  } //for
+
+  return true;
+} //Check
+
+/// Build the outlines of all of the bodies the way that the renderer used
+/// to, one fixture at a time, with the rotation of a polygon's vertices
+/// computed afresh for each vertex, but where the transform cache says the
+/// bodies are, as the outline builder does. Lines and circles are recorded
+/// instead of being drawn.
+
+void CBenchmark::OutlinePerEdge(){
+  m_stdLine.clear();
+  m_stdCircleCenter.clear();
+  m_stdCircleRadius.clear();
+
+  const float* x = m_cTransforms.GetX(); //x coordinates
+  const float* y = m_cTransforms.GetY(); //y coordinates
+  const float* a = m_cTransforms.GetAngle(); //orientations
+
+  for(size_t i=0; i<m_cTransforms.GetSize(); i++){ //for each body
+    b2Body* pBody = m_cTransforms.GetBody(i);
+
+    for(b2Fixture* f=pBody->GetFixtureList(); f; f=f->GetNext()){ //for each fixture
+      const b2Vec2 pos(RW2PW(x[i]), RW2PW(y[i])); //position in Physics World
+      const float theta = a[i]; //orientation
+      b2Shape* s = f->GetShape();
+
+      switch(s->GetType()){
+        case b2Shape::e_circle:
+          m_stdCircleCenter.push_back(PW2RW(pos));
+          m_stdCircleRadius.push_back(PW2RW(s->m_radius));
+          break;
+
+        case b2Shape::e_edge: {
+          const b2EdgeShape* p = (b2EdgeShape*)s;
+          m_stdLine.push_back(PW2RW(pos + p->m_vertex1));
+          m_stdLine.push_back(PW2RW(pos + p->m_vertex2));
+        } //case
+        break;
+
+        case b2Shape::e_polygon: {
+          const b2PolygonShape* p = (b2PolygonShape*)s;
+          const Vector2 p0 = PW2RW(pos + b2Mul(b2Rot(theta), p->m_vertices[0]));
+          Vector2 p1(p0); //first point
+
+          for(int32 j=1; j<p->m_count; j++){ //for each vertex after the first
+            const Vector2 p2 = PW2RW(pos + b2Mul(b2Rot(theta), p->m_vertices[j])); //second point
+            m_stdLine.push_back(p1);
+            m_stdLine.push_back(p2);
+            p1 = p2; //move on to next point
+          } //for
+
+          m_stdLine.push_back(p0);
+          m_stdLine.push_back(p1);
+        } //case
+        break;
+
+        default: break;
+      } //switch
+    } //for
+  } //for
+} //OutlinePerEdge
+
+/// Build the outlines of all of the bodies the way that the renderer does
+/// now, in one batch in the outline builder.
+
+void CBenchmark::OutlineBatch(){
+  m_cOutline.BeginBatch();
+
+  for(size_t i=0; i<m_cTransforms.GetSize(); i++) //for each body
+    m_cOutline.AddBody(m_cTransforms, i);
+} //OutlineBatch
+
+/// Compare the lines and circles in the outline builder's batch with
+/// those built one side at a time.
+/// \return true if they are exactly the same, in the same order.
+
+bool CBenchmark::CompareOutlines(){
+  if(m_cOutline.GetLineCount() != m_stdLine.size()/2 ||
+    m_cOutline.GetCircleCount() != m_stdCircleCenter.size())
+  {
+    fprintf(stderr, "Outline batch has %u lines and %u circles, expected %u and %u\n",
+      (UINT)m_cOutline.GetLineCount(), (UINT)m_cOutline.GetCircleCount(),
+      (UINT)m_stdLine.size()/2, (UINT)m_stdCircleCenter.size());
+    return false;
+  } //if
+
+  const Vector2* v = m_cOutline.GetLines(); //line vertices
+
+  for(size_t i=0; i<m_stdLine.size(); i++) //for each line vertex
+    if(v[i].x != m_stdLine[i].x || v[i].y != m_stdLine[i].y){
+      fprintf(stderr, "Outline batch line vertex %u differs\n", (UINT)i);
+      return false;
+    } //if
+
+  const Vector2* c = m_cOutline.GetCircleCenters(); //circle centers
+  const float* r = m_cOutline.GetCircleRadii(); //circle radii
+
+  for(size_t i=0; i<m_stdCircleCenter.size(); i++) //for each circle
+    if(c[i].x != m_stdCircleCenter[i].x || c[i].y != m_stdCircleCenter[i].y ||
+      r[i] != m_stdCircleRadius[i])
+    {
+      fprintf(stderr, "Outline batch circle %u differs\n", (UINT)i);
+      return false;
+    } //if
+
+  return true;
+} //CompareOutlines
+
+/// Check that building outlines in a batch gives exactly the same lines
+/// and circles, in the same order, as building them one side at a time.
+/// \return true if they are the same.
+
+bool CBenchmark::CheckOutlines(){
+  OutlinePerEdge();
+  OutlineBatch();
+  return CompareOutlines();
+} //CheckOutlines
+
+/// Put every body to sleep except one in ten.
+
+void CBenchmark::SleepMost(){
+  for(size_t i=0; i<m_cTransforms.GetSize(); i++) //for each body
+    if(i%10 != 0)
+      m_cTransforms.GetBody(i)->SetAwake(false);
+} //SleepMost
+
+/// Move and turn each body that is awake a little, as a physics step
+/// would, without waking any others.
+
+void CBenchmark::Nudge(){
+  for(size_t i=0; i<m_cTransforms.GetSize(); i++){ //for each body
+    b2Body* p = m_cTransforms.GetBody(i);
+
+    if(p->IsAwake())
+      p->SetTransform(p->GetPosition() + b2Vec2(0.01f, -0.01f), p->GetAngle() + 0.01f);
+  } //for
+} //Nudge
+
+/// Gather the transforms that changed and bring the kept outline batch up
+/// to date, then start a new list of bodies that moved, as the draw pass
+/// does each frame.
+
+void CBenchmark::DrawKept(){
+  DrawFromCache();
+  m_cOutline.UpdateBatch(m_cTransforms);
+  m_cTransforms.ClearMoved();
+} //DrawKept
+
+/// Put most of the bodies to sleep and nudge the rest. Check that the
+/// transform cache, which now reads only the bodies that are awake, still
+/// gives the same results as filling in the records one object at a time,
+/// and that the kept outline batch, which now builds only the outlines of
+/// the bodies that moved, still gives the same lines and circles as
+/// building them one side at a time.
+/// \return true if they are the same.
+
+bool CBenchmark::CheckSleeping(){
+  SleepMost();
+  DrawKept(); //the bodies that fell asleep are read one last time
+  Nudge();
+
+  if(!Check())
+    return false;
+
+  m_cOutline.UpdateBatch(m_cTransforms);
+  m_cTransforms.ClearMoved();
+  OutlinePerEdge();
+  return CompareOutlines();
+} //CheckSleeping
+
+/// Draw the outline of each body, one body at a time, into a recording
+/// renderer, the way that the renderer used to when each object drew
+/// itself.
+
+void CBenchmark::DrawOutlinesPerBody(){
+  m_cPerBody.Clear();
+
+  for(size_t i=0; i<m_cTransforms.GetSize(); i++) //for each body
+    m_cPerBody.Drawb2Body(eSprite::Line, m_cTransforms, i);
+} //DrawOutlinesPerBody
+
+/// Draw the outlines of all of the bodies in one batch into a recording
+/// renderer, the way that the renderer does now.
+
+void CBenchmark::DrawOutlinesBatch(){
+  m_cBatch.Clear();
+  m_cBatch.Drawb2Bodies(eSprite::Line, m_cTransforms);
+} //DrawOutlinesBatch
+
+/// Check that drawing the outlines in a batch draws the same lines and
+/// sprites as drawing them one body at a time, at both levels of detail.
+/// \return true if they are the same.
+
+bool CBenchmark::CheckDrawOutlines(){
+  for(UINT i=0; i<2; i++){ //for each level of detail
+    m_cPerBody.SetOutlineLOD(i == 1);
+    m_cBatch.SetOutlineLOD(i == 1);
+
+    DrawOutlinesPerBody();
+    DrawOutlinesBatch();
+
+    if(!(m_cPerBody == m_cBatch)){
+      fprintf(stderr, "Outlines drawn in a batch differ at %s detail\n", i == 1? "lower": "full");
+      return false;
+    } //if
+  } //for
+
+  m_cPerBody.SetOutlineLOD(false);
+  m_cBatch.SetOutlineLOD(false);
+  return true;
+} //CheckDrawOutlines
+
+/// Draw the outlines of some of the bodies one at a time, and from the
+/// kept batch, either culled to those bodies or not, and compare them.
+/// The transform cache then starts a new list of bodies that moved, as
+/// the draw pass does.
+/// \param v Indices of bodies, in increasing order.
+/// \param bCull true to draw only those bodies from the kept batch, false
+///   to draw all of them, in which case v must hold all of them.
+/// \return true if the same lines and sprites were drawn.
+
+bool CBenchmark::CompareCulled(const std::vector<UINT>& v, bool bCull){
+  m_cTransforms.Gather();
+  m_cPerBody.Clear();
+
+  for(const UINT i: v) //for each body
+    m_cPerBody.Drawb2Body(eSprite::Line, m_cTransforms, i);
+
+  m_cBatch.Clear();
+  if(bCull)m_cBatch.Drawb2Bodies(eSprite::Line, m_cTransforms, v);
+  else m_cBatch.Drawb2Bodies(eSprite::Line, m_cTransforms);
+
+  m_cTransforms.ClearMoved();
+  return m_cPerBody == m_cBatch;
+} //CompareCulled
+
+/// Check that drawing the outlines of only some of the bodies from the
+/// kept batch draws what drawing those bodies one at a time does, while
+/// the bodies that are awake move between frames. The bodies on the left
+/// of the window are drawn first, so the ones on the right that move are
+/// left stale. Then the ones on the right are drawn, which must build them
+/// again, and then all of them without culling, which must catch up with
+/// the ones on the left that were left stale in turn.
+/// \return true if they are the same.
+
+bool CBenchmark::CheckCulledOutlines(){
+  std::vector<UINT> left, right, all; //indices of bodies
+  const float* x = m_cTransforms.GetX(); //x coordinates
+
+  for(UINT i=0; i<(UINT)m_cTransforms.GetSize(); i++){ //for each body
+    (x[i] < 512.0f? left: right).push_back(i);
+    all.push_back(i);
+  } //for
+
+  bool bOK = CompareCulled(left, true);
+  Nudge();
+  bOK = bOK && CompareCulled(right, true);
+  Nudge();
+  bOK = bOK && CompareCulled(all, false);
+
+  if(!bOK)
+    fprintf(stderr, "Culled outlines differ from outlines drawn one body at a time\n");
+
+  return bOK;
+} //CheckCulledOutlines
+
+/// Check that the old and new ways agree, then time them.
+/// \param r Report.
+/// \param iterations Number of iterations of each case.
+/// \return true if the old and new ways agree.
+
+bool CBenchmark::Run(CReport& r, UINT iterations){
+  if(!Check() || !CheckOutlines() || !CheckDrawOutlines())
+    return false;
+
+  const size_t n = m_stdObject.size(); //number of objects
+
+  const double t0 = r.Time("draw per object", n, iterations, [&](){DrawPerObject();});
+  const double t1 = r.Time("draw from transform cache", n, iterations, [&](){DrawFromCache();});
+  const double t2 = r.Time("outline per edge", n, iterations, [&](){OutlinePerEdge();});
+  const double t3 = r.Time("outline batch", n, iterations, [&](){OutlineBatch();});
+  const double t4 = r.Time("draw outlines per body", n, iterations, [&](){DrawOutlinesPerBody();});
+  const double t5 = r.Time("draw outlines batch", n, iterations, [&](){DrawOutlinesBatch();});
+
+  r.PrintSpeedup("transform cache", t0, t1);
+  r.PrintSpeedup("outline batch", t2, t3);
+  r.PrintSpeedup("draw outlines batch", t4, t5);
+
+  if(!CheckSleeping())
+    return false;
+
+  const double t6 = r.Time("draw from transform cache with 10% awake", n, iterations, [&](){
+    DrawFromCache(); m_cTransforms.ClearMoved();});
+  const double t7 = r.Time("draw and outline kept batch with 10% awake", n, iterations, [&](){DrawKept();});
+
+  r.PrintSpeedup("transform cache with 10% awake", t1, t6);
+  r.PrintSpeedup("kept outline batch with 10% awake", t1 + t3, t7);
+
+  if(!CheckCulledOutlines())
+    return false;
+
+  std::vector<UINT> quarter; //indices of the bodies in the bottom left quarter of the window
+  const float* x = m_cTransforms.GetX(); //x coordinates
+  const float* y = m_cTransforms.GetY(); //y coordinates
+
+  for(UINT i=0; i<(UINT)n; i++) //for each body
+    if(x[i] < 512.0f && y[i] < 384.0f)
+      quarter.push_back(i);
+
+  const double t8 = r.Time("draw outlines kept batch with 10% awake", n, iterations, [&](){
+    m_cTransforms.Gather();
+    m_cBatch.Clear();
+    m_cBatch.Drawb2Bodies(eSprite::Line, m_cTransforms);
+    m_cTransforms.ClearMoved();});
+
+  const double t9 = r.Time("draw outlines culled to a quarter with 10% awake", n, iterations, [&](){
+    m_cTransforms.Gather();
+    m_cBatch.Clear();
+    m_cBatch.Drawb2Bodies(eSprite::Line, m_cTransforms, quarter);
+    m_cTransforms.ClearMoved();});
+
+  r.PrintSpeedup("culling outlines to a quarter", t8, t9);
+  return true;
+} //Run
+
+/// Make a draw benchmark with a number of objects, check that the old and
+/// new ways agree, then time them.
+/// \param r Report.
+/// \param objects Number of objects.
+/// \param iterations Number of iterations of each case.
+/// \return true unless a check failed.
+
+bool RunDraw(CReport& r, UINT objects, UINT iterations){
+  if(!r.IsSelected("draw") && !r.IsSelected("outline"))return true;
+
+  CContext cContext; //the simulation context
+  CBenchmark cBenchmark(cContext, objects); //the draw benchmark
+  return cBenchmark.Run(r, iterations);
+} //RunDraw
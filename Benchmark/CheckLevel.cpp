@@ -0,0 +1,125 @@
+/// \file CheckLevel.cpp
+/// \brief Checks and timed cases for the machine built from the level file.
+
+#include <algorithm>
+#include <cstdio>
+#include <string>
+#include <thread>
+
+#include "Checks.h"
+#include "Bird.h"
+#include "ObjectManager.h"
+#include "Optimizer.h"
+#include "ComponentIncludes.h"
+
+/// Run the machine from launch until it finishes or a minute of simulated
+/// time has gone by, and check that the bird was launched and that the
+/// machine finished, which it does when something hits the pig. This is
+/// done twice, once on the level as it was built and once after it was
+/// reset, which checks that the catapult and bird work again after a reset.
+/// \param c Simulation context.
+/// \param m The machine, with its level loaded.
+/// \return true if the bird was launched and the machine finished both times.
+
+static bool CheckLevelRun(CContext& c, CMachine& m){
+  const float fTimeout = 60.0f; //time to give up in seconds
+
+  for(UINT i=0; i<2; i++){ //as built, then reset
+    m.Reset();
+    m.Launch();
+
+    const float fEnd = c.m_fTime + fTimeout; //time to give up
+
+    while(c.m_eGameState != eGameState::Finished && c.m_fTime < fEnd)
+      m.Step(fStepTime);
+
+    const bool bLaunched = c.m_pBird != nullptr && c.m_pBird->IsLaunched();
+    const bool bFinished = c.m_eGameState == eGameState::Finished;
+
+    if(!bLaunched || !bFinished){
+      fprintf(stderr, "Level run %u: bird %s, machine %s\n", i,
+        bLaunched? "launched": "not launched", bFinished? "finished": "did not finish");
+      return false;
+    } //if
+  } //for
+
+  return true;
+} //CheckLevelRun
+
+/// Check that the machine built from a level file runs to the finish, then
+/// time a full step of it, from launch onwards. If the sprite sizes or the
+/// level cannot be loaded, the case is skipped.
+/// \param r Report.
+/// \param f Level fixture to build the level in.
+/// \param level Path to binary level file.
+/// \param iterations Number of steps.
+/// \return true unless the check failed.
+
+bool RunLevel(CReport& r, CLevelFixture& f, const std::string& level, UINT iterations){
+  if(!r.IsSelected("level step"))return true;
+
+  if(!f.BuildLevel(level)){
+    fprintf(stderr, "Skipping level step: cannot load %s or %s\n",
+      f.GetSettings().c_str(), level.c_str());
+    return true;
+  } //if
+
+  CContext& c = f.GetContext(); //simulation context
+  CMachine& cMachine = f.GetMachine(); //the machine
+
+  if(!CheckLevelRun(c, cMachine))
+    return false;
+
+  cMachine.Reset();
+  cMachine.Launch();
+
+  r.Time("level step", c.m_pObjectManager->GetObjectCount(), iterations,
+    [&](){cMachine.Step(fStepTime);});
+
+  return true;
+} //RunLevel
+
+/// Check that the optimizer finds the same best candidate for the same
+/// seed whatever the number of threads, by running a short search on one
+/// thread and again on several. If the sprite sizes or the level cannot be
+/// loaded, the check is skipped.
+/// \param r Report.
+/// \param settings Path to `gamesettings.xml`.
+/// \param level Path to binary level file.
+/// \return true unless the check failed.
+
+bool RunOptimizer(CReport& r, const std::string& settings, const std::string& level){
+  if(!r.IsSelected("optimizer"))return true;
+
+  const UINT nThreads = std::max(2U, std::thread::hardware_concurrency()); //more than one
+  CCandidate best[2]; //best candidate with one thread and with several
+  bool bFinished[2] = {false, false}; //whether any candidate finished
+
+  for(UINT i=0; i<2; i++){ //one thread, then several
+    COptimizer cOptimizer(i == 0? 1: nThreads, 1); //same seed both times
+    cOptimizer.SetOutput(nullptr);
+
+    if(!cOptimizer.Initialize(settings, level, "", fStepTime, 60.0f)){
+      fprintf(stderr, "Skipping optimizer: cannot load %s or %s\n",
+        settings.c_str(), level.c_str());
+      return true;
+    } //if
+
+    cOptimizer.Run(4, 1);
+    bFinished[i] = cOptimizer.GetBest(best[i]);
+  } //for
+
+  bool bSame = bFinished[0] == bFinished[1] && best[0].m_fTime == best[1].m_fTime;
+
+  for(UINT j=0; j<CCandidate::PARAMS; j++) //for each parameter
+    bSame = bSame && best[0].m_fValue[j] == best[1].m_fValue[j];
+
+  if(!bSame){
+    fprintf(stderr, "Optimizer found %.3f s with 1 thread and %.3f s with %u threads\n",
+      best[0].m_fTime, best[1].m_fTime, nThreads);
+    return false;
+  } //if
+
+  fprintf(stderr, "Optimizer found the same best candidate with 1 and %u threads\n", nThreads);
+  return true;
+} //RunOptimizer
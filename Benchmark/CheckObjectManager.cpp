@@ -0,0 +1,85 @@
+/// \file CheckObjectManager.cpp
+/// \brief Timed cases for the object manager.
+
+#include <algorithm>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "Checks.h"
+#include "ObjectManager.h"
+#include "TransformCache.h"
+#include "ComponentIncludes.h"
+
+/// Time object manager creating a number of objects, clearing them, and
+/// getting them ready to draw, which is all of the draw pass but the
+/// renderer, followed by filling in the sprite batch records from the
+/// transform cache. The objects are dynamic balls and blocks scattered
+/// around the window. Creating and clearing are each timed with the other
+/// done first, untimed. Large numbers of objects get fewer iterations of
+/// these, so that they don't take too long.
+/// \param r Report.
+/// \param n Number of objects.
+/// \param iterations Number of iterations.
+
+void RunObjectManager(CReport& r, UINT n, UINT iterations){
+  const std::string suffix = " " + std::to_string(n); //case name suffix
+  const std::string create = "object manager create" + suffix; //case names
+  const std::string clear = "object manager clear" + suffix;
+  const std::string draw = "object manager draw" + suffix;
+
+  if(!r.IsSelected(create.c_str()) && !r.IsSelected(clear.c_str()) &&
+    !r.IsSelected(draw.c_str()))
+    return;
+
+  CContext c; //simulation context
+  c.m_pPhysicsWorld = new b2World(b2Vec2(0, 0));
+  c.m_pObjectManager = new CObjectManager(c);
+  CObjectManager* pObjectManager = c.m_pObjectManager;
+
+  b2CircleShape circle; //shape for all balls
+  circle.m_radius = RW2PW(22);
+
+  b2PolygonShape box; //shape for all blocks
+  box.SetAsBox(RW2PW(20), RW2PW(20));
+
+  auto fCreate = [&](){
+    std::mt19937 stdRandom(1); //fixed seed, so that runs are comparable
+
+    for(UINT i=0; i<n; i++){ //for each object
+      b2BodyDef bd; //body definition
+      bd.type = b2_dynamicBody;
+      bd.position.Set(RW2PW((int)(stdRandom()%1024)), RW2PW((int)(stdRandom()%768)));
+      bd.angle = XM_2PI*(stdRandom()%360)/360.0f;
+
+      const bool bBall = i%2 == 0; //alternate balls and blocks
+      b2Body* p = c.m_pPhysicsWorld->CreateBody(&bd);
+      p->CreateFixture(bBall? (b2Shape*)&circle: (b2Shape*)&box, 1.0f);
+      pObjectManager->CreateObject(bBall? eSprite::Ball: eSprite::Block, p);
+    } //for
+  }; //fCreate
+
+  auto fClear = [&](){pObjectManager->clear();};
+  const UINT nFew = std::max(5U, std::min(iterations, 1000000/std::max(n, 1U))); //iterations for create and clear
+
+  r.Time(create.c_str(), n, nFew, fCreate, fClear);
+  r.Time(clear.c_str(), n, nFew, fClear, fCreate);
+
+  std::vector<CDrawRecord> stdRecord(n); //sprite batch records
+  if(r.IsSelected(draw.c_str()))fCreate();
+
+  r.Time(draw.c_str(), n, iterations, [&](){
+    pObjectManager->PrepareFrame(0.5f);
+
+    const CTransformCache& t = pObjectManager->GetTransforms();
+    const float* x = t.GetX(); //x coordinates
+    const float* y = t.GetY(); //y coordinates
+    const float* a = t.GetAngle(); //orientations
+
+    for(size_t i=0; i<t.GetSize(); i++) //for each object
+      stdRecord[i] = {t.GetSprite(i), x[i], y[i], a[i]};
+  });
+
+  delete c.m_pObjectManager;
+  delete c.m_pPhysicsWorld;
+} //RunObjectManager
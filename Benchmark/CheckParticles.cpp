@@ -0,0 +1,180 @@
+/// \file CheckParticles.cpp
+/// \brief Checks and timed cases for the impact particle system.
+
+#include <algorithm>
+#include <cstdio>
+#include <vector>
+
+#include "Checks.h"
+#include "ImpactParticles.h"
+#include "ComponentIncludes.h"
+
+/// \brief An impact particle stored the old way.
+///
+/// All of a particle's properties together, in an array of them, which is
+/// how particles were kept before the impact particle system kept each
+/// property in an array of its own.
+
+struct CAoSParticle{
+  float m_fX; ///< X coordinate.
+  float m_fY; ///< Y coordinate.
+  float m_fVelX; ///< X velocity.
+  float m_fVelY; ///< Y velocity.
+  float m_fLife; ///< Remaining life.
+  float m_fFade; ///< Reciprocal of life at birth.
+  float m_fGravity; ///< Downwards acceleration.
+  float m_fDrag; ///< Fraction of velocity lost per second.
+  eParticle m_eKind; ///< Kind.
+}; //CAoSParticle
+
+/// Copy the live particles of an impact particle system into an array of
+/// structures.
+/// \param p Impact particle system.
+/// \param v [out] Particles.
+
+static void CopyParticles(const CImpactParticles& p, std::vector<CAoSParticle>& v){
+  v.resize(p.GetCount());
+
+  for(UINT i=0; i<p.GetCount(); i++)
+    v[i] = {p.GetX()[i], p.GetY()[i], p.GetVelX()[i], p.GetVelY()[i], p.GetLife()[i],
+      p.GetFade()[i], p.GetGravity()[i], p.GetDrag()[i], p.GetKind()[i]};
+} //CopyParticles
+
+/// Move particles stored the old way along by one time step, one at a
+/// time, doing what CImpactParticles::Step() does, and remove the dead ones
+/// by moving the last particle into their place.
+/// \param v Particles.
+/// \param t Time step in seconds.
+
+static void StepParticles(std::vector<CAoSParticle>& v, float t){
+  for(size_t i=0; i<v.size();){ //for each particle
+    CAoSParticle& p = v[i];
+    const float k = std::max(0.0f, 1.0f - p.m_fDrag*t); //fraction of velocity kept
+
+    p.m_fVelX = p.m_fVelX*k;
+    p.m_fVelY = (p.m_fVelY - p.m_fGravity*t)*k;
+    p.m_fX += p.m_fVelX*t;
+    p.m_fY += p.m_fVelY*t;
+    p.m_fLife -= t;
+
+    if(p.m_fLife > 0.0f)i++;
+    else{ //dead, so move the last one here and do it next
+      p = v.back();
+      v.pop_back();
+    } //else
+  } //for
+} //StepParticles
+
+/// Fill an impact particle system up to its budget with particles from
+/// hard collisions at the middle of the window.
+/// \param p Impact particle system.
+
+static void FillParticles(CImpactParticles& p){
+  p.Clear();
+
+  while(p.GetCount() < p.GetCapacity())
+    p.Emit(Vector2(512.0f, 384.0f), Vector2(0.0f, 1.0f), 1000000.0f);
+} //FillParticles
+
+/// Check that the impact particle system makes no particles for a soft
+/// collision, keeps to its budget and counts what it drops, moves its
+/// particles four at a time exactly as they would be moved one at a time,
+/// lets them all die in the end, and never moves its arrays.
+/// \return true if the impact particle system did all that.
+
+static bool CheckParticles(){
+  CImpactParticles p(64); //impact particles
+  const float* pX = p.GetX(); //where the x coordinates are
+  const Vector2 pos(100.0f, 100.0f); //contact point
+  const Vector2 normal(0.0f, 1.0f); //contact normal
+
+  p.Emit(pos, normal, 0.0f);
+  const UINT nSoft = p.GetCount(); //from a soft collision
+
+  p.Emit(pos, normal, 1000000.0f);
+  const UINT nHard = p.GetCount(); //from a hard collision
+
+  for(UINT i=0; i<3; i++)
+    p.Emit(pos, normal, 1000000.0f);
+
+  std::vector<CAoSParticle> v; //the same particles the old way
+  CopyParticles(p, v);
+  p.Step(fStepTime);
+  StepParticles(v, fStepTime);
+
+  bool bSame = v.size() == p.GetCount(); //whether the old and new ways agree
+
+  for(UINT i=0; i<p.GetCount() && bSame; i++)
+    bSame = v[i].m_fX == p.GetX()[i] && v[i].m_fY == p.GetY()[i] &&
+      v[i].m_fVelX == p.GetVelX()[i] && v[i].m_fVelY == p.GetVelY()[i] &&
+      v[i].m_fLife == p.GetLife()[i];
+
+  const UINT nFull = p.GetCount(); //after filling up
+
+  for(UINT i=0; i<120; i++) //two seconds, longer than any particle lives
+    p.Step(fStepTime);
+
+  if(nSoft != 0 || nHard == 0 || nFull != 64 || p.GetDropped() != 4*nHard - 64 ||
+    !bSame || p.GetCount() != 0 || p.GetX() != pX)
+  {
+    fprintf(stderr, "Impact particles: %u, %u, %u, %u dropped, %u left, %s, %s\n",
+      nSoft, nHard, nFull, p.GetDropped(), p.GetCount(),
+      bSame? "same": "different", p.GetX() == pX? "kept": "moved");
+    return false;
+  } //if
+
+  return true;
+} //CheckParticles
+
+/// Check the impact particle system, then run a stress level, in which
+/// towers fall over, and count the particles emitted, the most live at
+/// once, and the ones dropped, checking that the particle arrays never
+/// move. Then time moving a full budget of particles one at a time the old
+/// way and four at a time. If the sprite sizes cannot be loaded, the stress
+/// level is skipped.
+/// \param r Report.
+/// \param f Level fixture to build the stress level in.
+/// \param iterations Number of iterations.
+/// \return true unless a check failed.
+
+bool RunParticles(CReport& r, CLevelFixture& f, UINT iterations){
+  if(!r.IsSelected("particles"))return true;
+  if(!CheckParticles())return false;
+
+  if(f.BuildStress(2000)){
+    CMachine& cMachine = f.GetMachine(); //the machine
+    CImpactParticles* p = f.GetContext().m_pImpactParticles; //impact particles
+    cMachine.Reset();
+    cMachine.Launch();
+
+    const float* pX = p->GetX(); //where the x coordinates are
+
+    for(UINT i=0; i<600; i++) //for each frame
+      cMachine.Step(fStepTime);
+
+    fprintf(stderr, "Stress level: %u impact particles emitted, at most %u of %u live, %u dropped\n",
+      p->GetEmitted(), p->GetPeak(), p->GetCapacity(), p->GetDropped());
+
+    if(p->GetX() != pX){
+      fprintf(stderr, "Impact particle arrays moved\n");
+      return false;
+    } //if
+  } //if
+
+  else fprintf(stderr, "Skipping particles stress level: cannot load %s\n", f.GetSettings().c_str());
+
+  CImpactParticles p; //a full budget of impact particles
+  std::vector<CAoSParticle> v; //the same the old way
+  const UINT n = p.GetCapacity(); //number of particles
+
+  const double t0 = r.Time("particles aos", n, iterations,
+    [&](){StepParticles(v, fStepTime);},
+    [&](){FillParticles(p); CopyParticles(p, v);});
+
+  const double t1 = r.Time("particles soa", n, iterations,
+    [&](){p.Step(fStepTime);},
+    [&](){FillParticles(p);});
+
+  r.PrintSpeedup("SoA particle step", t0, t1);
+  return true;
+} //RunParticles
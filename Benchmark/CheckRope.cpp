@@ -0,0 +1,137 @@
+/// \file CheckRope.cpp
+/// \brief Checks and timed cases for the pulley rope.
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <memory>
+#include <vector>
+
+#include "Checks.h"
+#include "Rope.h"
+#include "ComponentIncludes.h"
+
+/// Lay a rope over two wheels like a pulley's, from one end up over the
+/// wheels and down to the other end, and make it as long as a pulley
+/// joint's two lengths from the sides of the wheels, plus the way over
+/// the wheels' tops.
+/// \param rope Rope.
+/// \param a Left end.
+/// \param b Right end.
+/// \param c0 Left wheel center.
+/// \param c1 Right wheel center.
+/// \param r Wheel radius.
+
+static void LayRope(CRope& rope, const Vector2& a, const Vector2& b,
+  const Vector2& c0, const Vector2& c1, float r)
+{
+  const float d = r*0.70710678f; //radius over root 2
+
+  const Vector2 path[] = {
+    a, c0 + Vector2(-r, 0.0f), c0 + Vector2(-d, d), c0 + Vector2(0.0f, r),
+    c1 + Vector2(0.0f, r), c1 + Vector2(d, d), c1 + Vector2(r, 0.0f), b
+  }; //path
+
+  rope.AddCircle(c0, r);
+  rope.AddCircle(c1, r);
+  rope.Reset(path, sizeof(path)/sizeof(path[0]));
+  rope.SetLength((a - path[1]).Length() + (b - path[6]).Length() + (c1 - c0).Length() + XM_PI*r);
+} //LayRope
+
+/// Check that a rope over two wheels settles with no point inside a wheel
+/// and no segment stretched or squashed by more than a tenth, goes to
+/// sleep once it stops moving, wakes up when an end moves, and settles
+/// and goes to sleep again.
+/// \return true if the rope did all that.
+
+static bool CheckRope(){
+  const float r = 20.0f; //wheel radius
+  const Vector2 c0(300.0f, 500.0f), c1(500.0f, 500.0f); //wheel centers
+  Vector2 a(280.0f, 300.0f), b(520.0f, 310.0f); //ends
+
+  CRope rope(48); //rope
+  LayRope(rope, a, b, c0, c1, r);
+
+  UINT nSettle = 0; //steps taken to go to sleep
+
+  for(; nSettle<1000 && !rope.IsAsleep(); nSettle++)
+    rope.Step(a, b, fStepTime);
+
+  for(UINT i=0; i<60; i++){ //pull one end down and let the other up
+    a.y -= 1.0f;
+    b.y += 1.0f;
+    rope.Step(a, b, fStepTime);
+  } //for
+
+  const bool bWoke = !rope.IsAsleep(); //whether it woke up
+  UINT nResettle = 0; //steps taken to go to sleep again
+
+  for(; nResettle<1000 && !rope.IsAsleep(); nResettle++)
+    rope.Step(a, b, fStepTime);
+
+  const float* x = rope.GetX(); //x coordinates
+  const float* y = rope.GetY(); //y coordinates
+  const float fSegment = rope.GetSegmentLength(); //segment length
+  float fMin = fSegment, fMax = fSegment; //shortest and longest segments
+  UINT nInside = 0; //number of points inside a wheel
+
+  for(UINT i=0; i<rope.GetCount(); i++){ //for each point
+    const Vector2 p(x[i], y[i]); //point
+
+    if((p - c0).Length() < 0.99f*r || (p - c1).Length() < 0.99f*r)
+      nInside++;
+
+    if(i > 0){
+      const float len = (p - Vector2(x[i - 1], y[i - 1])).Length(); //segment length
+      fMin = std::min(fMin, len);
+      fMax = std::max(fMax, len);
+    } //if
+  } //for
+
+  if(nSettle >= 1000 || !bWoke || nResettle >= 1000 || nInside > 0 ||
+    fMin < 0.9f*fSegment || fMax > 1.1f*fSegment)
+  {
+    fprintf(stderr, "Rope: settled in %u steps, %s, settled again in %u, %u inside,"
+      " segments %.2f to %.2f of %.2f\n", nSettle, bWoke? "woke": "stayed asleep",
+      nResettle, nInside, fMin, fMax, fSegment);
+    return false;
+  } //if
+
+  return true;
+} //CheckRope
+
+/// Check the rope, then time stepping 100 pulley ropes whose baskets keep
+/// bobbing up and down, so that none of them ever goes to sleep.
+/// \param r Report.
+/// \param iterations Number of iterations.
+/// \return true unless the check failed.
+
+bool RunRope(CReport& r, UINT iterations){
+  if(!r.IsSelected("rope"))return true;
+  if(!CheckRope())return false;
+
+  const UINT n = 100; //number of ropes
+  const float fRad = 20.0f; //wheel radius
+  const Vector2 c0(300.0f, 500.0f), c1(500.0f, 500.0f); //wheel centers
+  const Vector2 a(280.0f, 300.0f), b(520.0f, 300.0f); //ends
+
+  std::vector<std::unique_ptr<CRope>> stdRope; //ropes
+
+  for(UINT i=0; i<n; i++){
+    stdRope.emplace_back(new CRope(48));
+    LayRope(*stdRope.back(), a, b, c0, c1, fRad);
+  } //for
+
+  UINT nStep = 0; //number of steps taken
+
+  r.Time("rope step", n, iterations, [&](){
+    const float d = 20.0f*sinf(0.1f*nStep++); //how far the baskets have bobbed
+
+    for(std::unique_ptr<CRope>& p: stdRope)
+      p->Step(a - Vector2(0.0f, d), b + Vector2(0.0f, d), fStepTime);
+  });
+
+  return true;
+} //RunRope
+
+
@@ -0,0 +1,99 @@
+/// \file CheckStress.cpp
+/// \brief Checks and timed cases for the generated stress levels.
+
+#include <algorithm>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include "Checks.h"
+#include "ObjectManager.h"
+#include "TransformCache.h"
+#include "ComponentIncludes.h"
+
+/// Check that culling finds every object whose position is in a viewport,
+/// and that it finds each object once, in drawing order.
+/// \param p Pointer to object manager, which has just culled.
+/// \param vMin Bottom left of the viewport.
+/// \param vMax Top right of the viewport.
+/// \return true if culling found what it should.
+
+static bool CheckCull(const CObjectManager* p, const Vector2& vMin, const Vector2& vMax){
+  const std::vector<UINT>& v = p->GetVisible(); //objects found
+  const CTransformCache& t = p->GetTransforms(); //transforms
+  const float* x = t.GetX(); //x coordinates
+  const float* y = t.GetY(); //y coordinates
+
+  for(size_t i=1; i<v.size(); i++) //for each object found but the first
+    if(v[i - 1] >= v[i]){
+      fprintf(stderr, "Culled objects are not in drawing order\n");
+      return false;
+    } //if
+
+  for(UINT i=0; i<(UINT)t.GetSize(); i++) //for each object
+    if(x[i] >= vMin.x && x[i] <= vMax.x && y[i] >= vMin.y && y[i] <= vMax.y &&
+      !std::binary_search(v.begin(), v.end(), i))
+    {
+      fprintf(stderr, "Culling missed an object in the viewport\n");
+      return false;
+    } //if
+
+  return true;
+} //CheckCull
+
+/// Time building a stress level with a number of bodies from scratch, and
+/// stepping it. The stress level is the same every time. Each timed step
+/// is from where it was built, with everything awake and falling, which is
+/// the most work that Physics World and the contact listener will have
+/// to do with that many bodies, so it is reset before each one, untimed.
+/// Large stress levels get fewer iterations.
+/// Then time culling to a viewport the size of the window at the bottom
+/// left of the level, after checking that it finds what it should.
+/// \param r Report.
+/// \param f Level fixture to build the stress level in.
+/// \param n Number of bodies.
+/// \param iterations Number of iterations.
+/// \return true unless the culling check failed.
+
+bool RunStress(CReport& r, CLevelFixture& f, UINT n, UINT iterations){
+  const std::string suffix = " " + std::to_string(n); //case name suffix
+  const std::string build = "stress build" + suffix; //case names
+  const std::string step = "stress step" + suffix;
+  const std::string cull = "stress cull" + suffix;
+
+  if(!r.IsSelected(build.c_str()) && !r.IsSelected(step.c_str()) &&
+    !r.IsSelected(cull.c_str()))
+    return true;
+
+  if(!f.BuildStress(n)){
+    fprintf(stderr, "Skipping %s: cannot load %s\n", build.c_str(), f.GetSettings().c_str());
+    return true;
+  } //if
+
+  CContext& c = f.GetContext(); //simulation context
+  CMachine& cMachine = f.GetMachine(); //the machine
+  cMachine.SetResetMode(eResetMode::Rebuild);
+
+  const UINT nFew = std::max(5U, std::min(iterations, 100000/std::max(n, 1U))); //iterations
+
+  r.Time(build.c_str(), n, nFew, [&](){cMachine.Reset();});
+  if(!r.IsSelected(build.c_str()))cMachine.Reset(); //build it if that wasn't timed
+  r.Time(step.c_str(), n, nFew, [&](){cMachine.Step(fStepTime);},
+    [&](){cMachine.Reset();}); //from where it was built every time
+
+  if(!r.IsSelected(cull.c_str()))
+    return true;
+
+  CObjectManager* pObjectManager = c.m_pObjectManager; //object manager
+  const Vector2 vMin(0.0f, 0.0f); //viewport
+  const Vector2 vMax(1024.0f, 768.0f);
+
+  pObjectManager->GatherTransforms();
+  pObjectManager->Cull(vMin, vMax);
+
+  if(!CheckCull(pObjectManager, vMin, vMax))
+    return false;
+
+  r.Time(cull.c_str(), n, iterations, [&](){pObjectManager->Cull(vMin, vMax);});
+  return true;
+} //RunStress
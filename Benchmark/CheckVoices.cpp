@@ -0,0 +1,114 @@
+/// \file CheckVoices.cpp
+/// \brief Checks and timed cases for the voice pool.
+
+#include <algorithm>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+#include "Checks.h"
+#include "VoicePool.h"
+#include "ComponentIncludes.h"
+
+/// Check that the voice pool merges sounds asked for near one another,
+/// plays only the loudest when there are more than it has voices for,
+/// takes over a voice only when asked for something louder than it is
+/// now, and frees voices when their sounds end.
+/// \return true if the voice pool did all that.
+
+static bool CheckVoices(){
+  CVoicePool v; //voice pool
+  v.SetVoices(eSound::Bonk, 4, 0.25f);
+
+  for(UINT i=0; i<200; i++) //a pile-up in one place
+    v.Add(eSound::Bonk, Vector2(500.0f + 0.1f*i, 300.0f), 0.5f);
+
+  const UINT nPileUp = v.Flush(0.0f); //one cluster, so one sound
+
+  for(UINT i=0; i<10; i++) //ten places far apart
+    v.Add(eSound::Bonk, Vector2(100.0f*i, 0.0f), 0.1f*(i + 1));
+
+  const UINT nSpread = v.Flush(1.0f); //4 loudest, 0.7 to 1.0
+
+  v.Add(eSound::Bonk, Vector2(0.0f, 500.0f), 0.6f);
+  const UINT nQuiet = v.Flush(1.01f); //quieter than every voice
+
+  v.Add(eSound::Bonk, Vector2(0.0f, 500.0f), 2.0f);
+  const UINT nLoud = v.Flush(1.02f); //louder, takes one over
+
+  for(UINT i=0; i<6; i++)
+    v.Add(eSound::Bonk, Vector2(100.0f*i, 500.0f), 0.01f);
+
+  const UINT nLater = v.Flush(2.0f); //all voices have ended
+
+  if(nPileUp != 1 || nSpread != 4 || nQuiet != 0 || nLoud != 1 || nLater != 4 ||
+    v.GetRequestCount() != 218 || v.GetPlayCount() != 10)
+  {
+    fprintf(stderr, "Voice pool played %u, %u, %u, %u, %u sounds, %u of %u in all\n",
+      nPileUp, nSpread, nQuiet, nLoud, nLater, v.GetPlayCount(), v.GetRequestCount());
+    return false;
+  } //if
+
+  return true;
+} //CheckVoices
+
+/// Check the voice pool, then run a stress level, in which towers fall
+/// over, flushing the voice pool every frame, and count the sounds asked
+/// for and played. No frame may play more than there are voices, which
+/// are loaded from the settings file. Then time asking for 200 sounds
+/// scattered over the window and flushing. If the voices or the sprite
+/// sizes cannot be loaded, the stress level is skipped.
+/// \param r Report.
+/// \param f Level fixture to build the stress level in.
+/// \param iterations Number of iterations.
+/// \return true unless a check failed.
+
+bool RunVoices(CReport& r, CLevelFixture& f, UINT iterations){
+  if(!r.IsSelected("voices"))return true;
+  if(!CheckVoices())return false;
+
+  CContext& c = f.GetContext(); //simulation context
+  CMachine& cMachine = f.GetMachine(); //the machine
+
+  if(f.HasVoices() && f.BuildStress(2000)){
+    cMachine.Reset();
+    cMachine.Launch();
+
+    UINT nMost = 0; //most sounds played in a frame
+
+    for(UINT i=0; i<600; i++){ //for each frame
+      cMachine.Step(fStepTime);
+      nMost = std::max(nMost, c.m_pVoicePool->Flush(c.m_fTime));
+    } //for
+
+    fprintf(stderr, "Stress level: %u collision sounds asked for, %u played, at most %u a frame\n",
+      c.m_pVoicePool->GetRequestCount(), c.m_pVoicePool->GetPlayCount(), nMost);
+
+    if(nMost > c.m_pVoicePool->GetVoiceCount(eSound::Bonk)){
+      fprintf(stderr, "Voice pool played more sounds than it has voices\n");
+      return false;
+    } //if
+  } //if
+
+  else fprintf(stderr, "Skipping voices stress level: cannot load %s\n", f.GetSettings().c_str());
+
+  std::mt19937 stdRandom(1); //random number generator
+  std::uniform_real_distribution<float> x(0.0f, 1024.0f), y(0.0f, 768.0f), v(0.0f, 1.0f);
+  std::vector<CSoundEvent> burst(200); //sounds asked for in one frame
+
+  for(CSoundEvent& e: burst){
+    e.m_vPos = Vector2(x(stdRandom), y(stdRandom));
+    e.m_fVolume = v(stdRandom);
+  } //for
+
+  float t = 0; //time
+
+  r.Time("voices 200", burst.size(), iterations, [&](){
+    for(const CSoundEvent& e: burst)
+      c.m_pVoicePool->Add(eSound::Bonk, e.m_vPos, e.m_fVolume);
+
+    c.m_pVoicePool->Flush(t += fStepTime);
+  });
+
+  return true;
+} //RunVoices
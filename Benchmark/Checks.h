@@ -0,0 +1,44 @@
+/// \file Checks.h
+/// \brief Interface for the benchmark checks.
+///
+/// Each subsystem's checks and timed cases are in a file of their own, and
+/// each has a function that runs them and is called by main(). Every one
+/// of them does nothing unless some of its cases pass the report's filter.
+
+#ifndef __L4RC_BENCHMARK_CHECKS_H__
+#define __L4RC_BENCHMARK_CHECKS_H__
+
+#include <string>
+
+#include "Common.h"
+#include "Fixture.h"
+#include "Report.h"
+
+/// \brief A sprite batch record.
+///
+/// What the draw pass hands to the sprite batch for each object.
+
+struct CDrawRecord{
+  eSprite m_eSprite = eSprite::Size; ///< Sprite type.
+  float m_fX = 0; ///< X coordinate in renderer units.
+  float m_fY = 0; ///< Y coordinate in renderer units.
+  float m_fAngle = 0; ///< Orientation.
+}; //CDrawRecord
+
+bool RunDraw(CReport& r, UINT objects, UINT iterations); ///< Draw pass, in CheckDraw.cpp.
+void RunPreSolve(CReport& r, UINT objects, const std::string& settings,
+  UINT iterations); ///< Contact listener, in CheckContacts.cpp.
+bool RunContactQueue(CReport& r, UINT iterations); ///< Contact queue, in CheckContacts.cpp.
+bool RunLevel(CReport& r, CLevelFixture& f, const std::string& level,
+  UINT iterations); ///< Level file, in CheckLevel.cpp.
+bool RunOptimizer(CReport& r, const std::string& settings,
+  const std::string& level); ///< Optimizer, in CheckLevel.cpp.
+void RunObjectManager(CReport& r, UINT n, UINT iterations); ///< Object manager, in CheckObjectManager.cpp.
+bool RunStress(CReport& r, CLevelFixture& f, UINT n, UINT iterations); ///< Stress levels, in CheckStress.cpp.
+bool RunVoices(CReport& r, CLevelFixture& f, UINT iterations); ///< Voice pool, in CheckVoices.cpp.
+bool RunParticles(CReport& r, CLevelFixture& f, UINT iterations); ///< Impact particles, in CheckParticles.cpp.
+bool RunRope(CReport& r, UINT iterations); ///< Pulley rope, in CheckRope.cpp.
+bool RunAtlas(CReport& r, const std::string& settings, const std::string& fatlas,
+  UINT iterations); ///< Sprite atlas, in CheckAtlas.cpp.
+
+#endif //__L4RC_BENCHMARK_CHECKS_H__
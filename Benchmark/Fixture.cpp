@@ -0,0 +1,85 @@
+/// \file Fixture.cpp
+/// \brief Code for the level fixture CLevelFixture.
+
+#include "Fixture.h"
+#include "ImpactParticles.h"
+#include "SpriteSizes.h"
+#include "VoicePool.h"
+
+/// Initialize the machine with the fixture's own context, then load the
+/// sprite sizes from the image files and the voices. If either cannot be
+/// loaded, that is remembered for the checks to find out.
+/// \param settings Path to `gamesettings.xml`.
+
+CLevelFixture::CLevelFixture(const std::string& settings):
+  m_cMachine(m_cContext),
+  m_strSettings(settings)
+{
+  m_cMachine.Initialize();
+  m_bSizes = m_cContext.m_pSpriteSizes->Load(settings);
+  m_bVoices = m_cContext.m_pVoicePool->Load(settings);
+} //constructor
+
+/// Forget the sounds asked for and the particles emitted by whatever level
+/// was run before, so that each check counts only its own.
+
+void CLevelFixture::Clear(){
+  m_cContext.m_pVoicePool->Clear();
+  m_cContext.m_pImpactParticles->Clear();
+} //Clear
+
+/// Build the level from a level file, to be reset from a snapshot.
+/// \param level Path to binary level file.
+/// \return true if the sprite sizes and the level were loaded.
+
+bool CLevelFixture::BuildLevel(const std::string& level){
+  if(!m_bSizes || !m_cMachine.LoadLevel(level))
+    return false;
+
+  m_cMachine.SetResetMode(eResetMode::Restore);
+  Clear();
+  return true;
+} //BuildLevel
+
+/// Build a stress level, to be reset from a snapshot. The stress level is
+/// the same every time for the same number of bodies.
+/// \param n Number of bodies.
+/// \return true if the sprite sizes were loaded.
+
+bool CLevelFixture::BuildStress(UINT n){
+  if(!m_bSizes)
+    return false;
+
+  m_cMachine.GenerateLevel(n, 1);
+  m_cMachine.SetResetMode(eResetMode::Restore);
+  Clear();
+  return true;
+} //BuildStress
+
+/// Reader function for the path to the settings file.
+/// \return Path to `gamesettings.xml`.
+
+const std::string& CLevelFixture::GetSettings() const{
+  return m_strSettings;
+} //GetSettings
+
+/// Reader function for whether the voices were loaded.
+/// \return true if the voices were loaded from the settings file.
+
+bool CLevelFixture::HasVoices() const{
+  return m_bVoices;
+} //HasVoices
+
+/// Reader function for the simulation context.
+/// \return Reference to the simulation context.
+
+CContext& CLevelFixture::GetContext(){
+  return m_cContext;
+} //GetContext
+
+/// Reader function for the machine.
+/// \return Reference to the machine.
+
+CMachine& CLevelFixture::GetMachine(){
+  return m_cMachine;
+} //GetMachine
@@ -0,0 +1,42 @@
+/// \file Fixture.h
+/// \brief Interface for the level fixture CLevelFixture.
+
+#ifndef __L4RC_BENCHMARK_FIXTURE_H__
+#define __L4RC_BENCHMARK_FIXTURE_H__
+
+#include <string>
+
+#include "Common.h"
+#include "Machine.h"
+
+/// \brief The level fixture.
+///
+/// The level fixture is a machine and the simulation context that it owns,
+/// with the sprite sizes and voices loaded once from the settings file. It
+/// is made once and shared by all of the checks that run a level, each of
+/// which builds the level that it needs in it.
+
+class CLevelFixture{
+  private:
+    CContext m_cContext; ///< Simulation context, which must be constructed first.
+    CMachine m_cMachine; ///< The Rube Goldberg machine.
+
+    std::string m_strSettings; ///< Path to `gamesettings.xml`.
+    bool m_bSizes = false; ///< Whether the sprite sizes were loaded.
+    bool m_bVoices = false; ///< Whether the voices were loaded.
+
+    void Clear(); ///< Forget the sounds and particles of the last level.
+
+  public:
+    CLevelFixture(const std::string& settings); ///< Constructor.
+
+    bool BuildLevel(const std::string& level); ///< Build the level from a file.
+    bool BuildStress(UINT n); ///< Build a stress level.
+
+    const std::string& GetSettings() const; ///< Get path to settings file.
+    bool HasVoices() const; ///< Whether the voices were loaded.
+    CContext& GetContext(); ///< Get simulation context.
+    CMachine& GetMachine(); ///< Get machine.
+}; //CLevelFixture
+
+#endif //__L4RC_BENCHMARK_FIXTURE_H__
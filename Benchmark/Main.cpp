@@ -0,0 +1,136 @@
+/// \file Main.cpp 
+/// \brief Command-line benchmark suite for the simulation.
+///
+/// Times the hot paths of the simulation and prints one row for each case.
+/// The cases are:
+///
+/// - Reading the object transforms for the draw pass, both the old way, in
+///   which each separately allocated object chases a pointer to its body
+///   and converts its own position to renderer units, and from the
+///   transform cache, which gathers all of the transforms into contiguous
+///   arrays and converts them in one pass.
+/// - Building the outlines of the bodies for the Lines draw mode, both the
+///   old way, one polygon side at a time with a rotation computed for each
+///   vertex, and with the outline builder's batch.
+/// - Both of those again with nine objects in ten asleep, with the
+///   transform cache reading only the bodies that are awake and the
+///   outline builder keeping its batch from one iteration to the next.
+/// - Drawing the outlines, circles included, one body at a time and in a
+///   batch, into a recording renderer that does what the game's renderer
+///   does but keeps the lines and sprites instead of drawing them, and
+///   drawing a kept batch of them with and without culling to a quarter of
+///   the window.
+/// - A full step of the machine built from the level file, after checking
+///   that a run launches the bird and finishes, both as built and after a
+///   reset.
+/// - No timing for the optimizer, just a check that a short search finds
+///   the same best candidate on one thread as on several.
+/// - The contact listener's PreSolve() on a synthetic set of contacts
+///   between every kind of object, followed by the responses to them.
+/// - Object manager creating, clearing, and getting ready to draw 100,
+///   10000, and 100000 objects.
+/// - Building and stepping generated stress levels of 1000, 10000, and
+///   100000 bodies, and culling them to a window-sized viewport.
+/// - Merging a full contact queue the old way and by sorting, after
+///   checking that both merge the same and that game logic is never dropped.
+/// - The voice pool taking 200 collision sounds in a frame, after checking
+///   what it plays, and counting what it plays as a stress level falls.
+/// - Moving a full budget of impact particles, one at a time as an array
+///   of structures and four at a time as a structure of arrays, after
+///   checking that both give the same results, and counting particles as
+///   a stress level falls.
+/// - Stepping 100 pulley ropes that never go to sleep, after checking that
+///   a rope settles over its wheels, sleeps, and wakes up again.
+/// - Loading the sprite images one file each and from the atlas pages,
+///   and loading the sprite sizes from the image files and from the atlas
+///   manifest, after checking that the atlas matches the images.
+///
+/// The results of the old and new ways are checked against each other
+/// before anything is timed. Usage:
+///
+///     Benchmark [-objects n] [-iterations n] [-filter text] [-json]
+///       [-settings file] [-level file] [-atlas file]
+///
+/// The number of objects defaults to 10000 and the number of iterations
+/// to 200. Fewer iterations are used to create and clear the larger
+/// numbers of objects, and for the larger stress levels. If `-filter` is
+/// given, only the cases whose names contain the text are run. The results are printed as comma-separated
+/// values, or as JSON if `-json` is given, so that they can be compared
+/// from one release to the next. The speedups of the new ways over the old
+/// are printed to stderr. The settings, level, and atlas files default to
+/// where they are when run from the folder that the game is run from, and
+/// if they cannot be loaded the cases that need them are skipped.
+///
+/// This file only reads the command line and runs the cases. The checks
+/// and timed cases for each subsystem are in a file of their own, such as
+/// `CheckDraw.cpp` or `CheckStress.cpp`, and the cases that run a level
+/// all build it in one level fixture, which loads the settings once.
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+
+#include "Checks.h"
+
+/// Read the command line arguments, then run the benchmark.
+/// \param argc Number of command line arguments.
+/// \param argv Command line arguments.
+/// \return 0 if the benchmark ran and its checks passed, otherwise 1.
+
+int main(int argc, char* argv[]){
+  UINT objects = 10000; //number of objects
+  UINT iterations = 200; //number of iterations
+  std::string filter; //text that case names must contain
+  bool bJSON = false; //whether to print JSON
+  std::string settings = "Media/XML/gamesettings.xml"; //settings file
+  std::string level = "Media/Levels/machine.lvl"; //level file
+  std::string atlas = "Media/Images/atlas.atl"; //atlas manifest
+
+  for(int i=1; i<argc; i++){ //for each argument
+    const bool bHasValue = i + 1 < argc;
+
+    if(bHasValue && !strcmp(argv[i], "-objects"))objects = (UINT)atoi(argv[++i]);
+    else if(bHasValue && !strcmp(argv[i], "-iterations"))iterations = (UINT)atoi(argv[++i]);
+    else if(bHasValue && !strcmp(argv[i], "-filter"))filter = argv[++i];
+    else if(!strcmp(argv[i], "-json"))bJSON = true;
+    else if(bHasValue && !strcmp(argv[i], "-settings"))settings = argv[++i];
+    else if(bHasValue && !strcmp(argv[i], "-level"))level = argv[++i];
+    else if(bHasValue && !strcmp(argv[i], "-atlas"))atlas = argv[++i];
+
+    else{
+      fprintf(stderr, "Usage: %s [-objects n] [-iterations n] [-filter text] [-json]"
+        " [-settings file] [-level file] [-atlas file]\n", argv[0]);
+      return 1;
+    } //else
+  } //for
+
+  if(iterations == 0)
+    iterations = 1;
+
+  CReport cReport(filter); //the report
+  bool bOK = true; //whether the checks passed
+
+  CLevelFixture cFixture(settings); //shared by the cases that run a level
+
+  bOK = RunDraw(cReport, objects, iterations) && bOK;
+  RunPreSolve(cReport, objects, settings, iterations);
+
+  bOK = RunLevel(cReport, cFixture, level, iterations) && bOK;
+  bOK = RunOptimizer(cReport, settings, level) && bOK;
+
+  for(UINT n: {100U, 10000U, 100000U}) //for each number of objects
+    RunObjectManager(cReport, n, iterations);
+
+  for(UINT n: {1000U, 10000U, 100000U}) //for each number of bodies
+    bOK = RunStress(cReport, cFixture, n, iterations) && bOK;
+
+  bOK = RunContactQueue(cReport, iterations) && bOK;
+  bOK = RunVoices(cReport, cFixture, iterations) && bOK;
+  bOK = RunParticles(cReport, cFixture, iterations) && bOK;
+  bOK = RunRope(cReport, iterations) && bOK;
+  bOK = RunAtlas(cReport, settings, atlas, iterations) && bOK;
+
+  cReport.Print(bJSON);
+  return bOK? 0: 1;
+} //main
@@ -0,0 +1,58 @@
+/// \file Report.cpp
+/// \brief Code for the benchmark report CReport.
+
+#include <cstdio>
+#include <cstring>
+
+#include "Report.h"
+
+/// \param filter Text that case names must contain, empty for all cases.
+
+CReport::CReport(const std::string& filter):
+  m_strFilter(filter){
+} //constructor
+
+/// Whether a case is to be run.
+/// \param name Name of case.
+/// \return true if the name contains the filter text.
+
+bool CReport::IsSelected(const char* name) const{
+  return strstr(name, m_strFilter.c_str()) != nullptr;
+} //IsSelected
+
+/// Print how many times faster a new way is than an old way to stderr,
+/// so that it doesn't get mixed up with the results. Nothing is printed
+/// unless both cases were run.
+/// \param label What is faster.
+/// \param fOld Mean time the old way.
+/// \param fNew Mean time the new way.
+
+void CReport::PrintSpeedup(const char* label, double fOld, double fNew) const{
+  if(fOld > 0 && fNew > 0)
+    fprintf(stderr, "%s speedup: %.2f\n", label, fOld/fNew);
+} //PrintSpeedup
+
+/// Print the results to stdout, one per case, as comma-separated values
+/// or as a JSON array of objects.
+/// \param bJSON true for JSON, false for comma-separated values.
+
+void CReport::Print(bool bJSON) const{
+  if(bJSON)printf("[\n");
+  else printf("case,objects,iterations,mean time (us),min time (us),mean time per object (ns)\n");
+
+  for(size_t i=0; i<m_stdResult.size(); i++){ //for each result
+    const CResult& r = m_stdResult[i];
+    const double fPerObject = r.m_nObjects > 0? 1000.0*r.m_fMean/r.m_nObjects: 0.0; //in nanoseconds
+
+    if(bJSON)
+      printf("  {\"case\": \"%s\", \"objects\": %u, \"iterations\": %u, \"mean_us\": %.3f,"
+        " \"min_us\": %.3f, \"per_object_ns\": %.3f}%s\n", r.m_strName.c_str(),
+        (UINT)r.m_nObjects, r.m_nIterations, r.m_fMean, r.m_fMin, fPerObject,
+        i + 1 < m_stdResult.size()? ",": "");
+
+    else printf("%s,%u,%u,%.3f,%.3f,%.3f\n", r.m_strName.c_str(), (UINT)r.m_nObjects,
+      r.m_nIterations, r.m_fMean, r.m_fMin, fPerObject);
+  } //for
+
+  if(bJSON)printf("]\n");
+} //Print
@@ -0,0 +1,106 @@
+/// \file Report.h
+/// \brief Interface for the benchmark report CReport.
+
+#ifndef __L4RC_BENCHMARK_REPORT_H__
+#define __L4RC_BENCHMARK_REPORT_H__
+
+#include <algorithm>
+#include <chrono>
+#include <string>
+#include <vector>
+
+#include "Common.h"
+
+/// \brief A benchmark result.
+
+struct CResult{
+  std::string m_strName; ///< Name of case.
+  size_t m_nObjects = 0; ///< Number of objects.
+  UINT m_nIterations = 0; ///< Number of iterations.
+  double m_fMean = 0; ///< Mean time in microseconds.
+  double m_fMin = 0; ///< Fastest time in microseconds.
+}; //CResult
+
+/// \brief The benchmark report.
+///
+/// The report times the cases that pass its filter and keeps the results,
+/// which are printed all together at the end.
+
+class CReport{
+  private:
+    std::string m_strFilter; ///< Text that case names must contain.
+    std::vector<CResult> m_stdResult; ///< Results.
+
+  public:
+    CReport(const std::string& filter); ///< Constructor.
+
+    bool IsSelected(const char* name) const; ///< Whether a case passes the filter.
+
+    template<class F, class S> double Time(const char* name, size_t n,
+      UINT iterations, F f, S setup); ///< Time a case.
+    template<class F> double Time(const char* name, size_t n,
+      UINT iterations, F f); ///< Time a case that needs no setup.
+
+    void PrintSpeedup(const char* label, double fOld, double fNew) const; ///< Print a speedup.
+    void Print(bool bJSON) const; ///< Print results.
+}; //CReport
+
+/// Call a function a number of times, timing each call, and keep the mean
+/// and fastest times. A setup function is called before each call, but is
+/// not timed. Nothing is done if the case does not pass the filter.
+/// \param name Name of case.
+/// \param n Number of objects.
+/// \param iterations Number of times to call the function.
+/// \param f Function to call.
+/// \param setup Function to call before each call to f.
+/// \return Mean time in microseconds, or zero if the case was not run.
+
+template<class F, class S> double CReport::Time(const char* name, size_t n,
+  UINT iterations, F f, S setup)
+{
+  using clock = std::chrono::high_resolution_clock;
+  if(!IsSelected(name))return 0;
+
+  setup();
+  f(); //warm up
+
+  double fTotal = 0; //total time in microseconds
+  double fMin = 0; //fastest time in microseconds
+
+  for(UINT i=0; i<iterations; i++){ //for each iteration
+    setup();
+
+    const clock::time_point start = clock::now();
+    f();
+    const double t = std::chrono::duration<double, std::micro>(clock::now() - start).count();
+
+    fTotal += t;
+    fMin = i == 0? t: std::min(fMin, t);
+  } //for
+
+  CResult r; //result
+  r.m_strName = name;
+  r.m_nObjects = n;
+  r.m_nIterations = iterations;
+  r.m_fMean = fTotal/iterations;
+  r.m_fMin = fMin;
+  m_stdResult.push_back(r);
+
+  return r.m_fMean;
+} //Time
+
+/// Call a function a number of times, timing each call, and keep the mean
+/// and fastest times.
+/// \param name Name of case.
+/// \param n Number of objects.
+/// \param iterations Number of times to call the function.
+/// \param f Function to call.
+/// \return Mean time in microseconds, or zero if the case was not run.
+
+template<class F> double CReport::Time(const char* name, size_t n,
+  UINT iterations, F f)
+{
+  return Time(name, n, iterations, f, [](){});
+} //Time
+
+#endif //__L4RC_BENCHMARK_REPORT_H__
@@ -0,0 +1,246 @@
+/// \file Main.cpp 
+/// \brief Command-line driver for the headless simulation.
+///
+/// Runs the Rube Goldberg machine with no window and no renderer, stepping
+/// the Physics World at a fixed rate, and reports how long the machine took
+/// to finish in simulated time and how many frames per second it was
+/// simulated at in real time. Usage:
+///
+///     Headless [-settings file] [-level file] [-hulls file] [-dt seconds]
+///       [-timeout seconds] [-runs n] [-rebuild] [-record file] [-profile name]
+///       [-stress bodies] [-seed n]
+///
+/// The settings file defaults to `Media/XML/gamesettings.xml` and the
+/// level file to `Media/Levels/machine.lvl`, which is where they are
+/// when run from the folder that the game is run from. The hand-made
+/// collision shapes are used unless `-hulls` gives a hull file, such as
+/// `Media/Levels/sprites.hul`, that can be loaded. Between runs the
+/// machine is reset by restoring a snapshot of the Physics World, unless
+/// `-rebuild` is given, in which case the level is built again from scratch.
+/// If `-record` is given, a replay of the first run is saved to the file.
+/// If `-profile` is given, each phase of every step is timed, and the
+/// times are saved to the name with `.csv` added as comma-separated values
+/// and with `.json` added as a Chrome trace.
+/// If `-stress` is given, a stress level with that many bodies is generated
+/// in place of the level file, using the random number seed given by
+/// `-seed`, which defaults to 1. The numbers of bodies and joints in the
+/// level are printed to stderr. A stress level has no pig, so each run
+/// goes on until it times out. After the first run, the number of
+/// collision sounds asked for and the number that the voice pool played,
+/// with as many voices as there are instances of each sound in the
+/// settings file, are printed to stderr too, and so are the number of impact particles
+/// emitted, the most that were live at once, and how many were dropped
+/// because the particle budget was used up.
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+
+#include "Machine.h"
+#include "Profiler.h"
+#include "SpriteSizes.h"
+#include "VoicePool.h"
+#include "ImpactParticles.h"
+#include "ComponentIncludes.h"
+
+/// \brief The headless driver.
+///
+/// The headless driver does the job of CGame without a window: it runs
+/// the machine frame by frame, but has no keyboard, renderer, or audio.
+
+class CHeadless:
+  public LComponent,
+  public CCommon{
+
+  private:
+    CMachine m_cMachine; ///< The Rube Goldberg machine.
+    float m_fFrameTime = fStepTime; ///< Frame time in seconds.
+
+  public:
+    CHeadless(CContext& c); ///< Constructor.
+
+    bool Initialize(const std::string& settings, const std::string& level,
+      const std::string& hulls, UINT stress, UINT seed, float dt,
+      eResetMode mode); ///< Initialize.
+    bool Run(float timeout, UINT runs, const std::string& record); ///< Run the machine.
+}; //CHeadless
+
+/// \param c Simulation context.
+
+CHeadless::CHeadless(CContext& c):
+  CCommon(c),
+  m_cMachine(c){
+} //constructor
+
+/// Initialize the machine, load the sprite sizes from the image files,
+/// since there is no renderer to get them from, load the hull file if
+/// there is one, and load the level file or generate a stress level.
+/// \param settings Path to `gamesettings.xml`.
+/// \param level Path to binary level file.
+/// \param hulls Path to hull file, empty for none.
+/// \param stress Number of bodies in the stress level, zero for none.
+/// \param seed Random number seed for the stress level.
+/// \param dt Frame time in seconds.
+/// \param mode Reset mode.
+/// \return true if all of the sprite sizes were found and the level loaded.
+
+bool CHeadless::Initialize(const std::string& settings, const std::string& level,
+  const std::string& hulls, UINT stress, UINT seed, float dt, eResetMode mode)
+{
+  m_fFrameTime = dt;
+  m_cMachine.Initialize();
+  m_cMachine.SetResetMode(mode);
+
+  if(!m_pSpriteSizes->Load(settings)){
+    fprintf(stderr, "Cannot read sprite sizes using %s\n", settings.c_str());
+    return false;
+  } //if
+
+  if(!m_pVoicePool->Load(settings))
+    fprintf(stderr, "Cannot read all of the sounds using %s\n", settings.c_str());
+
+  if(!hulls.empty() && !m_cMachine.LoadHulls(hulls))
+    fprintf(stderr, "Cannot load hull file %s, using hand-made shapes\n", hulls.c_str());
+
+  if(stress > 0)
+    m_cMachine.GenerateLevel(stress, seed);
+
+  else if(!m_cMachine.LoadLevel(level)){
+    fprintf(stderr, "Cannot load level file %s\n", level.c_str());
+    return false;
+  } //if
+
+  return true;
+} //Initialize
+
+/// Run the machine from reset until it finishes or times out, a number of
+/// times, and print the real time taken to reset, the simulated completion
+/// time, and the real frame rate of each run, then the average frame rate
+/// over all runs. The machine is stepped directly by the frame time, and
+/// the timeout is measured in the simulated time kept in its context.
+/// \param timeout Longest simulated time to wait for the machine to finish.
+/// \param runs Number of runs.
+/// \param record Replay file name for the first run, empty for none.
+/// \return true if the machine finished on every run.
+
+bool CHeadless::Run(float timeout, UINT runs, const std::string& record){
+  using clock = std::chrono::high_resolution_clock;
+
+  bool bAllFinished = true; //whether every run finished
+  UINT nTotalFrames = 0; //frames over all runs
+  double fTotalSecs = 0; //real time over all runs in seconds
+
+  m_cMachine.SetRecording(!record.empty());
+  printf("run,reset time (us),finished,completion time (s),frames,real time (ms),frames per second\n");
+
+  for(UINT i=0; i<runs; i++){ //for each run
+    const clock::time_point reset = clock::now();
+    m_cMachine.Reset();
+    const double resetsecs = std::chrono::duration<double>(clock::now() - reset).count();
+
+    if(i == 0)
+      fprintf(stderr, "%d bodies, %d joints\n", m_pPhysicsWorld->GetBodyCount(),
+        m_pPhysicsWorld->GetJointCount());
+
+    m_cMachine.Launch();
+
+    const float fTimeout = m_fTime + timeout; //time to give up
+    UINT nFrames = 0; //frames in this run
+
+    const clock::time_point start = clock::now();
+
+    while(m_eGameState != eGameState::Finished && m_fTime < fTimeout){
+      m_cMachine.Step(m_fFrameTime); //move all objects 
+      m_pVoicePool->Flush(m_fTime); //play the loudest collision sounds
+      nFrames++;
+    } //while
+
+    const double secs = std::chrono::duration<double>(clock::now() - start).count();
+    const bool bFinished = m_eGameState == eGameState::Finished;
+
+    if(i == 0)
+      fprintf(stderr, "%u collision sounds asked for, %u played\n",
+        m_pVoicePool->GetRequestCount(), m_pVoicePool->GetPlayCount());
+
+    if(i == 0)
+      fprintf(stderr, "%u impact particles emitted, at most %u of %u live, %u dropped\n",
+        m_pImpactParticles->GetEmitted(), m_pImpactParticles->GetPeak(),
+        m_pImpactParticles->GetCapacity(), m_pImpactParticles->GetDropped());
+
+    if(i == 0 && !record.empty()){ //save replay of first run
+      m_cMachine.SetRecording(false);
+
+      if(!m_cMachine.GetReplay().Save(record))
+        fprintf(stderr, "Cannot write replay file %s\n", record.c_str());
+    } //if
+
+    printf("%u,%.1f,%s,%.3f,%u,%.3f,%.1f\n", i, 1000000.0*resetsecs, bFinished? "yes": "no",
+      bFinished? m_fTotalTime: timeout, nFrames, 1000.0*secs, nFrames/secs);
+
+    bAllFinished = bAllFinished && bFinished;
+    nTotalFrames += nFrames;
+    fTotalSecs += secs;
+  } //for
+
+  printf("average frames per second: %.1f\n", nTotalFrames/fTotalSecs);
+  return bAllFinished;
+} //Run
+
+/// Read the command line arguments, then initialize and run the machine.
+/// \param argc Number of command line arguments.
+/// \param argv Command line arguments.
+/// \return 0 if the machine finished on every run, otherwise 1.
+
+int main(int argc, char* argv[]){
+  std::string settings = "Media/XML/gamesettings.xml"; //settings file
+  std::string level = "Media/Levels/machine.lvl"; //level file
+  std::string hulls; //hull file, none by default
+  float dt = fStepTime; //frame time
+  float timeout = 120.0f; //timeout in seconds of simulated time
+  UINT runs = 1; //number of runs
+  eResetMode mode = eResetMode::Restore; //how to reset between runs
+  std::string record; //replay file, if any
+  std::string profile; //profile file name without extension, if any
+  UINT stress = 0; //number of bodies in stress level, if any
+  UINT seed = 1; //random number seed for stress level
+
+  for(int i=1; i<argc; i++){ //for each argument
+    const bool bHasValue = i + 1 < argc;
+
+    if(bHasValue && !strcmp(argv[i], "-settings"))settings = argv[++i];
+    else if(bHasValue && !strcmp(argv[i], "-level"))level = argv[++i];
+    else if(bHasValue && !strcmp(argv[i], "-hulls"))hulls = argv[++i];
+    else if(bHasValue && !strcmp(argv[i], "-dt"))dt = (float)atof(argv[++i]);
+    else if(bHasValue && !strcmp(argv[i], "-timeout"))timeout = (float)atof(argv[++i]);
+    else if(bHasValue && !strcmp(argv[i], "-runs"))runs = (UINT)atoi(argv[++i]);
+    else if(!strcmp(argv[i], "-rebuild"))mode = eResetMode::Rebuild;
+    else if(bHasValue && !strcmp(argv[i], "-record"))record = argv[++i];
+    else if(bHasValue && !strcmp(argv[i], "-profile"))profile = argv[++i];
+    else if(bHasValue && !strcmp(argv[i], "-stress"))stress = (UINT)atoi(argv[++i]);
+    else if(bHasValue && !strcmp(argv[i], "-seed"))seed = (UINT)atoi(argv[++i]);
+
+    else{
+      fprintf(stderr, "Usage: %s [-settings file] [-level file] [-hulls file] [-dt seconds]"
+        " [-timeout seconds] [-runs n] [-rebuild] [-record file] [-profile name]"
+        " [-stress bodies] [-seed n]\n", argv[0]);
+      return 1;
+    } //else
+  } //for
+
+  CContext cContext; //the simulation context
+  CHeadless cHeadless(cContext); //the driver
+
+  if(!cHeadless.Initialize(settings, level, hulls, stress, seed, dt, mode))
+    return 1;
+
+  CProfiler::SetEnabled(!profile.empty());
+  const bool bFinished = cHeadless.Run(timeout, runs, record); //whether every run finished
+
+  if(!profile.empty() &&
+    (!CProfiler::SaveCSV(profile + ".csv") || !CProfiler::SaveTrace(profile + ".json")))
+    fprintf(stderr, "Cannot write profile %s\n", profile.c_str());
+
+  return bFinished? 0: 1;
+} //main
@@ -0,0 +1,148 @@
+/// \file AtlasFile.cpp
+/// \brief Code for the atlas manifest class CAtlasFile.
+
+#include <cstring>
+#include <fstream>
+
+#include "AtlasFile.h"
+
+/// Map an atlas manifest into memory and check that its header, size,
+/// pages, and records are sensible, then index the records by sprite type.
+/// Every rectangle must be inside its page, and no sprite may have more
+/// than one record. Any manifest that was already loaded is unloaded first.
+/// \param fname Manifest file name.
+/// \return true if the manifest was loaded.
+
+bool CAtlasFile::Load(const std::string& fname){
+  Unload();
+
+  if(!m_cFile.Open(fname))return false;
+
+  const size_t size = m_cFile.GetSize();
+  if(size < sizeof(CAtlasHeader))return false;
+
+  const CAtlasHeader* pHeader = (const CAtlasHeader*)m_cFile.GetData();
+
+  if(memcmp(pHeader->m_pMagic, "RGMA", 4) != 0 || pHeader->m_nVersion != VERSION ||
+    size != sizeof(CAtlasHeader) + pHeader->m_nPages*sizeof(CAtlasPage) +
+      pHeader->m_nCount*sizeof(CAtlasRecord))
+  {
+    m_cFile.Close();
+    return false;
+  } //if
+
+  m_pPage = (const CAtlasPage*)(pHeader + 1);
+  m_nPages = pHeader->m_nPages;
+  m_nCount = pHeader->m_nCount;
+
+  for(UINT i=0; i<m_nPages; i++){ //check pages
+    const CAtlasPage& p = m_pPage[i];
+
+    if(memchr(p.m_szFile, 0, sizeof(p.m_szFile)) == nullptr ||
+      p.m_nWidth == 0 || p.m_nHeight == 0)
+    {
+      Unload();
+      return false;
+    } //if
+  } //for
+
+  const CAtlasRecord* pRecord = (const CAtlasRecord*)(m_pPage + m_nPages);
+
+  for(UINT i=0; i<m_nCount; i++){ //check records and index them
+    const CAtlasRecord& r = pRecord[i];
+
+    if(r.m_nSprite >= (UINT)eSprite::Size || m_pSprite[r.m_nSprite] != nullptr ||
+      r.m_nPage >= m_nPages)
+    {
+      Unload();
+      return false;
+    } //if
+
+    const CAtlasPage& p = m_pPage[r.m_nPage]; //its page
+
+    if(r.m_nWidth > p.m_nWidth || r.m_nLeft > p.m_nWidth - r.m_nWidth ||
+      r.m_nHeight > p.m_nHeight || r.m_nTop > p.m_nHeight - r.m_nHeight)
+    {
+      Unload();
+      return false;
+    } //if
+
+    m_pSprite[r.m_nSprite] = &r;
+  } //for
+
+  const size_t slash = fname.find_last_of("/\\"); //end of folder name
+  m_strFolder = slash == std::string::npos? "": fname.substr(0, slash + 1);
+
+  return true;
+} //Load
+
+/// Unmap the manifest.
+
+void CAtlasFile::Unload(){
+  m_cFile.Close();
+  m_strFolder.clear();
+  m_pPage = nullptr;
+  m_nPages = m_nCount = 0;
+
+  for(UINT i=0; i<(UINT)eSprite::Size; i++)
+    m_pSprite[i] = nullptr;
+} //Unload
+
+/// Reader function for the number of pages.
+/// \return Number of pages, which is zero if no manifest is loaded.
+
+UINT CAtlasFile::GetPageCount() const{
+  return m_nPages;
+} //GetPageCount
+
+/// Reader function for a page.
+/// \param i Page index, which must be less than GetPageCount().
+/// \return Reference to the page record.
+
+const CAtlasPage& CAtlasFile::GetPage(UINT i) const{
+  return m_pPage[i];
+} //GetPage
+
+/// Get the path of the image file of a page, which is in the same folder
+/// as the manifest.
+/// \param i Page index, which must be less than GetPageCount().
+/// \return Path of the page image.
+
+std::string CAtlasFile::GetPageFileName(UINT i) const{
+  return m_strFolder + m_pPage[i].m_szFile;
+} //GetPageFileName
+
+/// Reader function for the number of sprite records.
+/// \return Number of sprite records, which is zero if no manifest is loaded.
+
+UINT CAtlasFile::GetCount() const{
+  return m_nCount;
+} //GetCount
+
+/// Reader function for the record of a sprite.
+/// \param t Sprite type.
+/// \return Pointer to the sprite record, nullptr if the sprite is not in the atlas.
+
+const CAtlasRecord* CAtlasFile::Get(eSprite t) const{
+  return m_pSprite[(UINT)t];
+} //Get
+
+/// Save an atlas manifest.
+/// \param fname Manifest file name.
+/// \param pages Page records.
+/// \param records Sprite records.
+/// \return true if the file was written.
+
+bool CAtlasFile::Save(const std::string& fname, const std::vector<CAtlasPage>& pages,
+  const std::vector<CAtlasRecord>& records)
+{
+  const CAtlasHeader header =
+    {{'R', 'G', 'M', 'A'}, VERSION, (UINT)pages.size(), (UINT)records.size()};
+  std::ofstream output(fname, std::ios::binary);
+
+  output.write((const char*)&header, sizeof(header));
+  output.write((const char*)pages.data(), pages.size()*sizeof(CAtlasPage));
+  output.write((const char*)records.data(), records.size()*sizeof(CAtlasRecord));
+
+  return (bool)output;
+} //Save
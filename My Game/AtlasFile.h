@@ -0,0 +1,92 @@
+/// \file AtlasFile.h
+/// \brief Interface for the atlas manifest class CAtlasFile.
+
+#ifndef __L4RC_GAME_ATLASFILE_H__
+#define __L4RC_GAME_ATLASFILE_H__
+
+#include <string>
+#include <vector>
+
+#include "GameDefines.h"
+#include "MappedFile.h"
+
+/// \brief Atlas manifest header.
+///
+/// The first thing in an atlas manifest.
+
+struct CAtlasHeader{
+  char m_pMagic[4]; ///< Must be "RGMA".
+  UINT m_nVersion; ///< Must be CAtlasFile::VERSION.
+  UINT m_nPages; ///< Number of page records that follow.
+  UINT m_nCount; ///< Number of sprite records that follow the pages.
+}; //CAtlasHeader
+
+/// \brief Atlas page record.
+///
+/// One image of an atlas, in the same folder as the manifest.
+
+struct CAtlasPage{
+  char m_szFile[56]; ///< Image file name, null-terminated.
+  UINT m_nWidth; ///< Width in pixels.
+  UINT m_nHeight; ///< Height in pixels.
+}; //CAtlasPage
+
+/// \brief Atlas sprite record.
+///
+/// Where one sprite is in an atlas: which page, the rectangle of the page
+/// that it takes up in pixels from the top left, and the same rectangle as
+/// texture coordinates from 0 to 1, ready for the renderer.
+
+struct CAtlasRecord{
+  UINT m_nSprite; ///< Sprite type.
+  UINT m_nPage; ///< Page index.
+  UINT m_nLeft; ///< Left edge in pixels.
+  UINT m_nTop; ///< Top edge in pixels.
+  UINT m_nWidth; ///< Width in pixels, which is the sprite width.
+  UINT m_nHeight; ///< Height in pixels, which is the sprite height.
+  float m_fU0; ///< Left edge texture coordinate.
+  float m_fV0; ///< Top edge texture coordinate.
+  float m_fU1; ///< Right edge texture coordinate.
+  float m_fV1; ///< Bottom edge texture coordinate.
+}; //CAtlasRecord
+
+/// \brief Atlas manifest.
+///
+/// An atlas is a few big images, called pages, with the sprite images
+/// packed into them. The manifest says where each sprite is. A renderer
+/// that can draw a rectangle of a texture could draw the sprites from one
+/// texture instead of one each, but the engine's sprite renderer can't, so
+/// for now the manifest is only used for the sprite sizes.
+/// It is made by the `AtlasPacker` tool along with the pages. It is a
+/// CAtlasHeader followed by an array of CAtlasPage and an array of
+/// CAtlasRecord in native byte order. Like a level file, it is
+/// memory-mapped and its records are used in place. Sprite types that
+/// are not in the atlas have no record.
+
+class CAtlasFile{
+  private:
+    CMappedFile m_cFile; ///< Memory-mapped manifest.
+    std::string m_strFolder; ///< Folder that the manifest is in.
+    const CAtlasPage* m_pPage = nullptr; ///< Pages in the mapped file.
+    UINT m_nPages = 0; ///< Number of pages.
+    UINT m_nCount = 0; ///< Number of sprite records.
+    const CAtlasRecord* m_pSprite[(UINT)eSprite::Size] = {nullptr}; ///< Record of each sprite.
+
+  public:
+    static const UINT VERSION = 1; ///< Manifest version.
+
+    bool Load(const std::string& fname); ///< Load manifest.
+    void Unload(); ///< Unload manifest.
+
+    UINT GetPageCount() const; ///< Get number of pages.
+    const CAtlasPage& GetPage(UINT i) const; ///< Get a page.
+    std::string GetPageFileName(UINT i) const; ///< Get path of a page image.
+
+    UINT GetCount() const; ///< Get number of sprite records.
+    const CAtlasRecord* Get(eSprite t) const; ///< Get the record of a sprite.
+
+    static bool Save(const std::string& fname, const std::vector<CAtlasPage>& pages,
+      const std::vector<CAtlasRecord>& records); ///< Save manifest.
+}; //CAtlasFile
+
+#endif //__L4RC_GAME_ATLASFILE_H__
@@ -2,52 +2,46 @@
 
 #include "GameDefines.h"
 #include "ObjectManager.h"
-#include "Renderer.h"
+#include "Prototypes.h"
+#include "SpriteSizes.h"
 #include "ComponentIncludes.h"
 
 // constructor
-CBird::CBird(float x, float y)
+CBird::CBird(CContext& c, float x, float y):
+    CCommon(c)
 {
-    b2BodyDef bd;
-    bd.type = b2_dynamicBody;
-    bd.position.Set(RW2PW(x), RW2PW(y));
-
-    //shape
-    b2CircleShape s;
-    s.m_radius = RW2PW(m_pRenderer->GetWidth(eSprite::Bird)) / 2.0f;
-
-    //fixture
-    b2FixtureDef fd;
-    fd.shape = &s;
-    fd.density = 1.0f;
-    fd.restitution = 0.1f;
-
-    //body and fixture
-    pBird = m_pPhysicsWorld->CreateBody(&bd);
-    pBird->CreateFixture(&fd);
-
+    pBird = m_pPrototypes->Create(m_pPhysicsWorld, eSprite::Bird, b2Vec2(RW2PW(x), RW2PW(y)));
     m_pObjectManager->CreateObject(eSprite::Bird, pBird);
 }
 
+// reset to initial conditions, ready to be launched again
+void CBird::Reset()
+{
+    launched = false;
+}
+
 // move bird
 void CBird::move()
 {
         // upward direction in physics world
-        const b2Vec2 v0(-900.0f, 900.0f);
-
-        // position in physics world to apply impulse
-        const b2Vec2 p0(pBird->GetPosition().x, pBird->GetPosition().y);
+        const b2Vec2 v0 = m_cTuning.m_vBirdImpulse;
 
         // deliver impulse to bird
         if (launched == false)
         {
-            m_pBird->DeliverImpulse(pBird, v0, p0);
+            DeliverImpulse(pBird, v0);
             launched = true;
         }
 }
 
+// whether bird has been launched
+bool CBird::IsLaunched()
+{
+    return launched;
+}
+
 // deliver impulse
-void CBird::DeliverImpulse(b2Body* b, const b2Vec2& v, const b2Vec2& ds)
+void CBird::DeliverImpulse(b2Body* b, const b2Vec2& v)
 {
     b->ApplyLinearImpulse(v, b->GetPosition() , true);
 }
\ No newline at end of file
@@ -1,6 +1,6 @@
 #pragma once
 #include "GameDefines.h"
-#include "Box2D\Box2D.h"
+#include "box2d/box2d.h"
 
 #include "Common.h"
 #include "Settings.h"
@@ -17,7 +17,9 @@ private:
     bool launched = false; // flag for if bird is launched
     
 public:
-    CBird(float, float); // constructor
+    CBird(CContext&, float, float); // constructor
+    void Reset(); // reset to initial conditions
     void move(); // move bird
-    void DeliverImpulse(b2Body*, const b2Vec2&, const b2Vec2 & = b2Vec2(0, 0)); // deliver impulse to bird
+    bool IsLaunched(); // whether bird has been launched
+    void DeliverImpulse(b2Body*, const b2Vec2&); // deliver impulse to bird
 }; 
\ No newline at end of file
@@ -1,16 +1,42 @@
+#include <algorithm>
+
 #include "Catapult.h"
 
 #include "GameDefines.h"
 #include "ObjectManager.h"
-#include "Renderer.h"
+#include "Prototypes.h"
+#include "SpriteSizes.h"
 #include "ComponentIncludes.h"
 #include "Bird.h"
 
+/// Furthest that the arm swings, in radians.
+
+static const float fThrowAngle = 1.6f;
+
+/// Angle that the arm has swung through, in radians, when the bird is
+/// launched, which is when the cup is moving up and to the left.
+
+static const float fReleaseAngle = 0.95f;
+
+/// Fastest that the arm swings, in radians per second.
+
+static const float fArmSpeed = 10.0f;
+
+/// Time in seconds that it takes the arm to get up to full speed.
+
+static const float fArmRampTime = 0.1f;
+
+/// Most torque that the arm's motor can apply, enough to swing the arm
+/// with the bird in its cup.
+
+static const float fArmTorque = 200000.0f;
+
 // constructor
-CCatapult::CCatapult(float x, float y)
+CCatapult::CCatapult(CContext& c, float x, float y):
+    CCommon(c)
 {
-    const float height = m_pRenderer->GetHeight(eSprite::Base);
-    const float width = m_pRenderer->GetWidth(eSprite::Base);
+    const float height = m_pSpriteSizes->GetHeight(eSprite::Base);
+    const float width = m_pSpriteSizes->GetWidth(eSprite::Base);
 
     // create body, catapult, and wheels
     m_pBody = CreateBody(x, y);
@@ -35,14 +61,17 @@ CCatapult::CCatapult(float x, float y)
     wd.Initialize(m_pBody, pWheel2, pWheel2->GetPosition(), axis);
     m_pWheelJoint2 = (b2WheelJoint*)m_pPhysicsWorld->CreateJoint(&wd);
 
-    // revolute joint definition
+    // revolute joint definition, arm held at rest by its motor until it swings
+    // anticlockwise, which makes the joint angle go down, as far as the lower limit
     b2RevoluteJointDef jd;
     jd.Initialize(m_pCatapult, m_pBody, m_pCatapult->GetPosition());
-    jd.maxMotorTorque = 1000.0f;
+    jd.maxMotorTorque = fArmTorque;
     jd.motorSpeed = 0.0f;
     jd.enableMotor = true;
+    jd.lowerAngle = -fThrowAngle;
     jd.upperAngle = 0.0f;
     jd.enableLimit = true;
+    jd.userData.pointer = (uintptr_t)this; // so that Find() can get this catapult from its arm
 
     //create revolute joint
     m_pCatapultJoint = (b2RevoluteJoint*)m_pPhysicsWorld->CreateJoint(&jd);
@@ -51,36 +80,10 @@ CCatapult::CCatapult(float x, float y)
 // create body
 b2Body* CCatapult::CreateBody(float x, float y)
 {
-    float w, h;
-    m_pRenderer->GetSize(eSprite::Base, w, h);
-    const float w2 = RW2PW(w) / 2.0f;
-    const float h2 = RW2PW(h) / 2.0f;
-
-    //shape
-    b2Vec2 vertices[3];
-    vertices[0].Set(-w2, -h2);
-    vertices[1].Set(w2, -h2);
-    vertices[2].Set(0.0f, h2);
-
-    b2PolygonShape shape;
-    shape.Set(vertices, 3);
-
-    //fixture
-    b2FixtureDef fd;
-    fd.shape = &shape;
-    fd.density = 1.0f;
-    fd.restitution = 0.4f;
-    fd.filter.groupIndex = -5;
-
-    //body definition
-    b2BodyDef bd;
-    bd.type = b2_dynamicBody;
-    bd.position.Set(x, y + h2);
-
-    //body
-    b2Body* body = m_pPhysicsWorld->CreateBody(&bd);
+    const float h2 = RW2PW(m_pSpriteSizes->GetHeight(eSprite::Base)) / 2.0f;
+
+    b2Body* body = m_pPrototypes->Create(m_pPhysicsWorld, eSprite::Base, b2Vec2(x, y + h2));
     m_pObjectManager->CreateObject(eSprite::Base, body);
-    body->CreateFixture(&fd);
 
     return body;
 }
@@ -88,43 +91,44 @@ b2Body* CCatapult::CreateBody(float x, float y)
 // create wheel
 b2Body* CCatapult::CreateWheel(float x, float y)
 {
-    const float r = m_pRenderer->GetWidth(eSprite::Wheel) / 2.0f;
-
-    //shape
-    b2CircleShape shape;
-    shape.m_radius = RW2PW(r);
-
-    //fixture
-    b2FixtureDef fd;
-    fd.shape = &shape;
-    fd.density = 0.8f;
-    fd.restitution = 0.6f;
-    fd.filter.groupIndex = -5;
-
-    //body definition
-    b2BodyDef bd;
-    bd.type = b2_dynamicBody;
-    bd.position.Set(x, y);
-
-    //body
-    b2Body* pBody = m_pPhysicsWorld->CreateBody(&bd);
+    b2Body* pBody = m_pPrototypes->Create(m_pPhysicsWorld, eSprite::Wheel, b2Vec2(x, y));
     m_pObjectManager->CreateObject(eSprite::Wheel, pBody);
-    pBody->CreateFixture(&fd);
 
     return pBody;
 }
 
-// move catapult
-void CCatapult::move()
+/// Reset to initial conditions, stopping the wheels and the arm. This is
+/// called after the snapshot has been restored, which puts the arm back
+/// and stops the solver from warm starting the joints with the impulses
+/// that they built up in the last run.
+
+void CCatapult::Reset()
+{
+    collision = false;
+    throwing = false;
+    throwTime = 0.0f;
+
+    m_pWheelJoint1->SetMotorSpeed(0.0f);
+    m_pWheelJoint2->SetMotorSpeed(0.0f);
+    m_pCatapultJoint->SetMotorSpeed(0.0f);
+}
+
+/// Drive the catapult forward until it reaches the middle of the window,
+/// then stop it and swing its arm, launching the bird once the arm has
+/// swung far enough. Everything is driven by joint motors and time, not
+/// by frames, so it happens the same way at any frame rate.
+/// \param t Time step in seconds.
+
+void CCatapult::move(float t)
 {
     const float x = PW2RW(m_pBody->GetPosition().x);
 
     // if catapult is to the right of the screen's center,
     if (x >= m_vWinCenter.x)
     {
-        // set motor speed to 4
-        m_pWheelJoint1->SetMotorSpeed(4.0f);
-        m_pWheelJoint2->SetMotorSpeed(4.0f);
+        // set motor speed to the tuned speed
+        m_pWheelJoint1->SetMotorSpeed(m_cTuning.m_fCatapultSpeed);
+        m_pWheelJoint2->SetMotorSpeed(m_cTuning.m_fCatapultSpeed);
     }
     else
     {
@@ -132,91 +136,45 @@ void CCatapult::move()
         m_pWheelJoint1->SetMotorSpeed(0.0f);
         m_pWheelJoint2->SetMotorSpeed(0.0f);
 
-        // rotate catapult for 60 frames (i.e. 1 second)
-        if (counter <= 59)
-        {
-            Rotate();
-            counter++;
-        }
+        // swing the arm, and launch the bird once it has swung far enough
+        Swing(t);
 
-        // launch bird
-        m_pBird->move();
+        if (-m_pCatapultJoint->GetJointAngle() >= fReleaseAngle && m_pRigBird)
+            m_pRigBird->move();
     }
 }
 
 // create catapult
 b2Body* CCatapult::CreateCatapult(float x, float y)
 {
-    // body
-    b2BodyDef bd;
-    bd.type = b2_dynamicBody;
-    bd.position.Set(x, y);
-    bd.angle = 6.10865;
-
-    // set polygon vertices
-    b2Vec2 v1[4];
-    b2Vec2 v2[4];
-
-    v1[0] = setVertice(0.0f, 65.0f, eSprite::Catapult);
-    v1[1] = setVertice(159.0f, 65.0f, eSprite::Catapult);
-    v1[2] = setVertice(159.0f, 79.0f, eSprite::Catapult);
-    v1[3] = setVertice(0.0f, 79.0f, eSprite::Catapult);
-
-    v2[0] = setVertice(142.0f, 0.0f, eSprite::Catapult);
-    v2[1] = setVertice(159.0f, 0.0f, eSprite::Catapult);
-    v2[2] = setVertice(159.0f, 79.0f, eSprite::Catapult);
-    v2[3] = setVertice(142.0f, 79.0f, eSprite::Catapult);
-
-    // create polygon shape
-    b2PolygonShape ps1;
-    b2PolygonShape ps2;
-    ps1.Set(v1, 4);
-    ps2.Set(v2, 4);
-
-    // create fixture definition
-    b2FixtureDef fd1;
-    fd1.shape = &ps1;
-    fd1.density = 1.0f;
-    fd1.restitution = 0.5f;
-    fd1.filter.groupIndex = -5;
-    b2FixtureDef fd2;
-    fd2.shape = &ps2;
-    fd2.density = 1.0f;
-    fd2.restitution = 0.0f;
-    fd2.filter.groupIndex = -5;
-
-    // create body and fixture
-    b2Body* pBody = m_pPhysicsWorld->CreateBody(&bd);
-    pBody->CreateFixture(&fd1);
-    pBody->CreateFixture(&fd2);
-
+    // arm and cup, tilted back
+    b2Body* pBody = m_pPrototypes->Create(m_pPhysicsWorld, eSprite::Catapult, b2Vec2(x, y), 6.10865f);
     m_pObjectManager->CreateObject(eSprite::Catapult, pBody);
 
     return pBody;
 }
 
-// set the vertices of polygons
-b2Vec2 CCatapult::setVertice(float x, float y, eSprite e)
-{
-    b2Vec2 vertice; //vertice
-    float w, h; //width and height of sprite
-    m_pRenderer->GetSize(e, w, h);
-
-    // Calculate the x and y coordinates.
-    // Artist world coordinates are relative to the top-left corner of the sprite.
-    // Physics world coordinates are relative to the center of the sprite.
-    // x coordinate = subtract half of length (physics world center x coordinate), divide by 10
-    // y coordinate = flip y, add add half of height (physics world center y coordinate), divide by 10.
-    // y must be flipped because the origin in game is at the bottom-left corner, not the top-left corner.
-    vertice.Set(RW2PW(x - w / 2.0f), RW2PW(-y + h / 2.0f));
-
-    return vertice;
-}
+/// Swing the catapult arm by setting the speed of its joint motor, which
+/// gets up to full speed over a fixed time from when the swing starts, and
+/// stops once the arm reaches its limit. The arm is never moved by hand,
+/// so Physics World moves it as it would any other body.
+/// \param t Time step in seconds.
 
-// rotate catapult arm
-void CCatapult::Rotate()
+void CCatapult::Swing(float t)
 {
-    m_pCatapult->SetTransform(m_pCatapult->GetPosition(), m_pCatapult->GetAngle() + 0.11);
+    if (!throwing) { // start swinging
+        throwing = true;
+        throwTime = 0.0f;
+    }
+    else throwTime += t;
+
+    if (-m_pCatapultJoint->GetJointAngle() >= fThrowAngle - 0.01f) // swung as far as it goes
+        m_pCatapultJoint->SetMotorSpeed(0.0f);
+
+    else { // speed up to full speed, the joint angle goes down as the arm swings
+        const float f = std::min(1.0f, throwTime / fArmRampTime); //fraction of full speed
+        m_pCatapultJoint->SetMotorSpeed(-f * fArmSpeed);
+    }
 }
 
 // get collision between bird and catapult
@@ -227,4 +185,25 @@ bool CCatapult::GetCollision() {
 // set collision between bird and catapult
 void CCatapult::SetCollision(bool c) {
     collision = c;
+}
+
+// set the bird that this catapult launches
+void CCatapult::SetBird(CBird* p) {
+    m_pRigBird = p;
+}
+
+/// Get the catapult that a body belongs to if it is a catapult arm, which
+/// is jointed to its base by the only joint that has a catapult in its user
+/// data. This lets a collision with the arm be answered by the catapult
+/// that was hit, however many there are.
+/// \param p Pointer to a body.
+/// \return Pointer to the catapult, or nullptr if the body is not an arm.
+
+CCatapult* CCatapult::Find(b2Body* p)
+{
+    for (b2JointEdge* e = p->GetJointList(); e; e = e->next)
+        if (e->joint->GetType() == e_revoluteJoint && e->joint->GetUserData().pointer)
+            return (CCatapult*)e->joint->GetUserData().pointer;
+
+    return nullptr;
 }
\ No newline at end of file
@@ -1,18 +1,21 @@
 #pragma once
 #include "Object.h"
-#include "Box2D\Box2D.h"
+#include "box2d/box2d.h"
 #include "Common.h"
 #include "Component.h"
 #include "Settings.h"
 
+class CBird;
+
 class CCatapult :
     public CCommon,
     public LSettings,
     public LComponent
 {
 private:
-    int counter = 0; // frame counter
     bool collision = false; // flag for collision with bird and catapult
+    bool throwing = false; // whether the arm has started to swing
+    float throwTime = 0.0f; // seconds since the arm started to swing
 
     b2Body* m_pBody = nullptr; // pointer to body
     b2Body* m_pCatapult = nullptr; // pointer to catapult
@@ -20,18 +23,22 @@ private:
     b2WheelJoint* m_pWheelJoint1 = nullptr; // ointer to wheel joint
     b2WheelJoint* m_pWheelJoint2 = nullptr; // pointer to wheel joint
     b2RevoluteJoint* m_pCatapultJoint = nullptr; // pointer to catapult joint
+    CBird* m_pRigBird = nullptr; // pointer to the bird that this catapult launches
 
     b2Body* CreateBody(float, float); // create body
     b2Body* CreateWheel(float, float); // create wheel
     b2Body* CreateCatapult(float, float);
 
-    b2Vec2 setVertice(float, float, eSprite); // set the vertices of polygons
-    void Rotate(); // rotate catapult arm
+    void Swing(float); // drive the catapult arm's motor
 
 public:
-    CCatapult(float, float); // constructor
+    CCatapult(CContext&, float, float); // constructor
 
-    void move(); // Moves and rotates catapult. Is called after bird collides with catapult
+    void Reset(); // reset to initial conditions
+    void move(float); // Moves catapult and swings its arm. Is called after bird collides with catapult
     bool GetCollision(); // get collision between bird and catapult
     void SetCollision(bool); // set collision between bird and catapult
+    void SetBird(CBird*); // set the bird that this catapult launches
+
+    static CCatapult* Find(b2Body*); // get the catapult that an arm belongs to
 }; //CCatapult
\ No newline at end of file
@@ -1,23 +1,27 @@
 /// \file Common.cpp
 /// \brief Code for the class CCommon.
-///
-/// This file contains declarations and initial values
-/// for CCommon's static member variables.
 
 #include "Common.h"
 
-CRenderer* CCommon::m_pRenderer = nullptr; 
-b2World* CCommon::m_pPhysicsWorld = nullptr;
-CObjectManager* CCommon::m_pObjectManager = nullptr;
-LParticleEngine2D* CCommon::m_pParticleEngine = nullptr;
-
-float CCommon::m_fStartTime = 0;
-float CCommon::m_fTotalTime = 0;
-
-eGameState CCommon::m_eGameState = eGameState::Initial;
-eDrawMode CCommon::m_eDrawMode = eDrawMode::Sprites;
-
-CPulley* CCommon::m_pPulley = nullptr;
-CCatapult* CCommon::m_pCatapult = nullptr;
-CBird* CCommon::m_pBird = nullptr;
+/// Bind the references to the members of a simulation context.
+/// \param c Simulation context.
 
+CCommon::CCommon(CContext& c):
+  m_cContext(c),
+  m_pPhysicsWorld(c.m_pPhysicsWorld),
+  m_pRenderer(c.m_pRenderer),
+  m_pSpriteSizes(c.m_pSpriteSizes),
+  m_pPrototypes(c.m_pPrototypes),
+  m_pVoicePool(c.m_pVoicePool),
+  m_pImpactParticles(c.m_pImpactParticles),
+  m_pObjectManager(c.m_pObjectManager),
+  m_pParticleEngine(c.m_pParticleEngine),
+  m_fTime(c.m_fTime),
+  m_fStartTime(c.m_fStartTime),
+  m_fTotalTime(c.m_fTotalTime),
+  m_eGameState(c.m_eGameState),
+  m_eDrawMode(c.m_eDrawMode),
+  m_cTuning(c.m_cTuning),
+  m_pCatapult(c.m_pCatapult),
+  m_pBird(c.m_pBird){
+} //constructor
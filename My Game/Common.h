@@ -11,39 +11,96 @@
 
 class CObjectManager;
 class CRenderer;
+class CSpriteSizes;
+class CPrototypes;
+class CVoicePool;
+class CImpactParticles;
 class b2World;
 
-class CPulley;
 class CCatapult;
 class CBird;
 
+/// \brief Tuning parameters.
+///
+/// The tuning parameters are the physical constants that decide whether
+/// the machine finishes and how fast. The defaults are the hand-tuned
+/// values. The density and restitution go into fixtures when the level
+/// is built, so changing them has no effect until it is built again.
+
+struct CTuning{
+  float m_fHeavyBallDensity = 10.0f; ///< Heavy ball density, unless the level file says otherwise.
+  b2Vec2 m_vBirdImpulse = b2Vec2(-900.0f, 900.0f); ///< Impulse that launches the bird.
+  float m_fCatapultSpeed = 4.0f; ///< Catapult wheel motor speed.
+  float m_fBumperRestitution = 2.0f; ///< Bumper restitution.
+}; //CTuning
+
+/// \brief The simulation context.
+///
+/// The simulation context holds the things that are common to the
+/// components of one Rube Goldberg machine, including its game state
+/// variables. Each machine has its own context, so any number of machines
+/// can be run side by side, for example one per thread. Nothing in a
+/// context is shared with any other context.
+
+struct CContext{
+  b2World* m_pPhysicsWorld = nullptr; ///< Pointer to Box2D Physics World.
+  CRenderer* m_pRenderer = nullptr; ///< Pointer to renderer.
+  CSpriteSizes* m_pSpriteSizes = nullptr; ///< Pointer to sprite size table.
+  CPrototypes* m_pPrototypes = nullptr; ///< Pointer to shape prototype registry.
+  CVoicePool* m_pVoicePool = nullptr; ///< Pointer to voice pool.
+  CImpactParticles* m_pImpactParticles = nullptr; ///< Pointer to impact particle system.
+  CObjectManager* m_pObjectManager = nullptr; ///< Pointer to object manager.
+  LParticleEngine2D* m_pParticleEngine = nullptr; ///< Pointer to particle engine.
+
+  float m_fTime = 0; ///< Simulated time in seconds.
+  float m_fStartTime = 0; ///< Time machine started.
+  float m_fTotalTime = 0; ///< Elapsed time at finish.
+
+  eGameState m_eGameState = eGameState::Initial; ///< Game state.
+  eDrawMode m_eDrawMode = eDrawMode::Sprites; ///< Draw mode.
+  CTuning m_cTuning; ///< Tuning parameters.
+
+  CCatapult* m_pCatapult = nullptr; ///< Pointer to car.
+  CBird* m_pBird = nullptr; ///< Pointer to bird.
+}; //CContext
+
 /// \brief The common variables class.
 ///
-/// CCommon is a singleton class that encapsulates 
-/// things that are common to different game components,
-/// including game state variables.
-/// Making it a singleton class means
+/// CCommon gives the classes derived from it direct access to the
+/// members of a simulation context, through references that are bound
+/// when it is constructed. This means
 /// that we can avoid passing its member variables
 /// around as parameters, which makes the code
 /// minisculely faster, and more importantly, reduces
-/// function clutter.
+/// function clutter. The context must outlive
+/// everything that is constructed with it.
 
 class CCommon{
   protected:   
-    static b2World* m_pPhysicsWorld; ///< Pointer to Box2D Physics World.
-    static CRenderer* m_pRenderer; ///< Pointer to renderer.
-    static CObjectManager* m_pObjectManager; ///< Pointer to object manager.
-    static LParticleEngine2D* m_pParticleEngine; ///< Pointer to particle engine.
+    CContext& m_cContext; ///< Simulation context.
+
+    b2World*& m_pPhysicsWorld; ///< Pointer to Box2D Physics World.
+    CRenderer*& m_pRenderer; ///< Pointer to renderer.
+    CSpriteSizes*& m_pSpriteSizes; ///< Pointer to sprite size table.
+    CPrototypes*& m_pPrototypes; ///< Pointer to shape prototype registry.
+    CVoicePool*& m_pVoicePool; ///< Pointer to voice pool.
+    CImpactParticles*& m_pImpactParticles; ///< Pointer to impact particle system.
+    CObjectManager*& m_pObjectManager; ///< Pointer to object manager.
+    LParticleEngine2D*& m_pParticleEngine; ///< Pointer to particle engine.
     
-    static float m_fStartTime; ///< Time machine started.
-    static float m_fTotalTime; ///< Elapsed time at finish.
+    float& m_fTime; ///< Simulated time in seconds.
+    float& m_fStartTime; ///< Time machine started.
+    float& m_fTotalTime; ///< Elapsed time at finish.
+
+    eGameState& m_eGameState; ///< Game state.
+    eDrawMode& m_eDrawMode;  ///< Draw mode.
+    CTuning& m_cTuning; ///< Tuning parameters.
 
-    static eGameState m_eGameState; ///< Game state.
-    static eDrawMode m_eDrawMode;  ///< Draw mode.
+    CCatapult*& m_pCatapult; ///< Pointer to car.
+    CBird*& m_pBird; ///< Pointer to bird.
 
-    static CPulley* m_pPulley; ///< Pointer to pulley system.
-    static CCatapult* m_pCatapult; ///< Pointer to car.
-    static CBird* m_pBird;
+  public:
+    CCommon(CContext& c); ///< Constructor.
 }; //CCommon
 
 #endif //__L4RC_GAME_COMMON_H__
@@ -5,83 +5,142 @@
 
 #include "GameDefines.h"
 #include "ObjectManager.h"
+#include "VoicePool.h"
+#include "ImpactParticles.h"
 #include "ComponentIncludes.h"
 
 #include "Pulley.h"
 #include "Catapult.h"
 #include "Bird.h"
 
-/// Count the number of bodies out of *m_pBodyA and *m_pBodyB that have objects
-/// have a given sprite type. Returns 0, 1, or 2.
-/// \param t Sprite Type.
-/// \return Number of *m_pBodyA and *m_pBodyB that have type t.
+/// Whether a sprite type is one of the objects that make a noise when they
+/// collide and finish the game when they hit the pig.
+/// \param t Sprite type.
+/// \return true if t is a ball, block, or stick.
 
-UINT CMyListener::Count(eSprite t){
-  if(m_pBodyA == nullptr || m_pBodyB == nullptr)return 0; //safety
+static bool IsNoisy(eSprite t){
+  return t == eSprite::Ball || t == eSprite::Block || t == eSprite::Stick;
+} //IsNoisy
 
-  CObject* objA = (CObject*)m_pBodyA->GetUserData().pointer; //pointer to object A
-  CObject* objB = (CObject*)m_pBodyB->GetUserData().pointer; //pointer to object B
+/// Fill in the pair interest table. The entry for a pair of sprite types,
+/// in either order, says what the game does when objects of those types
+/// collide. The last row and column are for untagged fixtures, such as the
+/// edges of the world. Events that finish the game or trigger a catapult
+/// are kept by the contact queue however full it gets.
+/// \param c Simulation context.
 
-  UINT count = 0; //return value
+CMyListener::CMyListener(CContext& c):
+  CCommon(c)
+{
+  for(UINT i=0; i<PAIR_TYPES; i++) //for each sprite type
+    for(UINT j=0; j<PAIR_TYPES; j++){ //for each sprite type
+      const eSprite a = (eSprite)i;
+      const eSprite b = (eSprite)j;
+      UINT n = 0; //interest flags
 
-  if(objA && objA->GetSpriteType() == t)count++; //object A is one
-  if(objB && objB->GetSpriteType() == t)count++; //object B is one
+      if(IsNoisy(a) || IsNoisy(b))
+        n |= PAIR_OBJECT;
 
-  return count;
-} //Count
+      if((IsNoisy(a) && b == eSprite::Pig) || (IsNoisy(b) && a == eSprite::Pig))
+        n |= PAIR_PIG;
+
+      if((a == eSprite::Bird && b == eSprite::Catapult) ||
+        (a == eSprite::Catapult && b == eSprite::Bird))
+        n |= PAIR_LAUNCH;
+
+      m_nPair[i][j] = (BYTE)n;
+    } //for
+
+  m_cQueue.SetKeep(PAIR_PIG | PAIR_LAUNCH); //game logic must never be dropped
+} //constructor
 
 /// Collision speed is proportional to the magnitude of the relative velocity.
-/// \param wp World point.
+/// \param pA Pointer to body A.
+/// \param pB Pointer to body B.
+/// \param p World point.
 /// \return Collision speed in Physics World units.
 
-float CMyListener::GetSpeed(const b2Vec2& p){
-  const b2Vec2 vA = m_pBodyA->GetLinearVelocityFromWorldPoint(p); //velocity of body A
-  const b2Vec2 vB = m_pBodyB->GetLinearVelocityFromWorldPoint(p); //velocity of body B
+float CMyListener::GetSpeed(b2Body* pA, b2Body* pB, const b2Vec2& p){
+  const b2Vec2 vA = pA->GetLinearVelocityFromWorldPoint(p); //velocity of body A
+  const b2Vec2 vB = pB->GetLinearVelocityFromWorldPoint(p); //velocity of body B
   return (vA - vB).Length(); //speed is magnitude of the velocity of one body relative to the other
 } //GetSpeed
 
-/// Presolve function. Renders a colored star at each contact point and plays
-/// the appropriate sound, depending on what type of objects are contacting.
+/// The impulse of a collision is the collision speed times the reduced
+/// mass of the two bodies, which is the mass of the moving one if the
+/// other is static.
+/// \param e Contact event.
+/// \return Impulse in Physics World units.
+
+float CMyListener::GetImpulse(const CContactEvent& e){
+  const float mA = e.m_pBodyA->GetMass(); //mass of body A, 0 if static
+  const float mB = e.m_pBodyB->GetMass(); //mass of body B, 0 if static
+  const float m = mA == 0.0f? mB: mB == 0.0f? mA: mA*mB/(mA + mB); //reduced mass
+
+  return m*e.m_fSpeed;
+} //GetImpulse
+
+/// Presolve function. Called by the Physics World during its step. Contacts
+/// that have new contact points, between objects that the pair interest
+/// table is interested in, moving fast enough to matter, are recorded in
+/// the contact event queue. Nothing else is done here.
 /// \param c Pointer to the contact.
 /// \param m Pointer to the old contact manifold as it was before this contact.
 
 void CMyListener::PreSolve(b2Contact* c, const b2Manifold* m){
-  b2WorldManifold wm;
-  c->GetWorldManifold(&wm);
+  b2Fixture* pFixtureA = c->GetFixtureA(); //pointer to fixture A
+  b2Fixture* pFixtureB = c->GetFixtureB(); //pointer to fixture B
+
+  const UINT pair = m_nPair[(UINT)GetFixtureSprite(pFixtureA)][(UINT)GetFixtureSprite(pFixtureB)];
+  if(pair == 0)return; //not interested in this pair
+
   b2PointState state1[2], state2[2];
   b2GetPointStates(state1, state2, m, c->GetManifold());
+  if(state2[0] != b2_addState && state2[1] != b2_addState)return; //no new points
+
+  b2WorldManifold wm;
+  c->GetWorldManifold(&wm);
+
+  CContactEvent e; //contact event
+  e.m_pBodyA = pFixtureA->GetBody();
+  e.m_pBodyB = pFixtureB->GetBody();
+  e.m_vPos = wm.points[0];
+  e.m_vNormal = wm.normal;
+  e.m_fSpeed = GetSpeed(e.m_pBodyA, e.m_pBodyB, e.m_vPos);
+  e.m_nPair = pair;
+
+  if(e.m_fSpeed > 8.0f) //objects moving fast enough
+    m_cQueue.Push(e);
+} //PreSolve
+
+/// Respond to the contact events recorded during the last Physics World
+/// step, one merged event per pair of bodies. Plays the appropriate sound,
+/// and finishes the game or triggers the catapult that was hit, depending
+/// on what type of objects were contacting. Bonks go to the voice pool,
+/// which plays the loudest of them at the end of the frame. Every
+/// collision that involves an object also throws off sparks and dust from
+/// the contact point.
+
+void CMyListener::ProcessEvents(){
+  for(const CContactEvent& e: m_cQueue.Drain()){ //for each merged event
+    const float vol = (e.m_fSpeed - 8.0f)/32.0f; //sound volume
+
+    if((e.m_nPair & PAIR_LAUNCH) && m_eGameState != eGameState::Finished){ //bird to catapult
+      CCatapult* p = CCatapult::Find(e.m_pBodyA); //the catapult that was hit
+      if(p == nullptr)p = CCatapult::Find(e.m_pBodyB);
+      if(p)p->SetCollision(true);
+    } //if
+
+    if(e.m_nPair & PAIR_OBJECT){ //there's an object involved
+      m_pImpactParticles->Emit(PW2RW(e.m_vPos), Vector2(e.m_vNormal.x, e.m_vNormal.y),
+        GetImpulse(e));
 
-  for(int i=0; i<2; i++)
-    if(state2[i] == b2_addState){
-      m_pBodyA = c->GetFixtureA()->GetBody(); //pointer to body A
-      m_pBodyB = c->GetFixtureB()->GetBody(); //pointer to body B
-
-      //contact response
-      const b2Vec2 wp = wm.points[0]; //world point
-      const float speed = GetSpeed(wp); //collision speed
-
-      if(speed > 8.0f){ //objects moving fast enough
-        const Vector2 pos = PW2RW(wp); //position in renderer
-
-        const int nObjects = Count(eSprite::Ball) + Count(eSprite::Block) + Count(eSprite::Stick); //number of objects
-        const int nPigs = Count(eSprite::Pig); //number of pigs
-        const int nBirds = Count(eSprite::Bird); //number of birds
-        const int nCatapult = Count(eSprite::Catapult); //number of buttons
-
-        const float vol = (speed - 8.0f)/32.0f; //sound volume
-
-        if (nBirds > 0) //there's a bird involved
-            if (nCatapult > 0 && m_eGameState != eGameState::Finished) { //bird to catapult
-                m_pCatapult->SetCollision(true);
-            } //if
-
-        if(nObjects > 0) //there's an object involved
-          if(nPigs > 0 && m_eGameState != eGameState::Finished){ //object to pig, once only
-            m_pAudio->play(eSound::Yay);
-            m_eGameState = eGameState::Finished;
-            m_fTotalTime = m_pTimer->GetTime() - m_fStartTime;
-          } //if
-          else m_pAudio->play(eSound::Bonk, PW2RW(wp), vol); //everything else
+      if((e.m_nPair & PAIR_PIG) && m_eGameState != eGameState::Finished){ //object to pig, once only
+        m_pAudio->play(eSound::Yay);
+        m_eGameState = eGameState::Finished;
+        m_fTotalTime = m_fTime - m_fStartTime;
       } //if
+      else m_pVoicePool->Add(eSound::Bonk, PW2RW(e.m_vPos), vol); //everything else
     } //if
-} //PreSolve
\ No newline at end of file
+  } //for
+} //ProcessEvents
@@ -6,10 +6,21 @@
 
 #include "Component.h"
 #include "Common.h"
+#include "ContactQueue.h"
 
-#include "Box2D\Box2D.h"
+#include "box2d/box2d.h"
 
 /// \brief My contact listener.
+///
+/// The contact listener looks up the sprite types of the two fixtures in
+/// a contact from their tags in a table of pairs of sprite types, which says
+/// what, if anything, the game does when a pair of that kind collides.
+/// Contacts between pairs that the game does not care about, such as blocks
+/// resting on pins, are dismissed before any other work is done. The rest
+/// are recorded in a queue during the Physics World step, and the game
+/// responds to them afterwards, when ProcessEvents() is called. That is
+/// done after every step rather than once per frame, so that the machine
+/// runs the same whatever the frame rate.
 
 class CMyListener: 
   public b2ContactListener,
@@ -17,14 +28,23 @@ class CMyListener:
   public CCommon{
 
   private:
-    b2Body* m_pBodyA; ///< Pointer to body A.
-    b2Body* m_pBodyB; ///< Pointer to body B.
+    static const UINT PAIR_OBJECT = 1; ///< Pair includes a ball, block, or stick.
+    static const UINT PAIR_PIG = 2; ///< Pair is a ball, block, or stick and a pig.
+    static const UINT PAIR_LAUNCH = 4; ///< Pair is a bird and a catapult.
 
-    UINT Count(eSprite t); ///< Count number of bodies that have sprite type t.
-    float GetSpeed(const b2Vec2& p); ///< Get the collision speed.
+    static const UINT PAIR_TYPES = (UINT)eSprite::Size + 1; ///< Sprite types, plus one for untagged.
+    BYTE m_nPair[PAIR_TYPES][PAIR_TYPES]; ///< Pair interest table.
+
+    CContactQueue m_cQueue; ///< Contact events waiting to be processed.
+
+    float GetSpeed(b2Body* pA, b2Body* pB, const b2Vec2& p); ///< Get the collision speed.
+    float GetImpulse(const CContactEvent& e); ///< Get the collision impulse.
 
   public:
+    CMyListener(CContext& c); ///< Constructor.
+
     void PreSolve(b2Contact* c, const b2Manifold* m); ///< Presolve function.
+    void ProcessEvents(); ///< Respond to contact events.
 }; //CMyListener
 
 #endif //__L4RC_GAME_CONTACTLISTENER_H__
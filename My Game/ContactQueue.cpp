@@ -0,0 +1,145 @@
+/// \file ContactQueue.cpp
+/// \brief Code for the contact event queue CContactQueue.
+
+#include "ContactQueue.h"
+
+#include <algorithm>
+#include <tuple>
+
+/// Reserve space for draining and merging events, so that draining the
+/// queue never allocates memory unless events have overflowed.
+
+CContactQueue::CContactQueue(){
+  static_assert((CAPACITY & (CAPACITY - 1)) == 0, "contact queue capacity must be a power of two");
+  m_stdPending.reserve(CAPACITY);
+  m_stdKey.reserve(CAPACITY);
+  m_stdMerged.reserve(CAPACITY);
+} //constructor
+
+/// Set the pair interest flags that make an event too important to drop.
+/// An event with any of them is kept however full the queue is.
+/// \param n Pair interest flags.
+
+void CContactQueue::SetKeep(UINT n){
+  m_nKeep = n;
+} //SetKeep
+
+/// Add an event to the back of the queue. The head and tail indices run
+/// freely and are wrapped into the buffer when used, so the number of
+/// events is simply their difference. If the queue is full, the event is
+/// dropped unless it must be kept, in which case it takes the place of the
+/// newest event that may be dropped, or if there is none, goes into the
+/// overflow list. Filling the queue is rare, so searching it then costs
+/// little.
+/// \param e Contact event.
+/// \return true if the event was added, false if it was dropped.
+
+bool CContactQueue::Push(const CContactEvent& e){
+  if(m_nTail - m_nHead < CAPACITY){ //not full
+    m_pEvent[m_nTail & (CAPACITY - 1)] = e;
+    m_nTail++;
+    return true;
+  } //if
+
+  if((e.m_nPair & m_nKeep) == 0){ //this one can go
+    m_nDropped++;
+    return false;
+  } //if
+
+  for(UINT i=m_nTail; i!=m_nHead; i--){ //for each event, newest first
+    CContactEvent& old = m_pEvent[(i - 1) & (CAPACITY - 1)];
+
+    if((old.m_nPair & m_nKeep) == 0){ //that one can go instead
+      old = e;
+      m_nDropped++;
+      return true;
+    } //if
+  } //for
+
+  m_stdOverflow.push_back(e); //every event in the queue must be kept
+  return true;
+} //Push
+
+/// Remove all of the events from the queue, merging the events for each
+/// pair of bodies, in either order, into one. The merged event has the
+/// bodies of the first event for the pair, the contact point of the
+/// fastest collision between them, and the pair interest flags of all of
+/// them. The events are sorted on their pair of bodies, so that the events
+/// for each pair are next to each other, in the order in which they were
+/// pushed. This takes time proportional to n log n for n events, where
+/// looking for each event's pair among the merged events would take time
+/// proportional to n squared. Merged events are in the order in which
+/// their pairs first appeared in the queue.
+/// \return Reference to the merged events, valid until the next call.
+
+const std::vector<CContactEvent>& CContactQueue::Drain(){
+  m_stdPending.clear();
+  m_stdKey.clear();
+  m_stdMerged.clear();
+
+  for(; m_nHead != m_nTail; m_nHead++) //for each event, oldest first
+    m_stdPending.push_back(m_pEvent[m_nHead & (CAPACITY - 1)]);
+
+  m_stdPending.insert(m_stdPending.end(), m_stdOverflow.begin(), m_stdOverflow.end());
+  m_stdOverflow.clear();
+
+  for(UINT i=0; i<(UINT)m_stdPending.size(); i++){ //for each event
+    const uintptr_t a = (uintptr_t)m_stdPending[i].m_pBodyA;
+    const uintptr_t b = (uintptr_t)m_stdPending[i].m_pBodyB;
+    m_stdKey.push_back({std::min(a, b), std::max(a, b), i});
+  } //for
+
+  std::sort(m_stdKey.begin(), m_stdKey.end(), [](const CPairKey& u, const CPairKey& v){
+    return std::tie(u.m_nLo, u.m_nHi, u.m_nIndex) < std::tie(v.m_nLo, v.m_nHi, v.m_nIndex);
+  }); //sort
+
+  for(size_t i=0; i<m_stdKey.size(); ){ //for each pair
+    CContactEvent& first = m_stdPending[m_stdKey[i].m_nIndex]; //first event for the pair
+    size_t j = i + 1; //next event
+
+    for(; j<m_stdKey.size() && m_stdKey[j].m_nLo == m_stdKey[i].m_nLo &&
+      m_stdKey[j].m_nHi == m_stdKey[i].m_nHi; j++)
+    { //merge each later event for the pair into the first
+      CContactEvent& e = m_stdPending[m_stdKey[j].m_nIndex];
+
+      if(e.m_fSpeed > first.m_fSpeed){
+        first.m_vPos = e.m_vPos;
+        first.m_vNormal = e.m_vNormal;
+        first.m_fSpeed = e.m_fSpeed;
+      } //if
+
+      first.m_nPair |= e.m_nPair;
+      e.m_pBodyA = nullptr; //merged
+    } //for
+
+    i = j;
+  } //for
+
+  for(const CContactEvent& e: m_stdPending) //for each event, oldest first
+    if(e.m_pBodyA != nullptr) //first for its pair
+      m_stdMerged.push_back(e);
+
+  return m_stdMerged;
+} //Drain
+
+/// Remove all events without looking at them.
+
+void CContactQueue::Clear(){
+  m_nHead = m_nTail;
+  m_stdOverflow.clear();
+} //Clear
+
+/// Reader function for the number of events in the queue.
+/// \return Number of events.
+
+UINT CContactQueue::GetCount() const{
+  return m_nTail - m_nHead + (UINT)m_stdOverflow.size();
+} //GetCount
+
+/// Reader function for the number of events dropped because the queue was
+/// full, since the program started.
+/// \return Number of events dropped.
+
+UINT CContactQueue::GetDropped() const{
+  return m_nDropped;
+} //GetDropped
@@ -0,0 +1,72 @@
+/// \file ContactQueue.h
+/// \brief Interface for the contact event queue CContactQueue.
+
+#ifndef __L4RC_GAME_CONTACTQUEUE_H__
+#define __L4RC_GAME_CONTACTQUEUE_H__
+
+#include <vector>
+
+#include "GameDefines.h"
+
+/// \brief A contact event.
+///
+/// What the contact listener needs to remember about a collision that
+/// the game must respond to once the Physics World has finished its step.
+
+struct CContactEvent{
+  b2Body* m_pBodyA = nullptr; ///< Pointer to body A.
+  b2Body* m_pBodyB = nullptr; ///< Pointer to body B.
+  b2Vec2 m_vPos; ///< Contact point in Physics World.
+  b2Vec2 m_vNormal; ///< Contact normal, from body A to body B.
+  float m_fSpeed = 0; ///< Collision speed in Physics World units.
+  UINT m_nPair = 0; ///< Pair interest flags.
+}; //CContactEvent
+
+/// \brief The contact event queue.
+///
+/// The contact event queue is a fixed-capacity ring buffer of contact
+/// events. The contact listener pushes events onto it during the Physics
+/// World step, which costs no more than a copy, and they are taken off
+/// again after the step by Drain(), which merges the events for the same
+/// pair of bodies into one by sorting them on the pair. If the queue fills
+/// up, further events are dropped and counted, except for events with pair
+/// interest flags that must be kept, such as those that finish the game.
+/// Those take the place of an event that may be dropped, or if there are
+/// none, wait in an overflow list.
+
+class CContactQueue{
+  private:
+    static const UINT CAPACITY = 256; ///< Capacity, must be a power of two.
+
+    /// \brief Sort key for merging.
+
+    struct CPairKey{
+      uintptr_t m_nLo; ///< Lower of the two body addresses.
+      uintptr_t m_nHi; ///< Higher of the two body addresses.
+      UINT m_nIndex; ///< Index of the event, in the order pushed.
+    }; //CPairKey
+
+    CContactEvent m_pEvent[CAPACITY]; ///< Ring buffer of events.
+    UINT m_nHead = 0; ///< Index of oldest event.
+    UINT m_nTail = 0; ///< Index one past newest event.
+    UINT m_nDropped = 0; ///< Number of events dropped because the queue was full.
+    UINT m_nKeep = 0; ///< Pair interest flags of events that must not be dropped.
+
+    std::vector<CContactEvent> m_stdOverflow; ///< Events to keep that didn't fit.
+    std::vector<CContactEvent> m_stdPending; ///< Events being drained, in order.
+    std::vector<CPairKey> m_stdKey; ///< Sort keys for the events being drained.
+    std::vector<CContactEvent> m_stdMerged; ///< Events merged by Drain().
+
+  public:
+    CContactQueue(); ///< Constructor.
+
+    void SetKeep(UINT n); ///< Set flags of events that must not be dropped.
+    bool Push(const CContactEvent& e); ///< Add an event.
+    const std::vector<CContactEvent>& Drain(); ///< Remove and merge all events.
+    void Clear(); ///< Remove all events.
+
+    UINT GetCount() const; ///< Get number of events.
+    UINT GetDropped() const; ///< Get number of events dropped.
+}; //CContactQueue
+
+#endif //__L4RC_GAME_CONTACTQUEUE_H__
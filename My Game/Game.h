@@ -9,7 +9,7 @@
 #include "ObjectManager.h"
 #include "Settings.h"
 
-#include "ContactListener.h"
+#include "Machine.h"
 
 /// \brief The game class.
 
@@ -19,30 +19,27 @@ class CGame:
   public CCommon{ //common parameters for this game
 
   private: 
-    CMyListener m_cContactListener; ///< Contact listener.
+    CMachine m_cMachine; ///< The Rube Goldberg machine.
+    bool m_bLevelLoaded = false; ///< Whether the level file was loaded.
     void LoadSounds(); ///< Load sounds. 
 
+    CReplay m_cReplayFile; ///< Replay loaded from file.
+    CReplayPlayer m_cPlayer; ///< Replay player.
+    bool m_bReplaying = false; ///< Whether playing a replay.
+    float m_fReplayPause = 0; ///< Time paused at the end of the replay.
+
+    float m_fAccumulator = 0; ///< Frame time not yet simulated.
+
+    void Step(); ///< Take one fixed time step.
+
     void BeginGame(); ///< Begin playing the game.
+    void ToggleReplay(); ///< Start or stop playing a replay.
     void KeyboardHandler(); ///< The keyboard handler.
-    void DrawClock(); ///< Draw a timer.
+    void DrawClock(float t); ///< Draw a timer.
     void RenderFrame(); ///< Render an animation frame.
 
-    void CreateButton(float x, float y); ///< Create final button.
-    void CreateBall(float x, float y, float xv=0.0f, float yv=0.0f); ///< Create and launch ball.
-    void CreateHeavyBall(float x, float y, float d = 10.0f); // create heavyball
-    void CreatePlatform(float x, float y, float a = XM_2PI); // create platform
-    void CreateSmallPlatform(float x, float y, float a = XM_2PI); // create small platform
-    void CreateRamp(float x, float y, float a = XM_2PI); // create ramp
-    void CreateBumper(float x, float y, float a = XM_2PI); // create bumper
-    void CreatePins(float x, float y, float a = XM_2PI); // create pins
-    void CreatePropeller(float x, float y, float a = XM_2PI); // create propeller
-    void CreateCircleBumpers(float x, float y); // create circle bumpers
-    void CreateTower(float x, float y, eSprite e, float a = XM_2PI); // create tower of blocks and sticks
-    void CreateLevel(); // create level
-
-    b2Vec2 setVertice(float, float, eSprite); // set the vertices of polygons
-
   public:
+    CGame(CContext& c); ///< Constructor.
     ~CGame(); ///< Destructor.
 
     void Initialize(); ///< Initialize the game.
@@ -5,7 +5,7 @@
 #define __L4RC_GAME_GAMEDEFINES_H__
 
 #include "Defines.h"
-#include "Box2D\Box2D.h"
+#include "box2d/box2d.h"
 
 /// \brief Sprite enumerated type.
 
@@ -17,6 +17,47 @@ enum class eSprite{
   Size //MUST BE LAST
 }; //eSprite
 
+/// \brief Sprite name.
+///
+/// Get the name of the sprite tag for a sprite type in `gamesettings.xml`.
+/// The order of the names must match the order of `eSprite`.
+/// \param t Sprite type.
+/// \return Sprite tag name.
+
+inline const char* GetSpriteName(eSprite t){
+  static const char* const name[] = {
+    "background", "line", "pig", "clockface", "ball", "ramp", "bumper",
+    "basket", "platform", "pin", "heavyball", "smallplatform",
+    "pulleywheel", "pulleyline",
+    "circlebumper", "cannonbase", "wheel", "catapult", "block", "stick", "bird", "propeller"
+  }; //name
+
+  static_assert(sizeof(name)/sizeof(name[0]) == (size_t)eSprite::Size,
+    "one sprite name per sprite type");
+
+  return name[(size_t)t];
+} //GetSpriteName
+
+/// Get the tag that marks a Box2D fixture as belonging to an object of a
+/// given sprite type. Tags are kept in the fixture's user data, offset by
+/// one, since Box2D sets the user data of an untagged fixture to 0.
+/// \param t Sprite type.
+/// \return Fixture tag.
+
+inline uintptr_t GetFixtureTag(eSprite t){
+  return (uintptr_t)t + 1;
+} //GetFixtureTag
+
+/// Get the sprite type of the object that a Box2D fixture belongs to from
+/// the tag in its user data.
+/// \param p Pointer to a Box2D fixture.
+/// \return Sprite type, or eSprite::Size if the fixture is untagged.
+
+inline eSprite GetFixtureSprite(b2Fixture* p){
+  const uintptr_t n = p->GetUserData().pointer; //tag
+  return n == 0 || n > (uintptr_t)eSprite::Size? eSprite::Size: (eSprite)(n - 1);
+} //GetFixtureSprite
+
 /// \brief Game state enumerated type.
 ///
 /// State of game play, including whether the player has won or lost.
@@ -34,6 +75,16 @@ enum class eDrawMode: UINT{
   Size //MUST be last
 }; //eDrawMode
 
+/// \brief Reset mode enumerated type.
+///
+/// How the machine gets back to its initial conditions: by destroying
+/// everything and building the level again, or by restoring a snapshot
+/// of the Physics World taken just after the level was first built.
+
+enum class eResetMode{
+  Rebuild, Restore
+}; //eResetMode
+
 /// Game sound enumerated type. 
 ///
 /// These are the sounds used in actual gameplay. 
@@ -43,6 +94,29 @@ enum eSound{
   Size //MUST BE LAST
 }; //eSound
 
+/// \brief Sound name.
+///
+/// Get the name of the sound tag for a sound in `gamesettings.xml`.
+/// The order of the names must match the order of `eSound`.
+/// \param t Sound.
+/// \return Sound tag name.
+
+inline const char* GetSoundName(eSound t){
+  static const char* const name[] = {
+    "whoosh", "yay", "bonk", "buzz", "restart"
+  }; //name
+
+  static_assert(sizeof(name)/sizeof(name[0]) == (size_t)eSound::Size,
+    "one sound name per sound");
+
+  return name[(size_t)t];
+} //GetSoundName
+
+//Physics World time step
+
+const float fStepTime = 1.0f/60.0f; ///< Physics World time step in seconds.
+const UINT nMaxSteps = 5; ///< Most Physics World steps per frame.
+
 //Translate units between renderer and Physics World
 
 const float fPRV = 10.0f; ///< Physics World to renderer rescale value.
@@ -0,0 +1,102 @@
+/// \file HullFile.cpp
+/// \brief Code for the hull file class CHullFile.
+
+#include <cstring>
+#include <fstream>
+
+#include "HullFile.h"
+
+/// Map a hull file into memory and check that its header, size, and
+/// records are sensible, then find where the hulls of each sprite are.
+/// Any hull file that was already loaded is unloaded first.
+/// \param fname Hull file name.
+/// \return true if the hull file was loaded.
+
+bool CHullFile::Load(const std::string& fname){
+  Unload();
+
+  if(!m_cFile.Open(fname))return false;
+
+  const size_t size = m_cFile.GetSize();
+  if(size < sizeof(CHullHeader))return false;
+
+  const CHullHeader* pHeader = (const CHullHeader*)m_cFile.GetData();
+
+  if(memcmp(pHeader->m_pMagic, "RGMH", 4) != 0 || pHeader->m_nVersion != VERSION ||
+    size != sizeof(CHullHeader) + pHeader->m_nCount*sizeof(CHullRecord))
+  {
+    m_cFile.Close();
+    return false;
+  } //if
+
+  m_pRecord = (const CHullRecord*)(pHeader + 1);
+  m_nCount = pHeader->m_nCount;
+
+  for(UINT i=0; i<m_nCount; i++){ //check records and count the hulls of each sprite
+    const CHullRecord& r = m_pRecord[i];
+    const UINT t = r.m_nSprite; //sprite type
+
+    if(t >= (UINT)eSprite::Size || r.m_nCount < 3 || r.m_nCount > MAXVERTICES ||
+      (m_nHulls[t] > 0 && m_nFirst[t] + m_nHulls[t] != i)) //not together
+    {
+      Unload();
+      return false;
+    } //if
+
+    if(m_nHulls[t]++ == 0)m_nFirst[t] = i;
+  } //for
+
+  return true;
+} //Load
+
+/// Unmap the hull file.
+
+void CHullFile::Unload(){
+  m_cFile.Close();
+  m_pRecord = nullptr;
+  m_nCount = 0;
+
+  for(UINT i=0; i<(UINT)eSprite::Size; i++)
+    m_nFirst[i] = m_nHulls[i] = 0;
+} //Unload
+
+/// Reader function for the number of records.
+/// \return Number of records, which is zero if no hull file is loaded.
+
+UINT CHullFile::GetCount() const{
+  return m_nCount;
+} //GetCount
+
+/// Reader function for the number of hulls of a sprite.
+/// \param t Sprite type.
+/// \return Number of hulls, which is zero if the sprite has none.
+
+UINT CHullFile::GetHullCount(eSprite t) const{
+  return m_nHulls[(UINT)t];
+} //GetHullCount
+
+/// Reader function for a hull of a sprite.
+/// \param t Sprite type.
+/// \param i Hull index, which must be less than GetHullCount(t).
+/// \return Reference to the hull record.
+
+const CHullRecord& CHullFile::GetHull(eSprite t, UINT i) const{
+  return m_pRecord[m_nFirst[(UINT)t] + i];
+} //GetHull
+
+/// Save a hull file.
+/// \param fname Hull file name.
+/// \param records Hull records, with the records of each sprite together.
+/// \return true if the file was written.
+
+bool CHullFile::Save(const std::string& fname,
+  const std::vector<CHullRecord>& records)
+{
+  const CHullHeader header = {{'R', 'G', 'M', 'H'}, VERSION, (UINT)records.size()};
+  std::ofstream output(fname, std::ios::binary);
+
+  output.write((const char*)&header, sizeof(header));
+  output.write((const char*)records.data(), records.size()*sizeof(CHullRecord));
+
+  return (bool)output;
+} //Save
@@ -0,0 +1,69 @@
+/// \file HullFile.h
+/// \brief Interface for the hull file class CHullFile.
+
+#ifndef __L4RC_GAME_HULLFILE_H__
+#define __L4RC_GAME_HULLFILE_H__
+
+#include <string>
+#include <vector>
+
+#include "GameDefines.h"
+#include "MappedFile.h"
+
+/// \brief Hull file header.
+///
+/// The first thing in a hull file.
+
+struct CHullHeader{
+  char m_pMagic[4]; ///< Must be "RGMH".
+  UINT m_nVersion; ///< Must be CHullFile::VERSION.
+  UINT m_nCount; ///< Number of hull records that follow.
+}; //CHullHeader
+
+/// \brief Hull file record.
+///
+/// One convex polygon of a sprite's collision shape, with up to
+/// CHullFile::MAXVERTICES vertices. The vertices are on the pixel grid,
+/// in pixels from the top left corner of the sprite, with y pointing down,
+/// so that they can be scaled to fit the sprite in the same way as the
+/// hand-made polygons.
+
+struct CHullRecord{
+  unsigned short m_nSprite; ///< Sprite type.
+  unsigned short m_nCount; ///< Number of vertices.
+  unsigned short m_nVertex[8][2]; ///< Vertices, x then y.
+}; //CHullRecord
+
+/// \brief Hull file.
+///
+/// A hull file holds the collision shapes of the sprites, each of which is
+/// one or more convex polygons. It is made from the alpha masks of the
+/// sprite images by the `HullBuilder` tool. It is a CHullHeader followed by
+/// an array of CHullRecord in native byte order, with the records of each
+/// sprite together. Like a level file, it is memory-mapped and its records
+/// are used in place.
+
+class CHullFile{
+  private:
+    CMappedFile m_cFile; ///< Memory-mapped hull file.
+    const CHullRecord* m_pRecord = nullptr; ///< Records in the mapped file.
+    UINT m_nCount = 0; ///< Number of records.
+    UINT m_nFirst[(UINT)eSprite::Size] = {0}; ///< First record of each sprite.
+    UINT m_nHulls[(UINT)eSprite::Size] = {0}; ///< Number of records of each sprite.
+
+  public:
+    static const UINT VERSION = 1; ///< Hull file version.
+    static const UINT MAXVERTICES = 8; ///< Most vertices in a hull, as in Box2D.
+
+    bool Load(const std::string& fname); ///< Load hull file.
+    void Unload(); ///< Unload hull file.
+
+    UINT GetCount() const; ///< Get number of records.
+    UINT GetHullCount(eSprite t) const; ///< Get number of hulls of a sprite.
+    const CHullRecord& GetHull(eSprite t, UINT i) const; ///< Get a hull of a sprite.
+
+    static bool Save(const std::string& fname,
+      const std::vector<CHullRecord>& records); ///< Save hull file.
+}; //CHullFile
+
+#endif //__L4RC_GAME_HULLFILE_H__
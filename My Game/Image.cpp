@@ -0,0 +1,781 @@
+/// \file Image.cpp
+/// \brief Code for the image class CImage.
+
+#include <algorithm>
+#include <array>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+
+#include "Image.h"
+
+static const short nLengthBase[] = { ///< Length base for symbols 257 to 285.
+  3, 4, 5, 6, 7, 8, 9, 10, 11, 13, 15, 17, 19, 23, 27, 31,
+  35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258};
+static const short nLengthExtra[] = { ///< Extra length bits.
+  0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2,
+  3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0};
+static const int nDistBase[] = { ///< Distance base for symbols 0 to 29.
+  1, 2, 3, 4, 5, 7, 9, 13, 17, 25, 33, 49, 65, 97, 129, 193,
+  257, 385, 513, 769, 1025, 1537, 2049, 3073, 4097, 6145,
+  8193, 12289, 16385, 24577};
+static const short nDistExtra[] = { ///< Extra distance bits.
+  0, 0, 0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6, 6,
+  7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13};
+
+/// \brief Bit reader.
+///
+/// Reads a deflate stream a bit at a time, least significant bit first.
+/// Reading past the end gives zeros and sets the overrun flag, so that the
+/// decoder only has to check once at the end of each block.
+
+struct CBitReader{
+  const BYTE* m_pData = nullptr; ///< Data.
+  size_t m_nSize = 0; ///< Size of data in bytes.
+  size_t m_nPos = 0; ///< Position of next byte.
+  UINT m_nBits = 0; ///< Bits left over from the last byte.
+  UINT m_nCount = 0; ///< Number of bits left over.
+  bool m_bOverrun = false; ///< Whether we read past the end.
+
+  /// Read some bits.
+  /// \param n Number of bits, at most 16.
+  /// \return The bits.
+
+  UINT Read(UINT n){
+    while(m_nCount < n){
+      if(m_nPos < m_nSize)m_nBits |= (UINT)m_pData[m_nPos] << m_nCount;
+      else m_bOverrun = true;
+      m_nPos++;
+      m_nCount += 8;
+    } //while
+
+    const UINT b = m_nBits & ((1U << n) - 1); //the bits
+    m_nBits >>= n;
+    m_nCount -= n;
+    return b;
+  } //Read
+}; //CBitReader
+
+/// \brief Huffman code.
+///
+/// A canonical Huffman code as deflate uses it, held as the number of
+/// codes of each length and the symbols in order of their codes.
+
+struct CHuffman{
+  short m_nCount[16]; ///< Number of codes of each length.
+  short m_nSymbol[288]; ///< Symbols in code order.
+}; //CHuffman
+
+/// Make a canonical Huffman code from the code length of each symbol.
+/// \param h [out] Huffman code.
+/// \param len Code lengths, zero for symbols that are not used.
+/// \param n Number of symbols.
+/// \return true if the code lengths are not over-subscribed.
+
+static bool MakeHuffman(CHuffman& h, const BYTE* len, UINT n){
+  memset(h.m_nCount, 0, sizeof(h.m_nCount));
+
+  for(UINT i=0; i<n; i++)
+    h.m_nCount[len[i]]++;
+
+  int left = 1; //number of codes left
+
+  for(UINT i=1; i<16; i++){ //for each code length
+    left = 2*left - h.m_nCount[i];
+    if(left < 0)return false;
+  } //for
+
+  short offset[16] = {0}; //where the symbols of each length start
+
+  for(UINT i=1; i<15; i++)
+    offset[i + 1] = offset[i] + h.m_nCount[i];
+
+  for(UINT i=0; i<n; i++)
+    if(len[i] != 0)
+      h.m_nSymbol[offset[len[i]]++] = (short)i;
+
+  h.m_nCount[0] = 0;
+  return true;
+} //MakeHuffman
+
+/// Make the fixed literal and length Huffman code of deflate.
+/// \return Huffman code.
+
+static CHuffman MakeFixedLit(){
+  BYTE len[288]; //code lengths
+  memset(len, 8, 144);
+  memset(len + 144, 9, 112);
+  memset(len + 256, 7, 24);
+  memset(len + 280, 8, 8);
+
+  CHuffman h;
+  MakeHuffman(h, len, 288);
+  return h;
+} //MakeFixedLit
+
+/// Make the fixed distance Huffman code of deflate.
+/// \return Huffman code.
+
+static CHuffman MakeFixedDist(){
+  BYTE len[30]; //code lengths
+  memset(len, 5, 30);
+
+  CHuffman h;
+  MakeHuffman(h, len, 30);
+  return h;
+} //MakeFixedDist
+
+/// Decode a symbol.
+/// \param r Bit reader.
+/// \param h Huffman code.
+/// \return Symbol, or -1 if there is no such code.
+
+static int Decode(CBitReader& r, const CHuffman& h){
+  int code = 0; //code read so far
+  int first = 0; //first code of this length
+  int index = 0; //index of first code of this length in the symbol table
+
+  for(UINT len=1; len<16; len++){
+    code |= (int)r.Read(1);
+    const int count = h.m_nCount[len]; //number of codes of this length
+    if(code - count < first)return h.m_nSymbol[index + code - first];
+    index += count;
+    first = (first + count) << 1;
+    code <<= 1;
+  } //for
+
+  return -1;
+} //Decode
+
+/// Inflate a block that was compressed with Huffman codes.
+/// \param r Bit reader.
+/// \param lit Literal and length code.
+/// \param dist Distance code.
+/// \param dest [in, out] Inflated data so far.
+/// \return true if the block was inflated.
+
+static bool InflateCodes(CBitReader& r, const CHuffman& lit, const CHuffman& dist,
+  std::vector<BYTE>& dest)
+{
+  while(!r.m_bOverrun){
+    const int symbol = Decode(r, lit);
+
+    if(symbol < 0)return false;
+    if(symbol == 256)return true; //end of block
+
+    if(symbol < 256) //literal
+      dest.push_back((BYTE)symbol);
+
+    else{ //length and distance
+      const int i = symbol - 257; //length symbol index
+      if(i >= 29)return false;
+      const size_t len = nLengthBase[i] + r.Read(nLengthExtra[i]);
+
+      const int d = Decode(r, dist); //distance symbol
+      if(d < 0 || d >= 30)return false;
+      const size_t back = nDistBase[d] + r.Read(nDistExtra[d]);
+      if(back > dest.size())return false;
+
+      const size_t start = dest.size() - back; //start of copy
+
+      for(size_t j=0; j<len; j++) //copy a byte at a time, since they may overlap
+        dest.push_back(dest[start + j]);
+    } //else
+  } //while
+
+  return false;
+} //InflateCodes
+
+/// Inflate a zlib stream, as found in the IDAT chunks of a PNG file. The
+/// Adler-32 checksum at the end is not checked, since the PNG chunks have
+/// their own checksums.
+/// \param src Zlib stream.
+/// \param n Size of zlib stream in bytes.
+/// \param dest [out] Inflated data.
+/// \return true if the stream was inflated.
+
+bool CImage::Inflate(const BYTE* src, size_t n, std::vector<BYTE>& dest){
+  dest.clear();
+
+  if(n < 2 || (src[0] & 0x0F) != 8 || ((UINT)src[0] << 8 | src[1]) % 31 != 0 ||
+    (src[1] & 0x20) != 0) //not deflate, bad check bits, or preset dictionary
+    return false;
+
+  CBitReader r;
+  r.m_pData = src + 2;
+  r.m_nSize = n - 2;
+
+  bool bLast = false; //whether this is the last block
+
+  while(!bLast){
+    bLast = r.Read(1) == 1;
+    const UINT type = r.Read(2); //block type
+
+    if(type == 0){ //stored
+      r.m_nBits = r.m_nCount = 0; //skip to byte boundary
+      if(r.m_nPos + 4 > r.m_nSize)return false;
+
+      const BYTE* p = r.m_pData + r.m_nPos;
+      const UINT len = p[0] | p[1] << 8; //length
+      if((len ^ (p[2] | p[3] << 8)) != 0xFFFF)return false;
+
+      r.m_nPos += 4;
+      if(r.m_nPos + len > r.m_nSize)return false;
+
+      dest.insert(dest.end(), p + 4, p + 4 + len);
+      r.m_nPos += len;
+    } //if
+
+    else if(type == 1){ //fixed Huffman codes
+      static const CHuffman lit = MakeFixedLit(); //made once, thread-safe
+      static const CHuffman dist = MakeFixedDist(); //made once, thread-safe
+
+      if(!InflateCodes(r, lit, dist, dest))return false;
+    } //else if
+
+    else if(type == 2){ //dynamic Huffman codes
+      static const BYTE order[19] = { //order of code length code lengths
+        16, 17, 18, 0, 8, 7, 9, 6, 10, 5, 11, 4, 12, 3, 13, 2, 14, 1, 15};
+
+      const UINT nlen = r.Read(5) + 257; //number of length codes
+      const UINT ndist = r.Read(5) + 1; //number of distance codes
+      const UINT ncode = r.Read(4) + 4; //number of code length codes
+      if(nlen > 286 || ndist > 30)return false;
+
+      BYTE len[320] = {0}; //code lengths
+
+      for(UINT i=0; i<ncode; i++)
+        len[order[i]] = (BYTE)r.Read(3);
+
+      CHuffman lencode; //code length code
+      if(!MakeHuffman(lencode, len, 19))return false;
+
+      for(UINT i=0; i<nlen + ndist;){ //read code lengths
+        const int symbol = Decode(r, lencode);
+        if(symbol < 0 || r.m_bOverrun)return false;
+
+        if(symbol < 16)len[i++] = (BYTE)symbol;
+
+        else{ //repeat
+          BYTE value = 0; //length to repeat
+          UINT count = 0; //number of repeats
+
+          if(symbol == 16){
+            if(i == 0)return false;
+            value = len[i - 1];
+            count = 3 + r.Read(2);
+          } //if
+
+          else if(symbol == 17)count = 3 + r.Read(3);
+          else count = 11 + r.Read(7);
+
+          if(i + count > nlen + ndist)return false;
+          while(count-- > 0)len[i++] = value;
+        } //else
+      } //for
+
+      if(len[256] == 0)return false; //no end of block code
+
+      CHuffman lit, dist; //literal and length code, distance code
+      if(!MakeHuffman(lit, len, nlen) || !MakeHuffman(dist, len + nlen, ndist))
+        return false;
+
+      if(!InflateCodes(r, lit, dist, dest))return false;
+    } //else if
+
+    else return false; //bad block type
+
+    if(r.m_bOverrun)return false;
+  } //while
+
+  return true;
+} //Inflate
+
+/// \brief Bit writer.
+///
+/// Writes a deflate stream a bit at a time, least significant bit first.
+
+struct CBitWriter{
+  std::vector<BYTE>& m_stdData; ///< Data.
+  UINT m_nBits = 0; ///< Bits not yet written.
+  UINT m_nCount = 0; ///< Number of bits not yet written.
+
+  /// Construct a bit writer that appends to some data.
+  /// \param data [in, out] Data.
+
+  CBitWriter(std::vector<BYTE>& data): m_stdData(data){}
+
+  /// Write some bits.
+  /// \param b The bits.
+  /// \param n Number of bits, at most 24.
+
+  void Write(UINT b, UINT n){
+    m_nBits |= b << m_nCount;
+    m_nCount += n;
+
+    while(m_nCount >= 8){
+      m_stdData.push_back((BYTE)m_nBits);
+      m_nBits >>= 8;
+      m_nCount -= 8;
+    } //while
+  } //Write
+
+  /// Write a Huffman code, which goes most significant bit first.
+  /// \param code The code.
+  /// \param n Number of bits in the code.
+
+  void WriteCode(UINT code, UINT n){
+    UINT b = 0; //code reversed
+
+    for(UINT i=0; i<n; i++)
+      b |= ((code >> i) & 1) << (n - 1 - i);
+
+    Write(b, n);
+  } //WriteCode
+
+  /// Write the bits left over, padded with zeros to a byte boundary.
+
+  void Flush(){
+    if(m_nCount > 0)m_stdData.push_back((BYTE)m_nBits);
+    m_nBits = m_nCount = 0;
+  } //Flush
+}; //CBitWriter
+
+/// Write a literal or length symbol with the fixed Huffman code.
+/// \param w Bit writer.
+/// \param symbol Symbol, from 0 to 287.
+
+static void WriteFixed(CBitWriter& w, UINT symbol){
+  if(symbol < 144)w.WriteCode(0x30 + symbol, 8);
+  else if(symbol < 256)w.WriteCode(0x190 + symbol - 144, 9);
+  else if(symbol < 280)w.WriteCode(symbol - 256, 7);
+  else w.WriteCode(0xC0 + symbol - 280, 8);
+} //WriteFixed
+
+/// Deflate data into a zlib stream. It is one block with the fixed Huffman
+/// codes, with repeated strings found greedily using hash chains. That is
+/// not as small as zlib would make it, but sprite images have a lot of
+/// repeated pixels, and it is small and fast enough for the tools.
+/// \param src Data.
+/// \param n Size of data in bytes.
+/// \param dest [out] Zlib stream.
+
+void CImage::Deflate(const BYTE* src, size_t n, std::vector<BYTE>& dest){
+  const size_t WINDOW = 32768; //farthest distance back
+  const UINT HASHBITS = 15; //hash table size in bits
+  const UINT CHAIN = 64; //most places to try for each string
+
+  dest.assign({0x78, 0x9C}); //zlib header for deflate with the default window
+  CBitWriter w(dest);
+  w.Write(1, 1); //last block
+  w.Write(1, 2); //fixed Huffman codes
+
+  std::vector<int> head(1 << HASHBITS, -1); //most recent place for each hash
+  std::vector<int> prev(WINDOW, -1); //previous place with the same hash
+
+  auto Hash = [&](size_t i){ //hash of the 3 bytes at src[i]
+    return ((UINT)src[i] << 10 ^ (UINT)src[i + 1] << 5 ^ src[i + 2]) & ((1 << HASHBITS) - 1);
+  }; //Hash
+
+  auto Insert = [&](size_t i){ //remember the string at src[i]
+    if(i + 2 < n){
+      const UINT h = Hash(i);
+      prev[i%WINDOW] = head[h];
+      head[h] = (int)i;
+    } //if
+  }; //Insert
+
+  for(size_t i=0; i<n;){ //for each byte
+    size_t len = 0, back = 0; //longest match and how far back it is
+
+    if(i + 2 < n){
+      const size_t most = std::min<size_t>(258, n - i); //longest allowed match
+      int j = head[Hash(i)]; //place to try
+
+      for(UINT k=0; k<CHAIN && j >= 0 && i - j <= WINDOW - 1; k++){
+        size_t m = 0; //match length at j
+        while(m < most && src[j + m] == src[i + m])m++;
+
+        if(m > len){
+          len = m;
+          back = i - j;
+          if(m == most)break;
+        } //if
+
+        const int next = prev[j%WINDOW]; //next place to try
+        if(next >= j)break; //overwritten by a newer place
+        j = next;
+      } //for
+    } //if
+
+    if(len >= 3){ //length and distance
+      UINT s = 0; //length symbol index
+      while(s < 28 && nLengthBase[s + 1] <= (int)len)s++;
+      WriteFixed(w, 257 + s);
+      w.Write((UINT)len - nLengthBase[s], nLengthExtra[s]);
+
+      UINT d = 0; //distance symbol
+      while(d < 29 && nDistBase[d + 1] <= (int)back)d++;
+      w.WriteCode(d, 5);
+      w.Write((UINT)back - nDistBase[d], nDistExtra[d]);
+
+      for(size_t k=0; k<len; k++)
+        Insert(i++);
+    } //if
+
+    else{ //literal
+      WriteFixed(w, src[i]);
+      Insert(i++);
+    } //else
+  } //for
+
+  WriteFixed(w, 256); //end of block
+  w.Flush();
+
+  UINT a = 1, b = 0; //Adler-32 checksum
+
+  for(size_t i=0; i<n; i++){
+    a = (a + src[i])%65521;
+    b = (b + a)%65521;
+  } //for
+
+  const UINT adler = b << 16 | a;
+
+  for(int i=24; i>=0; i-=8)
+    dest.push_back((BYTE)(adler >> i));
+} //Deflate
+
+/// Read a 32-bit big-endian integer.
+/// \param p Pointer to the first byte.
+/// \return The integer.
+
+static UINT BigEndian(const BYTE* p){
+  return (UINT)p[0] << 24 | (UINT)p[1] << 16 | (UINT)p[2] << 8 | (UINT)p[3];
+} //BigEndian
+
+/// Paeth predictor from the PNG specification.
+/// \param a Byte to the left.
+/// \param b Byte above.
+/// \param c Byte above and to the left.
+/// \return Whichever of them is closest to a + b - c.
+
+static BYTE Paeth(BYTE a, BYTE b, BYTE c){
+  const int p = a + b - c; //initial estimate
+  const int pa = abs(p - a), pb = abs(p - b), pc = abs(p - c); //distances
+
+  if(pa <= pb && pa <= pc)return a;
+  if(pb <= pc)return b;
+  return c;
+} //Paeth
+
+/// Load an image from a PNG file and convert it to RGBA.
+/// \param fname File name.
+/// \return true if the image was loaded.
+
+bool CImage::LoadPNG(const std::string& fname){
+  m_nWidth = m_nHeight = 0;
+  m_stdPixel.clear();
+
+  std::ifstream file(fname, std::ios::binary);
+  if(!file)return false;
+
+  const std::vector<BYTE> data((std::istreambuf_iterator<char>(file)),
+    std::istreambuf_iterator<char>()); //contents of file
+
+  static const BYTE signature[8] = {137, 'P', 'N', 'G', 13, 10, 26, 10};
+  if(data.size() < 8 || memcmp(data.data(), signature, 8) != 0)return false;
+
+  UINT w = 0, h = 0; //width and height
+  BYTE depth = 0, color = 0, interlace = 0; //bit depth, color type, interlace method
+  std::vector<BYTE> palette; //RGBA palette
+  std::vector<BYTE> idat; //contents of IDAT chunks
+
+  for(size_t pos=8; pos + 12 <= data.size();){ //for each chunk
+    const UINT len = BigEndian(&data[pos]); //chunk length
+    const BYTE* tag = &data[pos + 4]; //chunk type
+    const BYTE* p = &data[pos + 8]; //chunk data
+    if(len > data.size() - pos - 12)return false;
+
+    if(memcmp(tag, "IHDR", 4) == 0 && len >= 13){
+      w = BigEndian(p);
+      h = BigEndian(p + 4);
+      depth = p[8];
+      color = p[9];
+      interlace = p[12];
+    } //if
+
+    else if(memcmp(tag, "PLTE", 4) == 0){
+      palette.clear();
+
+      for(UINT i=0; i+2<len; i+=3){ //for each palette entry
+        palette.insert(palette.end(), p + i, p + i + 3);
+        palette.push_back(255);
+      } //for
+    } //else if
+
+    else if(memcmp(tag, "tRNS", 4) == 0 && color == 3)
+      for(UINT i=0; i<len && 4*i+3<palette.size(); i++) //alpha for each palette entry
+        palette[4*i + 3] = p[i];
+
+    else if(memcmp(tag, "IDAT", 4) == 0)
+      idat.insert(idat.end(), p, p + len);
+
+    else if(memcmp(tag, "IEND", 4) == 0)
+      break;
+
+    pos += 12 + len;
+  } //for
+
+  static const UINT channels[] = {1, 0, 3, 1, 2, 0, 4}; //channels for each color type
+  if(w == 0 || h == 0 || depth != 8 || color > 6 || channels[color] == 0 ||
+    interlace != 0 || (color == 3 && palette.empty()))
+    return false;
+
+  std::vector<BYTE> raw; //filtered scanlines
+  if(!Inflate(idat.data(), idat.size(), raw))return false;
+
+  const UINT bpp = channels[color]; //bytes per pixel
+  const size_t stride = (size_t)w*bpp; //bytes per scanline
+  if(raw.size() < h*(stride + 1))return false;
+
+  //undo the filters, in place
+
+  for(UINT y=0; y<h; y++){ //for each scanline
+    BYTE* row = &raw[y*(stride + 1) + 1]; //this scanline
+    const BYTE* above = y > 0? row - stride - 1: nullptr; //scanline above
+    const BYTE filter = row[-1]; //filter type
+
+    for(size_t i=0; i<stride; i++){ //for each byte
+      const BYTE a = i >= bpp? row[i - bpp]: 0; //left
+      const BYTE b = above? above[i]: 0; //above
+      const BYTE c = above && i >= bpp? above[i - bpp]: 0; //above left
+
+      switch(filter){
+        case 0: break;
+        case 1: row[i] += a; break;
+        case 2: row[i] += b; break;
+        case 3: row[i] += (BYTE)((a + b)/2); break;
+        case 4: row[i] += Paeth(a, b, c); break;
+        default: return false;
+      } //switch
+    } //for
+  } //for
+
+  //convert to RGBA
+
+  m_stdPixel.resize((size_t)w*h*4);
+
+  for(UINT y=0; y<h; y++){ //for each scanline
+    const BYTE* src = &raw[y*(stride + 1) + 1]; //source pixels
+    BYTE* dest = &m_stdPixel[(size_t)y*w*4]; //destination pixels
+
+    for(UINT x=0; x<w; x++, src+=bpp, dest+=4) //for each pixel
+      switch(color){
+        case 0: dest[0] = dest[1] = dest[2] = src[0]; dest[3] = 255; break;
+        case 2: memcpy(dest, src, 3); dest[3] = 255; break;
+
+        case 3:
+          if(4*(size_t)src[0] + 4 > palette.size())return false;
+          memcpy(dest, &palette[4*(size_t)src[0]], 4);
+        break;
+
+        case 4: dest[0] = dest[1] = dest[2] = src[0]; dest[3] = src[1]; break;
+        case 6: memcpy(dest, src, 4); break;
+      } //switch
+  } //for
+
+  m_nWidth = w;
+  m_nHeight = h;
+
+  return true;
+} //LoadPNG
+
+/// Make the table of the CRC-32 of each byte.
+/// \return CRC table.
+
+static std::array<UINT, 256> MakeCRCTable(){
+  std::array<UINT, 256> table;
+
+  for(UINT i=0; i<256; i++){
+    UINT c = i;
+
+    for(UINT k=0; k<8; k++)
+      c = c & 1? 0xEDB88320U ^ (c >> 1): c >> 1;
+
+    table[i] = c;
+  } //for
+
+  return table;
+} //MakeCRCTable
+
+/// Compute the CRC-32 of some data, as used in PNG chunks.
+/// \param p Pointer to the data.
+/// \param n Size of the data in bytes.
+/// \return CRC-32.
+
+static UINT CRC32(const BYTE* p, size_t n){
+  static const std::array<UINT, 256> table = MakeCRCTable(); //made once, thread-safe
+
+  UINT c = 0xFFFFFFFFU;
+
+  for(size_t i=0; i<n; i++)
+    c = table[(c ^ p[i]) & 0xFF] ^ (c >> 8);
+
+  return c ^ 0xFFFFFFFFU;
+} //CRC32
+
+/// Append a 32-bit big-endian integer.
+/// \param v [in, out] Data to append to.
+/// \param n The integer.
+
+static void PutBigEndian(std::vector<BYTE>& v, UINT n){
+  for(int i=24; i>=0; i-=8)
+    v.push_back((BYTE)(n >> i));
+} //PutBigEndian
+
+/// Append a PNG chunk.
+/// \param v [in, out] Data to append to.
+/// \param tag Chunk type, 4 characters.
+/// \param data Chunk data.
+
+static void PutChunk(std::vector<BYTE>& v, const char* tag,
+  const std::vector<BYTE>& data)
+{
+  PutBigEndian(v, (UINT)data.size());
+  const size_t start = v.size(); //where the CRC starts
+  v.insert(v.end(), tag, tag + 4);
+  v.insert(v.end(), data.begin(), data.end());
+  PutBigEndian(v, CRC32(&v[start], v.size() - start));
+} //PutChunk
+
+/// Save the image to a PNG file with 8 bits per channel of RGBA. Each
+/// scanline is filtered with whichever filter makes the smallest sum of
+/// bytes taken as signed, which is the usual rule of thumb for finding the
+/// one that compresses best.
+/// \param fname File name.
+/// \return true if the file was written.
+
+bool CImage::SavePNG(const std::string& fname) const{
+  const size_t stride = (size_t)m_nWidth*4; //bytes per scanline
+  std::vector<BYTE> raw; //filtered scanlines
+  raw.reserve(m_nHeight*(stride + 1));
+
+  std::vector<BYTE> row[5]; //scanline with each filter
+
+  for(UINT y=0; y<m_nHeight; y++){ //for each scanline
+    const BYTE* cur = &m_stdPixel[y*stride]; //this scanline
+    const BYTE* above = y > 0? cur - stride: nullptr; //scanline above
+    UINT best = 0; //best filter
+    size_t bestsum = (size_t)-1; //its sum
+
+    for(UINT f=0; f<5; f++){ //for each filter
+      row[f].resize(stride);
+      size_t sum = 0; //sum of bytes taken as signed
+
+      for(size_t i=0; i<stride; i++){ //for each byte
+        const BYTE a = i >= 4? cur[i - 4]: 0; //left
+        const BYTE b = above? above[i]: 0; //above
+        const BYTE c = above && i >= 4? above[i - 4]: 0; //above left
+        BYTE d = cur[i]; //filtered byte
+
+        switch(f){
+          case 1: d -= a; break;
+          case 2: d -= b; break;
+          case 3: d -= (BYTE)((a + b)/2); break;
+          case 4: d -= Paeth(a, b, c); break;
+        } //switch
+
+        row[f][i] = d;
+        sum += d < 128? d: 256 - d;
+      } //for
+
+      if(sum < bestsum){
+        best = f;
+        bestsum = sum;
+      } //if
+    } //for
+
+    raw.push_back((BYTE)best);
+    raw.insert(raw.end(), row[best].begin(), row[best].end());
+  } //for
+
+  std::vector<BYTE> header; //IHDR chunk data
+  PutBigEndian(header, m_nWidth);
+  PutBigEndian(header, m_nHeight);
+  header.insert(header.end(), {8, 6, 0, 0, 0}); //depth, RGBA, compression, filter, interlace
+
+  std::vector<BYTE> idat; //IDAT chunk data
+  Deflate(raw.data(), raw.size(), idat);
+
+  std::vector<BYTE> data = {137, 'P', 'N', 'G', 13, 10, 26, 10}; //contents of file
+  PutChunk(data, "IHDR", header);
+  PutChunk(data, "IDAT", idat);
+  PutChunk(data, "IEND", std::vector<BYTE>());
+
+  std::ofstream file(fname, std::ios::binary);
+  file.write((const char*)data.data(), data.size());
+
+  return (bool)file;
+} //SavePNG
+
+/// Make the image a given size, with every pixel transparent black.
+/// \param w Width in pixels.
+/// \param h Height in pixels.
+
+void CImage::Create(UINT w, UINT h){
+  m_nWidth = w;
+  m_nHeight = h;
+  m_stdPixel.assign((size_t)w*h*4, 0);
+} //Create
+
+/// Copy another image into this one. It must fit.
+/// \param src Image to copy.
+/// \param x X coordinate of where its top left pixel goes.
+/// \param y Y coordinate of where its top left pixel goes.
+
+void CImage::Blit(const CImage& src, UINT x, UINT y){
+  for(UINT j=0; j<src.m_nHeight; j++) //for each scanline
+    memcpy(GetPixel(x, y + j), src.GetPixel(0, j), (size_t)src.m_nWidth*4);
+} //Blit
+
+/// Reader function for the width.
+/// \return Width in pixels.
+
+UINT CImage::GetWidth() const{
+  return m_nWidth;
+} //GetWidth
+
+/// Reader function for the height.
+/// \return Height in pixels.
+
+UINT CImage::GetHeight() const{
+  return m_nHeight;
+} //GetHeight
+
+/// Reader function for a pixel.
+/// \param x X coordinate, from the left.
+/// \param y Y coordinate, from the top.
+/// \return Pointer to the red, green, blue, and alpha of the pixel.
+
+const BYTE* CImage::GetPixel(UINT x, UINT y) const{
+  return &m_stdPixel[((size_t)y*m_nWidth + x)*4];
+} //GetPixel
+
+/// Writer function for a pixel.
+/// \param x X coordinate, from the left.
+/// \param y Y coordinate, from the top.
+/// \return Pointer to the red, green, blue, and alpha of the pixel.
+
+BYTE* CImage::GetPixel(UINT x, UINT y){
+  return &m_stdPixel[((size_t)y*m_nWidth + x)*4];
+} //GetPixel
+
+/// Reader function for the alpha of a pixel.
+/// \param x X coordinate, from the left.
+/// \param y Y coordinate, from the top.
+/// \return Alpha, from 0 for transparent to 255 for opaque.
+
+BYTE CImage::GetAlpha(UINT x, UINT y) const{
+  return m_stdPixel[((size_t)y*m_nWidth + x)*4 + 3];
+} //GetAlpha
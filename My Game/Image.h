@@ -0,0 +1,45 @@
+/// \file Image.h
+/// \brief Interface for the image class CImage.
+
+#ifndef __L4RC_GAME_IMAGE_H__
+#define __L4RC_GAME_IMAGE_H__
+
+#include <string>
+#include <vector>
+
+#include "GameDefines.h"
+
+/// \brief An image.
+///
+/// An image is an array of 8-bit RGBA pixels, one row after another from
+/// the top down. It can be loaded from a PNG file without the renderer, so
+/// that the tools can look at the sprites. Only what the sprites need is
+/// supported: 8 bits per channel, or a palette, with or without alpha, and
+/// no interlacing. Images can be saved to PNG files too, as RGBA, so that
+/// the tools can make new ones. The zlib streams in PNG files are inflated
+/// and deflated here, so nothing else is needed.
+
+class CImage{
+  private:
+    UINT m_nWidth = 0; ///< Width in pixels.
+    UINT m_nHeight = 0; ///< Height in pixels.
+    std::vector<BYTE> m_stdPixel; ///< RGBA pixels.
+
+  public:
+    bool LoadPNG(const std::string& fname); ///< Load a PNG file.
+    bool SavePNG(const std::string& fname) const; ///< Save a PNG file.
+
+    void Create(UINT w, UINT h); ///< Make a blank image.
+    void Blit(const CImage& src, UINT x, UINT y); ///< Copy an image into this one.
+
+    UINT GetWidth() const; ///< Get width.
+    UINT GetHeight() const; ///< Get height.
+    const BYTE* GetPixel(UINT x, UINT y) const; ///< Get a pixel.
+    BYTE* GetPixel(UINT x, UINT y); ///< Get a pixel to change.
+    BYTE GetAlpha(UINT x, UINT y) const; ///< Get the alpha of a pixel.
+
+    static bool Inflate(const BYTE* src, size_t n, std::vector<BYTE>& dest); ///< Inflate zlib stream.
+    static void Deflate(const BYTE* src, size_t n, std::vector<BYTE>& dest); ///< Deflate into zlib stream.
+}; //CImage
+
+#endif //__L4RC_GAME_IMAGE_H__
@@ -0,0 +1,303 @@
+/// \file ImpactParticles.cpp
+/// \brief Code for the impact particle system CImpactParticles.
+
+#include <algorithm>
+
+#include "ImpactParticles.h"
+
+#if defined(_M_X64) || defined(__SSE2__)
+  #define PARTICLES_SSE //use SSE to move particles
+  #include <xmmintrin.h>
+#endif
+
+/// \brief What particles of one kind are like when they are born.
+
+struct CParticleKind{
+  float m_fMinSpeed; ///< Least speed in renderer units per second.
+  float m_fMaxSpeed; ///< Greatest speed in renderer units per second.
+  float m_fMinLife; ///< Shortest life in seconds.
+  float m_fMaxLife; ///< Longest life in seconds.
+  float m_fGravity; ///< Downwards acceleration, per second squared.
+  float m_fDrag; ///< Fraction of velocity lost per second.
+}; //CParticleKind
+
+/// Particle kinds, in the order of eParticle.
+
+static const CParticleKind pKind[] = {
+  {150.0f, 450.0f, 0.25f, 0.6f, 900.0f, 1.5f}, //spark
+  { 20.0f,  80.0f, 0.6f,  1.2f, -40.0f, 3.0f}, //dust
+}; //pKind
+
+/// Impulse, in Physics World units, that it takes to make one spark.
+
+static const float fImpulsePerSpark = 40.0f;
+
+/// Impulse, in Physics World units, that it takes to make one puff of dust.
+
+static const float fImpulsePerDust = 100.0f;
+
+/// Most sparks made by one collision.
+
+static const UINT nMaxSparks = 24;
+
+/// Most puffs of dust made by one collision.
+
+static const UINT nMaxDust = 12;
+
+/// Allocate the arrays for a particle budget. This is the only allocation
+/// the particle system ever makes.
+/// \param capacity Particle budget, rounded up to a multiple of four.
+
+CImpactParticles::CImpactParticles(UINT capacity):
+  m_nCapacity((capacity + 3) & ~3U)
+{
+  m_stdData.resize(8*(size_t)m_nCapacity, 0.0f);
+  m_stdKind.resize(m_nCapacity, eParticle::Spark);
+
+  float* p = m_stdData.data(); //next array
+  m_pX = p; p += m_nCapacity;
+  m_pY = p; p += m_nCapacity;
+  m_pVelX = p; p += m_nCapacity;
+  m_pVelY = p; p += m_nCapacity;
+  m_pLife = p; p += m_nCapacity;
+  m_pFade = p; p += m_nCapacity;
+  m_pGravity = p; p += m_nCapacity;
+  m_pDrag = p;
+} //constructor
+
+/// Get a random number in a range.
+/// \param a Bottom of range.
+/// \param b Top of range.
+/// \return Random number from a to b.
+
+float CImpactParticles::Random(float a, float b){
+  return std::uniform_real_distribution<float>(a, b)(m_stdRandom);
+} //Random
+
+/// Add a particle, which must fit in the budget. It flies off from one
+/// side or the other of the contact, within 60 degrees of the normal.
+/// \param k Kind.
+/// \param pos Position in renderer coordinates.
+/// \param normal Unit contact normal.
+
+void CImpactParticles::Add(eParticle k, const Vector2& pos, const Vector2& normal){
+  const CParticleKind& kind = pKind[(UINT)k];
+  const float side = (m_stdRandom() & 1)? 1.0f: -1.0f; //which body it comes off
+  const float a = Random(-XM_PI/3.0f, XM_PI/3.0f); //angle from the normal
+  const float c = side*cosf(a); //along the normal
+  const float s = sinf(a); //along the tangent
+  const float v = Random(kind.m_fMinSpeed, kind.m_fMaxSpeed); //speed
+  const float life = Random(kind.m_fMinLife, kind.m_fMaxLife); //life in seconds
+
+  const UINT i = m_nCount++;
+
+  m_pX[i] = pos.x;
+  m_pY[i] = pos.y;
+  m_pVelX[i] = v*(c*normal.x - s*normal.y);
+  m_pVelY[i] = v*(c*normal.y + s*normal.x);
+  m_pLife[i] = life;
+  m_pFade[i] = 1.0f/life;
+  m_pGravity[i] = kind.m_fGravity;
+  m_pDrag[i] = kind.m_fDrag;
+  m_stdKind[i] = k;
+} //Add
+
+/// Remove a particle by moving the last live particle into its place.
+/// \param i Index of particle.
+
+void CImpactParticles::Remove(UINT i){
+  const UINT j = --m_nCount; //last live particle
+
+  m_pX[i] = m_pX[j];
+  m_pY[i] = m_pY[j];
+  m_pVelX[i] = m_pVelX[j];
+  m_pVelY[i] = m_pVelY[j];
+  m_pLife[i] = m_pLife[j];
+  m_pFade[i] = m_pFade[j];
+  m_pGravity[i] = m_pGravity[j];
+  m_pDrag[i] = m_pDrag[j];
+  m_stdKind[i] = m_stdKind[j];
+} //Remove
+
+/// Emit sparks and dust from a collision, as many as its impulse calls
+/// for, up to a limit for each collision. Particles that do not fit in
+/// the budget are dropped.
+/// \param pos Contact point in renderer coordinates.
+/// \param normal Unit contact normal.
+/// \param impulse Impulse of the collision in Physics World units.
+
+void CImpactParticles::Emit(const Vector2& pos, const Vector2& normal, float impulse){
+  const UINT nSparks = std::min(nMaxSparks, (UINT)(impulse/fImpulsePerSpark)); //number of sparks
+  const UINT nDust = std::min(nMaxDust, (UINT)(impulse/fImpulsePerDust)); //number of puffs of dust
+  const UINT n = nSparks + nDust; //number of particles
+  const UINT nRoom = std::min(n, m_nCapacity - m_nCount); //number that fit
+
+  for(UINT i=0; i<nRoom; i++)
+    Add(i < nSparks? eParticle::Spark: eParticle::Dust, pos, normal);
+
+  m_nEmitted += nRoom;
+  m_nDropped += n - nRoom;
+  m_nPeak = std::max(m_nPeak, m_nCount);
+} //Emit
+
+/// Move the particles along by one time step: age them, pull them down
+/// by their gravity, slow them down by their drag, and move them by their
+/// velocity. This is done four at a time using SSE, in groups of four
+/// from the start of the arrays, which are padded to a multiple of four
+/// so the last group can run past the live particles. The groups note
+/// whether any of their particles has died, and only from the first that
+/// has are the dead ones removed.
+/// \param t Time step in seconds.
+
+void CImpactParticles::Step(float t){
+  UINT nFirstDead = m_nCount; //start of first group with a dead particle
+
+#ifdef PARTICLES_SSE
+  const __m128 tt = _mm_set1_ps(t); //time step, four times
+  const __m128 zero = _mm_setzero_ps(); //zero, four times
+  const __m128 one = _mm_set1_ps(1.0f); //one, four times
+
+  for(UINT i=0; i<m_nCount; i+=4){ //for each group of four
+    const __m128 life = _mm_sub_ps(_mm_loadu_ps(m_pLife + i), tt); //remaining life
+    const __m128 k = _mm_max_ps(zero, _mm_sub_ps(one,
+      _mm_mul_ps(_mm_loadu_ps(m_pDrag + i), tt))); //fraction of velocity kept
+    const __m128 vx = _mm_mul_ps(_mm_loadu_ps(m_pVelX + i), k); //x velocity
+    const __m128 vy = _mm_mul_ps(_mm_sub_ps(_mm_loadu_ps(m_pVelY + i),
+      _mm_mul_ps(_mm_loadu_ps(m_pGravity + i), tt)), k); //y velocity
+
+    _mm_storeu_ps(m_pX + i, _mm_add_ps(_mm_loadu_ps(m_pX + i), _mm_mul_ps(vx, tt)));
+    _mm_storeu_ps(m_pY + i, _mm_add_ps(_mm_loadu_ps(m_pY + i), _mm_mul_ps(vy, tt)));
+    _mm_storeu_ps(m_pVelX + i, vx);
+    _mm_storeu_ps(m_pVelY + i, vy);
+    _mm_storeu_ps(m_pLife + i, life);
+
+    if(nFirstDead == m_nCount && _mm_movemask_ps(_mm_cmple_ps(life, zero)) != 0)
+      nFirstDead = i;
+  } //for
+#else
+  for(UINT i=0; i<m_nCount; i++){ //for each particle
+    const float k = std::max(0.0f, 1.0f - m_pDrag[i]*t); //fraction of velocity kept
+
+    m_pVelX[i] = m_pVelX[i]*k;
+    m_pVelY[i] = (m_pVelY[i] - m_pGravity[i]*t)*k;
+    m_pX[i] += m_pVelX[i]*t;
+    m_pY[i] += m_pVelY[i]*t;
+    m_pLife[i] -= t;
+
+    if(nFirstDead == m_nCount && m_pLife[i] <= 0.0f)
+      nFirstDead = i;
+  } //for
+#endif //PARTICLES_SSE
+
+  for(UINT i=nFirstDead; i<m_nCount;) //remove dead particles
+    if(m_pLife[i] <= 0.0f)Remove(i);
+    else i++;
+} //Step
+
+/// Remove all particles and reset the counts.
+
+void CImpactParticles::Clear(){
+  m_nCount = m_nEmitted = m_nDropped = m_nPeak = 0;
+} //Clear
+
+/// Reader function for the number of live particles.
+/// \return Number of live particles.
+
+UINT CImpactParticles::GetCount() const{
+  return m_nCount;
+} //GetCount
+
+/// Reader function for the particle budget.
+/// \return Most particles that can be live at once.
+
+UINT CImpactParticles::GetCapacity() const{
+  return m_nCapacity;
+} //GetCapacity
+
+/// Reader function for the number of particles emitted since the last
+/// call to Clear().
+/// \return Number of particles emitted.
+
+UINT CImpactParticles::GetEmitted() const{
+  return m_nEmitted;
+} //GetEmitted
+
+/// Reader function for the number of particles dropped because there was
+/// no room for them since the last call to Clear().
+/// \return Number of particles dropped.
+
+UINT CImpactParticles::GetDropped() const{
+  return m_nDropped;
+} //GetDropped
+
+/// Reader function for the most particles that have been live at once
+/// since the last call to Clear().
+/// \return Most particles live at once.
+
+UINT CImpactParticles::GetPeak() const{
+  return m_nPeak;
+} //GetPeak
+
+/// Reader function for the x coordinates.
+/// \return Pointer to the x coordinates of the live particles.
+
+const float* CImpactParticles::GetX() const{
+  return m_pX;
+} //GetX
+
+/// Reader function for the y coordinates.
+/// \return Pointer to the y coordinates of the live particles.
+
+const float* CImpactParticles::GetY() const{
+  return m_pY;
+} //GetY
+
+/// Reader function for the x velocities.
+/// \return Pointer to the x velocities of the live particles.
+
+const float* CImpactParticles::GetVelX() const{
+  return m_pVelX;
+} //GetVelX
+
+/// Reader function for the y velocities.
+/// \return Pointer to the y velocities of the live particles.
+
+const float* CImpactParticles::GetVelY() const{
+  return m_pVelY;
+} //GetVelY
+
+/// Reader function for the remaining lives.
+/// \return Pointer to the remaining lives of the live particles in seconds.
+
+const float* CImpactParticles::GetLife() const{
+  return m_pLife;
+} //GetLife
+
+/// Reader function for the reciprocals of the lives at birth, which
+/// multiplied by the remaining lives give how far a particle has faded.
+/// \return Pointer to the reciprocals of the lives at birth.
+
+const float* CImpactParticles::GetFade() const{
+  return m_pFade;
+} //GetFade
+
+/// Reader function for the gravities.
+/// \return Pointer to the downwards accelerations of the live particles.
+
+const float* CImpactParticles::GetGravity() const{
+  return m_pGravity;
+} //GetGravity
+
+/// Reader function for the drags.
+/// \return Pointer to the fractions of velocity the live particles lose per second.
+
+const float* CImpactParticles::GetDrag() const{
+  return m_pDrag;
+} //GetDrag
+
+/// Reader function for the kinds.
+/// \return Pointer to the kinds of the live particles.
+
+const eParticle* CImpactParticles::GetKind() const{
+  return m_stdKind.data();
+} //GetKind
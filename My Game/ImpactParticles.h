@@ -0,0 +1,86 @@
+/// \file ImpactParticles.h
+/// \brief Interface for the impact particle system CImpactParticles.
+
+#ifndef __L4RC_GAME_IMPACTPARTICLES_H__
+#define __L4RC_GAME_IMPACTPARTICLES_H__
+
+#include <random>
+#include <vector>
+
+#include "GameDefines.h"
+
+/// \brief Impact particle kind enumerated type.
+///
+/// Sparks fly off fast and fall, dust drifts slowly and rises a little.
+
+enum class eParticle: BYTE{
+  Spark, Dust
+}; //eParticle
+
+/// \brief The impact particle system.
+///
+/// When things collide hard, the contact listener asks for sparks and dust
+/// at the contact point, as many as the impulse of the collision calls for.
+/// The particles are kept in structure-of-arrays form, one array for each
+/// of position, velocity, remaining life, and so on, so that Step() can
+/// move them four at a time using SSE. The arrays are allocated once, big
+/// enough for a fixed budget of particles, and never again, so a tower
+/// falling over with thousands of particles flying makes no allocations.
+/// Once the budget is used up, new particles are dropped and counted. Dead
+/// particles are replaced by the last live one, so the live particles are
+/// always the first GetCount() of each array. Positions and velocities are
+/// in renderer coordinates. The arrays point into storage that the particle
+/// system owns, so it must not be copied.
+
+class CImpactParticles{
+  private:
+    UINT m_nCapacity = 0; ///< Particle budget, a multiple of four.
+    UINT m_nCount = 0; ///< Number of live particles.
+
+    std::vector<float> m_stdData; ///< Storage for all of the float arrays.
+    float* m_pX = nullptr; ///< X coordinates.
+    float* m_pY = nullptr; ///< Y coordinates.
+    float* m_pVelX = nullptr; ///< X velocities, per second.
+    float* m_pVelY = nullptr; ///< Y velocities, per second.
+    float* m_pLife = nullptr; ///< Remaining life in seconds.
+    float* m_pFade = nullptr; ///< Reciprocal of life at birth.
+    float* m_pGravity = nullptr; ///< Downwards acceleration, per second squared.
+    float* m_pDrag = nullptr; ///< Fraction of velocity lost per second.
+    std::vector<eParticle> m_stdKind; ///< Kinds.
+
+    std::minstd_rand m_stdRandom; ///< Random number generator.
+    UINT m_nEmitted = 0; ///< Number of particles emitted.
+    UINT m_nDropped = 0; ///< Number of particles dropped for lack of room.
+    UINT m_nPeak = 0; ///< Most particles live at once.
+
+    float Random(float a, float b); ///< Random number in a range.
+    void Add(eParticle k, const Vector2& pos, const Vector2& normal); ///< Add a particle.
+    void Remove(UINT i); ///< Remove a particle.
+
+  public:
+    CImpactParticles(UINT capacity=8192); ///< Constructor.
+    CImpactParticles(const CImpactParticles&) = delete; ///< No copy constructor.
+    CImpactParticles& operator=(const CImpactParticles&) = delete; ///< No assignment.
+
+    void Emit(const Vector2& pos, const Vector2& normal, float impulse); ///< Emit particles.
+    void Step(float t); ///< Move particles along by one time step.
+    void Clear(); ///< Remove all particles.
+
+    UINT GetCount() const; ///< Get number of live particles.
+    UINT GetCapacity() const; ///< Get particle budget.
+    UINT GetEmitted() const; ///< Get number of particles emitted.
+    UINT GetDropped() const; ///< Get number of particles dropped.
+    UINT GetPeak() const; ///< Get most particles live at once.
+
+    const float* GetX() const; ///< Get x coordinates.
+    const float* GetY() const; ///< Get y coordinates.
+    const float* GetVelX() const; ///< Get x velocities.
+    const float* GetVelY() const; ///< Get y velocities.
+    const float* GetLife() const; ///< Get remaining lives.
+    const float* GetFade() const; ///< Get reciprocals of lives at birth.
+    const float* GetGravity() const; ///< Get gravities.
+    const float* GetDrag() const; ///< Get drags.
+    const eParticle* GetKind() const; ///< Get kinds.
+}; //CImpactParticles
+
+#endif //__L4RC_GAME_IMPACTPARTICLES_H__
@@ -0,0 +1,151 @@
+/// \file Level.cpp
+/// \brief Code for the level file class CLevel.
+
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <vector>
+
+#include "Level.h"
+
+/// Map a binary level file into memory and check that its header and size
+/// are sensible. Any level that was already loaded is unloaded first.
+/// \param fname Level file name.
+/// \return true if the level file was loaded.
+
+bool CLevel::Load(const std::string& fname){
+  Unload();
+
+  if(!m_cFile.Open(fname))return false;
+
+  const size_t size = m_cFile.GetSize();
+  if(size < sizeof(CLevelHeader))return false;
+
+  const CLevelHeader* pHeader = (const CLevelHeader*)m_cFile.GetData();
+
+  if(memcmp(pHeader->m_pMagic, "RGML", 4) != 0 || pHeader->m_nVersion != VERSION ||
+    size != sizeof(CLevelHeader) + pHeader->m_nCount*sizeof(CLevelRecord))
+  {
+    m_cFile.Close();
+    return false;
+  } //if
+
+  m_pRecord = (const CLevelRecord*)(pHeader + 1);
+  m_nCount = pHeader->m_nCount;
+
+  for(UINT i=0; i<m_nCount; i++) //check sprite types
+    if(m_pRecord[i].m_nSprite >= (UINT)eSprite::Size){
+      Unload();
+      return false;
+    } //if
+
+  return true;
+} //Load
+
+/// Unmap the level file, or remove the records that were added in memory.
+
+void CLevel::Unload(){
+  m_cFile.Close();
+  m_stdRecord.clear();
+  m_pRecord = nullptr;
+  m_nCount = 0;
+} //Unload
+
+/// Add a record to the end of a level made in memory. If a level file is
+/// loaded, it is unloaded first.
+/// \param r Level record.
+
+void CLevel::Add(const CLevelRecord& r){
+  if(m_stdRecord.empty())Unload();
+
+  m_stdRecord.push_back(r);
+  m_pRecord = m_stdRecord.data();
+  m_nCount = (UINT)m_stdRecord.size();
+} //Add
+
+/// Reader function for the number of records.
+/// \return Number of records, which is zero if no level is loaded.
+
+UINT CLevel::GetCount() const{
+  return m_nCount;
+} //GetCount
+
+/// Reader function for a record.
+/// \param i Record index, which must be less than GetCount().
+/// \return Reference to record.
+
+const CLevelRecord& CLevel::GetRecord(UINT i) const{
+  return m_pRecord[i];
+} //GetRecord
+
+/// Convert a level from text to binary. The text form has one part per
+/// line: the name of its sprite in `gamesettings.xml`, the x and y
+/// coordinates of its position in renderer units, and optionally its
+/// orientation in radians (default \f$2\pi\f$) and a part-specific
+/// parameter (default zero). Anything after a `#` is a comment.
+/// \param text Text level file name.
+/// \param bin Binary level file name.
+/// \param error [out] Error message if the conversion failed.
+/// \return true if the conversion succeeded.
+
+bool CLevel::Convert(const std::string& text, const std::string& bin,
+  std::string& error)
+{
+  std::ifstream input(text);
+
+  if(!input){
+    error = "cannot open " + text;
+    return false;
+  } //if
+
+  std::vector<CLevelRecord> records; //records read so far
+  std::string line; //current line
+  UINT nLine = 0; //line number
+
+  while(std::getline(input, line)){
+    nLine++;
+    line = line.substr(0, line.find('#')); //strip comment
+
+    std::istringstream stream(line);
+    std::string name; //sprite name
+    if(!(stream >> name))continue; //blank line
+
+    CLevelRecord r = {(UINT)eSprite::Size, 0.0f, 0.0f, XM_2PI, 0.0f};
+
+    for(UINT i=0; i<(UINT)eSprite::Size; i++) //look up sprite name
+      if(name == GetSpriteName((eSprite)i))
+        r.m_nSprite = i;
+
+    if(r.m_nSprite == (UINT)eSprite::Size){
+      error = text + "(" + std::to_string(nLine) + "): unknown part " + name;
+      return false;
+    } //if
+
+    if(!(stream >> r.m_fX >> r.m_fY)){
+      error = text + "(" + std::to_string(nLine) + "): missing position";
+      return false;
+    } //if
+
+    float a = 0.0f, param = 0.0f; //optional orientation and parameter
+
+    if(stream >> a){
+      r.m_fAngle = a;
+      if(stream >> param)r.m_fParam = param;
+    } //if
+
+    records.push_back(r);
+  } //while
+
+  const CLevelHeader header = {{'R', 'G', 'M', 'L'}, VERSION, (UINT)records.size()};
+  std::ofstream output(bin, std::ios::binary);
+
+  output.write((const char*)&header, sizeof(header));
+  output.write((const char*)records.data(), records.size()*sizeof(CLevelRecord));
+
+  if(!output){
+    error = "cannot write " + bin;
+    return false;
+  } //if
+
+  return true;
+} //Convert
@@ -0,0 +1,72 @@
+/// \file Level.h
+/// \brief Interface for the level file class CLevel.
+
+#ifndef __L4RC_GAME_LEVEL_H__
+#define __L4RC_GAME_LEVEL_H__
+
+#include <string>
+#include <vector>
+
+#include "GameDefines.h"
+#include "MappedFile.h"
+
+/// \brief Level file header.
+///
+/// The first thing in a binary level file.
+
+struct CLevelHeader{
+  char m_pMagic[4]; ///< Must be "RGML".
+  UINT m_nVersion; ///< Must be CLevel::VERSION.
+  UINT m_nCount; ///< Number of level records that follow.
+}; //CLevelHeader
+
+/// \brief Level file record.
+///
+/// A packed description of one part of the machine. The sprite type says
+/// what sort of part it is, for example eSprite::Ramp for a ramp,
+/// eSprite::Pulleywheel for a pulley, or eSprite::Block for a tower block.
+/// A record of type eSprite::Ball drops a ball, and one of type
+/// eSprite::Background sets the width and height of the world, which is
+/// otherwise the window. Positions are in renderer units.
+
+struct CLevelRecord{
+  UINT m_nSprite; ///< Sprite type.
+  float m_fX; ///< X coordinate of position.
+  float m_fY; ///< Y coordinate of position.
+  float m_fAngle; ///< Orientation in radians.
+  float m_fParam; ///< Part-specific parameter, zero for the default.
+}; //CLevelRecord
+
+/// \brief Level file.
+///
+/// A binary level file is a CLevelHeader followed by an array of
+/// CLevelRecord in native byte order. Loading it maps the file into memory
+/// and uses the records in place, so there is nothing to parse and nothing
+/// to copy. The file stays mapped until the level is unloaded, so the level
+/// can be rebuilt from the records on every reset. Binary level files are
+/// made from a readable text form by Convert(). A level can also be made
+/// in memory one record at a time with Add(), which is how generated
+/// levels are made.
+
+class CLevel{
+  private:
+    CMappedFile m_cFile; ///< Memory-mapped level file.
+    std::vector<CLevelRecord> m_stdRecord; ///< Records added in memory.
+    const CLevelRecord* m_pRecord = nullptr; ///< Records in the mapped file or in memory.
+    UINT m_nCount = 0; ///< Number of records.
+
+  public:
+    static const UINT VERSION = 1; ///< Level file version.
+
+    bool Load(const std::string& fname); ///< Load binary level file.
+    void Unload(); ///< Unload level file.
+    void Add(const CLevelRecord& r); ///< Add a record in memory.
+
+    UINT GetCount() const; ///< Get number of records.
+    const CLevelRecord& GetRecord(UINT i) const; ///< Get a record.
+
+    static bool Convert(const std::string& text, const std::string& bin,
+      std::string& error); ///< Convert text level file to binary.
+}; //CLevel
+
+#endif //__L4RC_GAME_LEVEL_H__
@@ -1,6 +1,4 @@
 #include "LineObject.h"
-#include "Renderer.h"
-#include "ComponentIncludes.h"
 
 // constructor
 CLineObject::CLineObject(
@@ -11,10 +9,12 @@ CLineObject::CLineObject(
     m_pBody1(b1), m_vAnchor1(d1), m_bRotates1(r1) {
 } //constructor
 
-/// Draw in Render World. This line goes from anchor 0 on 
-/// body 0 to anchor 1 on body 1 in Physics World.
+/// Get the ends of the line in Render World. This line goes from anchor 0
+/// on body 0 to anchor 1 on body 1 in Physics World.
+/// \param a0 [out] Anchor 0 position in Render World.
+/// \param a1 [out] Anchor 1 position in Render World.
 
-void CLineObject::draw() {
+void CLineObject::GetEndpoints(Vector2& a0, Vector2& a1) const {
     b2Vec2 d0 = m_vAnchor0; //offset to anchor 0 from body 0 center
     b2Vec2 d1 = m_vAnchor1; //offset to anchor 1 from body 1 center
 
@@ -24,8 +24,6 @@ void CLineObject::draw() {
     if (m_bRotates1) //if anchor 1 rotates with body 1
         d1 = b2Mul(b2Rot(m_pBody1->GetAngle()), d1); //rotate its offset
 
-    const Vector2 a0 = PW2RW(m_pBody0->GetPosition() + d0); //anchor 0 position in Render World
-    const Vector2 a1 = PW2RW(m_pBody1->GetPosition() + d1); //anchor 1 position in Render World
-
-    m_pRenderer->DrawLine(eSprite::Pulleyline, a0, a1); //now draw the line
-} //draw
\ No newline at end of file
+    a0 = PW2RW(m_pBody0->GetPosition() + d0); //anchor 0 position in Render World
+    a1 = PW2RW(m_pBody1->GetPosition() + d1); //anchor 1 position in Render World
+} //GetEndpoints
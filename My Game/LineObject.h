@@ -1,6 +1,5 @@
 #pragma once
 #include "Common.h"
-#include "Component.h"
 
 /// \brief A line in object manager.
 ///
@@ -9,11 +8,10 @@
 /// The line goes from an anchor on one body to an anchor on
 /// another body. AN anchor is just a vector offset from the
 /// center of the body in Physics World. The anchors may or 
-/// may not rotate with their associated bodies.
+/// may not rotate with their associated bodies. Line objects are kept
+/// by value in object manager's pool.
 
-class CLineObject :
-    public CCommon,
-    public LComponent
+class CLineObject
 {
 private:
     b2Body* m_pBody0 = nullptr; ///< Pointer to body0 in Physics World.
@@ -27,5 +25,5 @@ private:
 public:
     CLineObject(b2Body*, b2Vec2, bool, b2Body*, b2Vec2, bool); ///< Constructor.
 
-    void draw(); ///< Draw line.
+    void GetEndpoints(Vector2& a0, Vector2& a1) const; ///< Get ends of line.
 }; //CLineObject
\ No newline at end of file
@@ -0,0 +1,421 @@
+/// \file Machine.cpp
+/// \brief Code for the Rube Goldberg machine class CMachine.
+
+#include "Machine.h"
+
+#include "GameDefines.h"
+#include "ObjectManager.h"
+#include "Profiler.h"
+#include "Prototypes.h"
+#include "SpriteSizes.h"
+#include "VoicePool.h"
+#include "ImpactParticles.h"
+#include "ComponentIncludes.h"
+
+#include "Pulley.h"
+#include "LineObject.h"
+#include "Catapult.h"
+#include "Bird.h"
+#include "StressScene.h"
+
+/// \param c Simulation context.
+
+CMachine::CMachine(CContext& c):
+  CCommon(c),
+  m_cContactListener(c),
+  m_cSnapshot(c){
+} //constructor
+
+/// Delete object manager and Physics World, in that order
+/// because the objects in object manager delete their own
+/// Physics World bodies. Then delete the components,
+/// the shape prototypes, the voice pool, and the sprite size table.
+
+CMachine::~CMachine(){
+  delete m_pObjectManager;
+  delete m_pPhysicsWorld;
+
+  DeleteComponents();
+  delete m_pPrototypes;
+  delete m_pVoicePool;
+  delete m_pImpactParticles;
+  delete m_pSpriteSizes;
+} //destructor
+
+/// Create the sprite size table, shape prototype registry, voice pool,
+/// impact particle system, object manager, and Physics World, then put
+/// edges at the sides and bottom of the window. The voice pool has no
+/// voices until the caller loads them from `gamesettings.xml`.
+
+void CMachine::Initialize(){
+  m_pSpriteSizes = new CSpriteSizes; //filled in by the caller before Reset()
+  m_pPrototypes = new CPrototypes; //built from the sprite sizes in the first Reset()
+  m_pVoicePool = new CVoicePool; //filled in by the caller
+  m_pImpactParticles = new CImpactParticles; //the particle budget, allocated once
+
+  //set up object manager and Physics World
+  m_pObjectManager = new CObjectManager(m_cContext); //set up object manager
+  m_pPhysicsWorld = new b2World(RW2PW(0, -1000)); //set up Physics World with gravity
+  m_pObjectManager->CreateWorldEdges((float)m_nWinWidth, (float)m_nWinHeight); //create world edges at edges of window
+  m_pPhysicsWorld->SetContactListener(&m_cContactListener); //load up my contact listener
+} //Initialize
+
+/// Load a binary level file. The file stays mapped into memory so that
+/// the level can be rebuilt from it on every reset.
+/// \param fname Level file name.
+/// \return true if the level file was loaded.
+
+bool CMachine::LoadLevel(const std::string& fname){
+  m_cSnapshot.Clear(); //any snapshot is of the old level
+  return m_cLevel.Load(fname);
+} //LoadLevel
+
+/// Load a hull file, which has tighter collision shapes for the sprites
+/// than the hand-made ones. The shapes are built again from it on the next
+/// reset. If the hull file can't be loaded, the hand-made shapes are used.
+/// \param fname Hull file name.
+/// \return true if the hull file was loaded.
+
+bool CMachine::LoadHulls(const std::string& fname){
+  const bool bLoaded = m_cHulls.Load(fname);
+
+  m_pPrototypes->Clear();
+  m_cSnapshot.Clear(); //any snapshot has the old shapes
+  return bLoaded;
+} //LoadHulls
+
+/// Generate a stress level in place of the level file. The sprite size
+/// table must be filled in first, since the parts are laid out to fit
+/// their sprites. The same number of bodies and seed always give the
+/// same level.
+/// \param nBodies Number of bodies to aim for.
+/// \param seed Random number seed.
+
+void CMachine::GenerateLevel(UINT nBodies, UINT seed){
+  m_cSnapshot.Clear(); //any snapshot is of the old level
+  CStressScene(m_cContext).Generate(nBodies, seed, m_cLevel);
+} //GenerateLevel
+
+/// Set the reset mode, which says how Reset() gets the machine back to its
+/// initial conditions. The default is eResetMode::Restore.
+/// \param m Reset mode.
+
+void CMachine::SetResetMode(eResetMode m){
+  m_eResetMode = m;
+} //SetResetMode
+
+/// Set the tuning parameters. Since some of them are built into the
+/// fixtures, the snapshot is discarded so that the next reset builds
+/// the level again.
+/// \param t Tuning parameters.
+
+void CMachine::SetTuning(const CTuning& t){
+  m_cTuning = t;
+  m_cSnapshot.Clear();
+} //SetTuning
+
+/// Get the machine back to its initial conditions. In eResetMode::Restore,
+/// which is the default, this is done by restoring the snapshot taken
+/// the first time the level was built and resetting the components.
+/// Otherwise, or if there is no snapshot yet, any old objects are cleared
+/// out of object manager and the level is built again from scratch,
+/// after which a new snapshot is taken.
+
+void CMachine::Reset(){
+  if(m_eResetMode == eResetMode::Restore && m_cSnapshot.IsCaptured()){
+    m_cSnapshot.Restore();
+
+    for(CPulley* p: m_stdPulley)p->Reset();
+    for(CCatapult* p: m_stdCatapult)p->Reset();
+    for(CBird* p: m_stdBird)p->Reset();
+  } //if
+
+  else{
+    m_pObjectManager->clear(); //clear old objects
+    DeleteComponents();
+    CreateLevel();
+    m_cSnapshot.Capture();
+  } //else
+
+  m_cRecorder.End(); //in case the last run didn't finish
+  m_pVoicePool->Clear(); //sounds from the last run are stopped or forgotten
+  m_pImpactParticles->Clear();
+  m_eGameState = eGameState::Initial;
+} //Reset
+
+/// Delete the pulleys, catapults, and birds. Their bodies belong to
+/// object manager, which deletes them separately.
+
+void CMachine::DeleteComponents(){
+  for(CPulley* p: m_stdPulley)delete p;
+  for(CCatapult* p: m_stdCatapult)delete p;
+  for(CBird* p: m_stdBird)delete p;
+
+  m_stdPulley.clear();
+  m_stdCatapult.clear();
+  m_stdBird.clear();
+
+  m_pCatapult = nullptr;
+  m_pBird = nullptr;
+} //DeleteComponents
+
+/// Drop the ball in at the top right of the window to start the machine,
+/// and start the clock. If runs are being recorded, a new recording begins.
+
+void CMachine::Launch(){
+  CreateBall(RW2PW(m_nWinWidth - 35), RW2PW(m_nWinHeight));
+  m_eGameState = eGameState::Running;
+  m_fStartTime = m_fTime;
+
+  if(m_bRecording)
+    m_cRecorder.Begin();
+} //Launch
+
+/// Step the Physics World, respond to the contacts recorded during the
+/// step, then move the impact particles, the pulley ropes and wheels and,
+/// once the bird has hit it, the catapult. If a run is being recorded, the result is recorded,
+/// and the recording ends when the machine finishes. Each of these is
+/// timed by the profiler, and so are the phases of the physics step.
+/// \param t Time step in seconds.
+
+void CMachine::Step(float t){
+  m_fTime += t; //advance simulated time
+
+  {
+    CProfileScope scope("Physics");
+    const uint64_t start = CProfiler::Now(); //start of step
+    m_pPhysicsWorld->Step(t, 6, 2); //move all objects 
+    m_pPhysicsWorld->SetWarmStarting(true); //in case a restore turned it off
+
+    if(CProfiler::IsEnabled())
+      CProfiler::RecordPhysics(m_pPhysicsWorld->GetProfile(), start);
+  }
+
+  {
+    CProfileScope scope("Contacts");
+    m_cContactListener.ProcessEvents(); //respond to collisions
+  }
+
+  {
+    CProfileScope scope("Particles");
+    m_pImpactParticles->Step(t); //move sparks and dust
+  }
+
+  // move pulleys
+  if (!m_stdPulley.empty()) {
+      CProfileScope scope("Pulley");
+
+      for (CPulley* p : m_stdPulley)
+          p->move(t);
+  }
+
+  // move catapults
+  for (CCatapult* p : m_stdCatapult)
+      if (p->GetCollision()) {
+          CProfileScope scope("Catapult");
+          p->move(t);
+      }
+
+  if(m_cRecorder.IsRecording()){
+    CProfileScope scope("Record");
+    m_pObjectManager->GatherTransforms();
+    m_pObjectManager->GetLines(m_stdLineEnd);
+    m_cRecorder.Record(t, m_pObjectManager->GetTransforms(), m_stdLineEnd,
+      m_eGameState, GetClock());
+
+    if(m_eGameState == eGameState::Finished)
+      m_cRecorder.End();
+  } //if
+} //Step
+
+/// Get the time that the clock shows, which is zero before the machine
+/// starts and stops when it finishes.
+/// \return Time on the clock in seconds.
+
+float CMachine::GetClock() const{
+  switch(m_eGameState){
+    case eGameState::Running: return m_fTime - m_fStartTime;
+    case eGameState::Finished: return m_fTotalTime;
+    default: return 0.0f;
+  } //switch
+} //GetClock
+
+/// Set whether to record each run, from launch until the machine finishes
+/// or is reset. Only the last run is kept.
+/// \param b true to record runs.
+
+void CMachine::SetRecording(bool b){
+  m_bRecording = b;
+  if(!b)m_cRecorder.End();
+} //SetRecording
+
+/// Reader function for the replay of the last run that was recorded.
+/// \return Reference to the replay.
+
+const CReplay& CMachine::GetReplay() const{
+  return m_cRecorder.GetReplay();
+} //GetReplay
+
+/// Create the button (which is a pig) that signals the end of the Rube Goldberg machine.
+/// \param x X coordinate of button in Physics World units.
+/// \param y Y coordinate of button in Physics World units.
+
+void CMachine::CreateButton(float x, float y){
+  b2Body* p = m_pPrototypes->Create(m_pPhysicsWorld, eSprite::Pig, b2Vec2(x, y));
+  m_pObjectManager->CreateObject(eSprite::Pig, p);
+} //CreateButton
+
+/// Place a ball in Physics World and object manager.
+/// \param x Horizontal coordinate in Physics World units.
+/// \param y Vertical coordinate in Physics World units.
+
+void CMachine::CreateBall(float x, float y){
+  b2Body* p = m_pPrototypes->Create(m_pPhysicsWorld, eSprite::Ball, b2Vec2(x, y));
+  m_pObjectManager->CreateObject(eSprite::Ball, p);
+} //CreateBall
+
+// create platform
+void CMachine::CreatePlatform(float x, float y, float a) {
+    b2Body* pBody = m_pPrototypes->Create(m_pPhysicsWorld, eSprite::Platform, b2Vec2(RW2PW(x), RW2PW(y)), a);
+    m_pObjectManager->CreateObject(eSprite::Platform, pBody);
+}
+
+// create small platform
+void CMachine::CreateSmallPlatform(float x, float y, float a) {
+    b2Body* pBody = m_pPrototypes->Create(m_pPhysicsWorld, eSprite::Smallplatform, b2Vec2(RW2PW(x), RW2PW(y)), a);
+    m_pObjectManager->CreateObject(eSprite::Smallplatform, pBody);
+}
+
+// create ramp
+void CMachine::CreateRamp(float x, float y, float a) {
+    b2Body* pBody = m_pPrototypes->Create(m_pPhysicsWorld, eSprite::Ramp, b2Vec2(RW2PW(x), RW2PW(y)), a);
+    m_pObjectManager->CreateObject(eSprite::Ramp, pBody);
+} 
+
+// create bumper
+void CMachine::CreateBumper(float x, float y, float a)
+{
+    b2Body* pBody = m_pPrototypes->Create(m_pPhysicsWorld, eSprite::Bumper, b2Vec2(RW2PW(x), RW2PW(y)), a);
+    pBody->GetFixtureList()->SetRestitution(m_cTuning.m_fBumperRestitution); // tuned restitution
+    m_pObjectManager->CreateObject(eSprite::Bumper, pBody);
+}
+
+// create pins
+void CMachine::CreatePins(float x, float y, float a) {
+    b2Body* pBody = m_pPrototypes->Create(m_pPhysicsWorld, eSprite::Pin, b2Vec2(RW2PW(x), RW2PW(y)));
+    m_pObjectManager->CreateObject(eSprite::Pin, pBody);
+}
+
+// create heavy ball
+void CMachine::CreateHeavyBall(float x, float y, float d) {
+    b2Body* p = m_pPrototypes->Create(m_pPhysicsWorld, eSprite::Heavyball, b2Vec2(RW2PW(x), RW2PW(y)));
+
+    // custom density
+    if (d != m_pPrototypes->Get(eSprite::Heavyball).m_cFixture[0].density) {
+        p->GetFixtureList()->SetDensity(d);
+        p->ResetMassData();
+    }
+
+    m_pObjectManager->CreateObject(eSprite::Heavyball, p);
+}
+
+// create propeller
+void CMachine::CreatePropeller(float x, float y, float a) {
+    // pivot body definition
+    b2BodyDef bd2;
+    bd2.type = b2_staticBody;
+    bd2.position.Set(RW2PW(x), RW2PW(y));
+    bd2.angle = a;
+
+    // propeller has same dimensions as platform. Circle does not need collision
+    b2Body* bodyA = m_pPrototypes->Create(m_pPhysicsWorld, eSprite::Propeller, b2Vec2(RW2PW(x), RW2PW(y)), a);
+    m_pObjectManager->CreateObject(eSprite::Propeller, bodyA);
+    b2Body* bodyB = m_pPhysicsWorld->CreateBody(&bd2);
+    m_pObjectManager->AddBody(bodyB); // so that it is destroyed with the level
+
+    // revolute joint definition
+    b2RevoluteJointDef wd;
+    wd.Initialize(bodyB, bodyA, bodyA->GetPosition());
+    wd.motorSpeed = 0.0f;
+    wd.maxMotorTorque = 4000.0f;
+    wd.enableMotor = true;
+    wd.collideConnected = false;
+
+    // create revolute joint 
+    m_pPhysicsWorld->CreateJoint(&wd);
+}
+
+// create circle bumpers
+void CMachine::CreateCircleBumpers(float x, float y)
+{
+    b2Body* pBody = m_pPrototypes->Create(m_pPhysicsWorld, eSprite::Circlebumper, b2Vec2(RW2PW(x), RW2PW(y)));
+    m_pObjectManager->CreateObject(eSprite::Circlebumper, pBody);
+}
+
+// create tower of blocks and sticks
+void CMachine::CreateTower(float x, float y, eSprite e, float a)
+{
+    b2Body* pBody = m_pPrototypes->Create(m_pPhysicsWorld, e, b2Vec2(RW2PW(x), RW2PW(y)), a);
+    m_pObjectManager->CreateObject(e, pBody);
+}
+
+/// Create the parts of the machine described by the records of the level
+/// file, in the order that they appear in the file. The shape prototypes
+/// are built from the sprite sizes the first time. The world edges are
+/// at the edges of the window unless the level says otherwise. The first
+/// catapult and bird go into the simulation context. Each catapult launches
+/// the bird that is created in the same order as it is, so a level with
+/// several of them has several independent rigs.
+
+void CMachine::CreateLevel(){
+  if(!m_pPrototypes->IsBuilt())
+    m_pPrototypes->Build(*m_pSpriteSizes, &m_cHulls);
+
+  m_pObjectManager->CreateWorldEdges((float)m_nWinWidth, (float)m_nWinHeight);
+
+  for(UINT i=0; i<m_cLevel.GetCount(); i++){ //for each part
+    const CLevelRecord& r = m_cLevel.GetRecord(i);
+    const eSprite t = (eSprite)r.m_nSprite; //what sort of part it is
+    const float x = r.m_fX, y = r.m_fY, a = r.m_fAngle; //position and orientation
+
+    switch(t){
+      case eSprite::Background: m_pObjectManager->CreateWorldEdges(x, y); break;
+      case eSprite::Pig: CreateButton(RW2PW(x), RW2PW(y)); break;
+      case eSprite::Ball: CreateBall(RW2PW(x), RW2PW(y)); break;
+      case eSprite::Ramp: CreateRamp(x, y, a); break;
+      case eSprite::Bumper: CreateBumper(x, y, a); break;
+      case eSprite::Platform: CreatePlatform(x, y, a); break;
+      case eSprite::Smallplatform: CreateSmallPlatform(x, y, a); break;
+      case eSprite::Pin: CreatePins(x, y, a); break;
+      case eSprite::Propeller: CreatePropeller(x, y, a); break;
+      case eSprite::Circlebumper: CreateCircleBumpers(x, y); break;
+
+      case eSprite::Block:
+      case eSprite::Stick: CreateTower(x, y, t, a); break;
+
+      case eSprite::Heavyball:
+        if(r.m_fParam > 0.0f)CreateHeavyBall(x, y, r.m_fParam); //custom density
+        else CreateHeavyBall(x, y, m_cTuning.m_fHeavyBallDensity);
+      break;
+
+      case eSprite::Pulleywheel:
+        m_stdPulley.push_back(new CPulley(m_cContext, RW2PW(x), RW2PW(y), RW2PW(r.m_fParam))); // create pulley
+      break;
+
+      case eSprite::Bird: // create bird
+        m_stdBird.push_back(new CBird(m_cContext, x, y));
+        if(!m_pBird)m_pBird = m_stdBird.back();
+      break;
+
+      case eSprite::Catapult: // create catapult
+        m_stdCatapult.push_back(new CCatapult(m_cContext, RW2PW(x), RW2PW(y)));
+        if(!m_pCatapult)m_pCatapult = m_stdCatapult.back();
+      break;
+
+      default: break; //not a part
+    } //switch
+  } //for
+
+  for(size_t i=0; i<m_stdCatapult.size() && i<m_stdBird.size(); i++)
+    m_stdCatapult[i]->SetBird(m_stdBird[i]); //each catapult launches its own bird
+} //CreateLevel
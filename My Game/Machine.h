@@ -0,0 +1,92 @@
+/// \file Machine.h
+/// \brief Interface for the Rube Goldberg machine class CMachine.
+
+#ifndef __L4RC_GAME_MACHINE_H__
+#define __L4RC_GAME_MACHINE_H__
+
+#include "Component.h"
+#include "Common.h"
+#include "Settings.h"
+
+#include "ContactListener.h"
+#include "HullFile.h"
+#include "Level.h"
+#include "Replay.h"
+#include "Snapshot.h"
+
+class CPulley; //forward declaration
+
+/// \brief The Rube Goldberg machine.
+///
+/// The machine is the simulation part of the game: the Physics World, the
+/// objects in it, and the pulley, catapult, and bird components. There can
+/// be any number of each of those, and each catapult launches its own
+/// bird when a bird hits it. It doesn't
+/// need a renderer, so it can be run either by CGame in a window
+/// or by a command-line driver with no window at all.
+/// Each machine has its own simulation context, which it shares with its
+/// components, so that machines are independent of each other.
+/// The sprite size table must be filled in and the level loaded after
+/// Initialize() and before Reset() because the shapes of the objects are
+/// made to fit their sprites, and where they go is in the level file.
+/// The shapes are worked out once, the first time the level is built,
+/// and copied from the shape prototype registry after that. If a hull
+/// file is loaded first, the shapes are made from its hulls where it has
+/// them.
+/// Instead of loading a level file, a stress level of any size can be
+/// generated, to find out how the machine scales.
+
+class CMachine: 
+  public LComponent, //game components from the Engine
+  public LSettings, //game settings from gamesettings.xml, via the Engine
+  public CCommon{ //common parameters for this game
+
+  private: 
+    CMyListener m_cContactListener; ///< Contact listener.
+    CLevel m_cLevel; ///< Level file.
+    CHullFile m_cHulls; ///< Hull file.
+    CSnapshot m_cSnapshot; ///< Snapshot of the level just after it was built.
+    eResetMode m_eResetMode = eResetMode::Restore; ///< Reset mode.
+
+    CReplayRecorder m_cRecorder; ///< Replay recorder.
+    bool m_bRecording = false; ///< Whether to record runs.
+    std::vector<Vector2> m_stdLineEnd; ///< Line ends, for the recorder.
+
+    std::vector<CPulley*> m_stdPulley; ///< Pulleys.
+    std::vector<CCatapult*> m_stdCatapult; ///< Catapults.
+    std::vector<CBird*> m_stdBird; ///< Birds.
+
+    void CreateButton(float x, float y); ///< Create final button.
+    void CreateBall(float x, float y); ///< Create ball.
+    void CreateHeavyBall(float x, float y, float d); // create heavyball
+    void CreatePlatform(float x, float y, float a = XM_2PI); // create platform
+    void CreateSmallPlatform(float x, float y, float a = XM_2PI); // create small platform
+    void CreateRamp(float x, float y, float a = XM_2PI); // create ramp
+    void CreateBumper(float x, float y, float a = XM_2PI); // create bumper
+    void CreatePins(float x, float y, float a = XM_2PI); // create pins
+    void CreatePropeller(float x, float y, float a = XM_2PI); // create propeller
+    void CreateCircleBumpers(float x, float y); // create circle bumpers
+    void CreateTower(float x, float y, eSprite e, float a = XM_2PI); // create tower of blocks and sticks
+    void CreateLevel(); ///< Create level from level file.
+    void DeleteComponents(); ///< Delete pulleys, catapults, and birds.
+
+  public:
+    CMachine(CContext& c); ///< Constructor.
+    ~CMachine(); ///< Destructor.
+
+    void Initialize(); ///< Create the Physics World and object manager.
+    bool LoadLevel(const std::string& fname); ///< Load level file.
+    bool LoadHulls(const std::string& fname); ///< Load hull file.
+    void GenerateLevel(UINT nBodies, UINT seed); ///< Generate stress level.
+    void SetResetMode(eResetMode m); ///< Set reset mode.
+    void SetTuning(const CTuning& t); ///< Set tuning parameters.
+    void Reset(); ///< Reset to initial conditions.
+    void Launch(); ///< Launch the ball.
+    void Step(float t); ///< Move everything along by one time step.
+    float GetClock() const; ///< Get time on the clock.
+
+    void SetRecording(bool b); ///< Set whether to record runs.
+    const CReplay& GetReplay() const; ///< Get replay of the last run.
+}; //CMachine
+
+#endif //__L4RC_GAME_MACHINE_H__
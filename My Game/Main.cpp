@@ -11,7 +11,8 @@
 #endif
 
 static LWindow g_cWindow; ///< The window class.
-static CGame g_cGame; ///< The game class.
+static CContext g_cContext; ///< The simulation context.
+static CGame g_cGame(g_cContext); ///< The game class.
 
 /// \brief The main entry point for this application.  
 ///
@@ -0,0 +1,110 @@
+/// \file MappedFile.cpp
+/// \brief Code for the read-only memory-mapped file class CMappedFile.
+
+#include "MappedFile.h"
+
+#ifdef _WIN32
+  #include <windows.h>
+#else
+  #include <fcntl.h>
+  #include <unistd.h>
+  #include <sys/mman.h>
+  #include <sys/stat.h>
+#endif //_WIN32
+
+/// The destructor unmaps the file if it is still mapped.
+
+CMappedFile::~CMappedFile(){
+  Close();
+} //destructor
+
+/// Map a file into memory for reading. Any file that was already
+/// mapped is unmapped first. An empty file cannot be mapped.
+/// \param fname File name.
+/// \return true if the file was mapped.
+
+bool CMappedFile::Open(const std::string& fname){
+  Close();
+
+  #ifdef _WIN32
+    HANDLE hFile = CreateFileA(fname.c_str(), GENERIC_READ, FILE_SHARE_READ,
+      nullptr, OPEN_EXISTING, FILE_FLAG_RANDOM_ACCESS, nullptr);
+    if(hFile == INVALID_HANDLE_VALUE)return false;
+
+    LARGE_INTEGER size; //file size
+    HANDLE hMapping = nullptr; //file mapping
+
+    if(GetFileSizeEx(hFile, &size) && size.QuadPart > 0)
+      hMapping = CreateFileMappingA(hFile, nullptr, PAGE_READONLY, 0, 0, nullptr);
+
+    if(hMapping == nullptr){
+      CloseHandle(hFile);
+      return false;
+    } //if
+
+    m_pData = (const unsigned char*)MapViewOfFile(hMapping, FILE_MAP_READ, 0, 0, 0);
+
+    if(m_pData == nullptr){
+      CloseHandle(hMapping);
+      CloseHandle(hFile);
+      return false;
+    } //if
+
+    m_hFile = hFile;
+    m_hMapping = hMapping;
+    m_nSize = (size_t)size.QuadPart;
+
+  #else
+    const int fd = open(fname.c_str(), O_RDONLY);
+    if(fd < 0)return false;
+
+    struct stat info; //file information
+
+    if(fstat(fd, &info) != 0 || info.st_size <= 0){
+      close(fd);
+      return false;
+    } //if
+
+    void* p = mmap(nullptr, (size_t)info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd); //the mapping keeps its own reference to the file
+
+    if(p == MAP_FAILED)return false;
+
+    m_pData = (const unsigned char*)p;
+    m_nSize = (size_t)info.st_size;
+  #endif //_WIN32
+
+  return true;
+} //Open
+
+/// Unmap the file, if there is one.
+
+void CMappedFile::Close(){
+  if(m_pData == nullptr)return;
+
+  #ifdef _WIN32
+    UnmapViewOfFile(m_pData);
+    CloseHandle(m_hMapping);
+    CloseHandle(m_hFile);
+    m_hMapping = m_hFile = nullptr;
+  #else
+    munmap((void*)m_pData, m_nSize);
+  #endif //_WIN32
+
+  m_pData = nullptr;
+  m_nSize = 0;
+} //Close
+
+/// Reader function for the file contents.
+/// \return Pointer to the file contents, or nullptr if no file is mapped.
+
+const unsigned char* CMappedFile::GetData() const{
+  return m_pData;
+} //GetData
+
+/// Reader function for the file size.
+/// \return File size in bytes.
+
+size_t CMappedFile::GetSize() const{
+  return m_nSize;
+} //GetSize
@@ -0,0 +1,38 @@
+/// \file MappedFile.h
+/// \brief Interface for the read-only memory-mapped file class CMappedFile.
+
+#ifndef __L4RC_GAME_MAPPEDFILE_H__
+#define __L4RC_GAME_MAPPEDFILE_H__
+
+#include <string>
+
+/// \brief A read-only memory-mapped file.
+///
+/// Mapping a file into memory lets us read it in place without copying
+/// it into a buffer first. The operating system pages it in on demand
+/// and shares the pages between every process that maps the same file.
+
+class CMappedFile{
+  private:
+    const unsigned char* m_pData = nullptr; ///< Pointer to the mapped file contents.
+    size_t m_nSize = 0; ///< File size in bytes.
+
+    #ifdef _WIN32
+      void* m_hFile = nullptr; ///< File handle.
+      void* m_hMapping = nullptr; ///< File mapping handle.
+    #endif //_WIN32
+
+  public:
+    CMappedFile(){}; ///< Constructor.
+    CMappedFile(const CMappedFile&) = delete; ///< No copying.
+    CMappedFile& operator=(const CMappedFile&) = delete; ///< No copying.
+    ~CMappedFile(); ///< Destructor.
+
+    bool Open(const std::string& fname); ///< Map a file into memory.
+    void Close(); ///< Unmap the file.
+
+    const unsigned char* GetData() const; ///< Get pointer to file contents.
+    size_t GetSize() const; ///< Get file size.
+}; //CMappedFile
+
+#endif //__L4RC_GAME_MAPPEDFILE_H__
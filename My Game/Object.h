@@ -5,32 +5,29 @@
 #define __L4RC_GAME_OBJECT_H__
 
 #include "GameDefines.h"
-#include "Component.h"
-#include "Common.h"
-#include "SpriteDesc.h"
 
 /// \brief The game object.
 ///
 /// Game objects are responsible for remembering information about themselves,
 /// in particular, their representations in renderer and Physics World.
+/// They are small records kept by value in object manager's pool, which
+/// destroys their Physics World bodies when it destroys them.
 
-class CObject: 
-  public LComponent,
-  public LSpriteDesc2D,
-  public CCommon
-{ 
+class CObject{ 
   private:
     eSprite m_eSpriteType = eSprite::Size; ///< Sprite type.
-    b2Body* m_pBody; ///< Physics World body.
+    b2Body* m_pBody = nullptr; ///< Physics World body.
+    UINT m_nIndex = 0; ///< Index in object list and transform cache.
 
   public:
-    CObject(eSprite, b2Body*); ///< Constructor.
-    ~CObject(); ///< Destructor.
+    CObject(eSprite, b2Body*, UINT=0); ///< Constructor.
 
-    void draw(); ///< Draw object.
-    eSprite GetSpriteType(); ///< Get sprite type.
-    Vector2 GetPos(); ///< Get position in renderer coordinates.
-    float GetSpeed();  ///< Get speed in renderer units.
+    eSprite GetSpriteType() const; ///< Get sprite type.
+    b2Body* GetBody() const; ///< Get Physics World body.
+    UINT GetIndex() const; ///< Get index in object list.
+    Vector2 GetPos() const; ///< Get position in renderer coordinates.
+    float GetAngle() const; ///< Get orientation.
+    float GetSpeed() const;  ///< Get speed in renderer units.
 }; //CObject
 
 #endif //__L4RC_GAME_OBJECT_H__
@@ -3,14 +3,68 @@
 
 #include "ObjectManager.h"
 #include "ComponentIncludes.h"
-#include "Renderer.h"
+#ifndef HEADLESS //the headless build has no renderer
+  #include "Renderer.h"
+#endif //HEADLESS
+
+#include <algorithm>
+#include <cmath>
 
 #include "LineObject.h"
+#include "Replay.h"
+#include "SpriteSizes.h"
+
+static const float fCullMargin = 64.0f; ///< Margin around the viewport in renderer units.
+
+/// \brief Broadphase query for culling.
+///
+/// Collects the index of the object that each fixture found by a Physics
+/// World broadphase query belongs to. A body with several fixtures may be
+/// found more than once. Bodies with no object, such as the world edges,
+/// are left out.
+
+class CCullQuery: public b2QueryCallback{
+  private:
+    const CObjectManager* m_pObjectManager; ///< Object manager.
+    std::vector<UINT>& m_stdIndex; ///< Object indices found.
+
+  public:
+    CCullQuery(const CObjectManager* p, std::vector<UINT>& v); ///< Constructor.
+    bool ReportFixture(b2Fixture* f) override; ///< Report a fixture found.
+}; //CCullQuery
+
+/// \param p Pointer to object manager.
+/// \param v [out] Object indices found.
 
-CObjectManager::CObjectManager(){
+CCullQuery::CCullQuery(const CObjectManager* p, std::vector<UINT>& v):
+  m_pObjectManager(p), m_stdIndex(v){
 } //constructor
 
-/// The destructor clears the object list, which destructs
+/// Called by Physics World for each fixture whose bounding box overlaps
+/// the query box.
+/// \param f Pointer to fixture.
+/// \return true to go on to the next fixture.
+
+bool CCullQuery::ReportFixture(b2Fixture* f){
+  const CObject* p = m_pObjectManager->FindObject(f->GetBody());
+  if(p)m_stdIndex.push_back(p->GetIndex());
+  return true;
+} //ReportFixture
+
+/// Reserve enough space in the pools for a typical level, so that
+/// they rarely need to grow.
+/// \param c Simulation context.
+
+CObjectManager::CObjectManager(CContext& c):
+  CCommon(c)
+{
+  m_cObjectPool.Reserve(256);
+  m_cLinePool.Reserve(16);
+  m_stdList.reserve(256);
+  m_stdLineList.reserve(16);
+} //constructor
+
+/// The destructor clears the object list, which destroys
 /// all of the objects in it.
 
 CObjectManager::~CObjectManager(){
@@ -18,52 +72,314 @@ CObjectManager::~CObjectManager(){
 } //destructor
 
 /// Delete all of the entities managed by object manager. 
-/// This involves deleting all of the CObject instances pointed
-/// to by the object list, then clearing the object list itself.
+/// This involves destroying the Physics World body of each object,
+/// then emptying the pools and the lists, then destroying the bodies
+/// that have no object. The pools keep their slots for reuse.
 
 void CObjectManager::clear(){
-  for(auto const& p: m_stdList) //for each object
-    delete p; //delete object
-
-  m_stdList.clear(); //clear the object list
+  Truncate(0, 0);
+  m_stdRope.clear();
 
-  for (auto const& p : m_stdLineList) //for each line
-      delete p; //delete line
+  for(b2Body* p: m_stdBody) //for each body without an object
+    m_pPhysicsWorld->DestroyBody(p);
 
-  m_stdLineList.clear(); //clear the line list
+  m_stdBody.clear();
 } //clear
 
+/// Delete the objects and lines that were created after there were a given
+/// number of each, leaving the older ones in place. The newest are
+/// destroyed first, so that their pool slots are reused in the same
+/// order when objects are created again.
+/// \param nObjects Number of objects to keep.
+/// \param nLines Number of lines to keep.
+
+void CObjectManager::Truncate(size_t nObjects, size_t nLines){
+  while(m_stdList.size() > nObjects){ //for each newer object, newest first
+    const CHandle h = m_stdList.back();
+    const CObject* pObj = m_cObjectPool.Get(h);
+
+    if(pObj != nullptr)
+      m_pPhysicsWorld->DestroyBody(pObj->GetBody());
+
+    m_cObjectPool.Destroy(h);
+    m_stdList.pop_back();
+  } //while
+
+  m_cTransforms.Truncate(nObjects);
+
+  while(!m_stdBare.empty() && m_stdBare.back() >= nObjects)
+    m_stdBare.pop_back();
+
+  while(m_stdLineList.size() > nLines){ //for each newer line, newest first
+    m_cLinePool.Destroy(m_stdLineList.back());
+    m_stdLineList.pop_back();
+  } //while
+} //Truncate
+
+/// Reader function for the number of objects.
+/// \return Number of objects.
+
+size_t CObjectManager::GetObjectCount() const{
+  return m_stdList.size();
+} //GetObjectCount
+
+/// Reader function for the number of lines.
+/// \return Number of lines.
+
+size_t CObjectManager::GetLineCount() const{
+  return m_stdLineList.size();
+} //GetLineCount
+
+/// Gather the positions and orientations of all of the objects from
+/// Physics World into the transform cache, in renderer units.
+
+void CObjectManager::GatherTransforms(){
+  m_cTransforms.Gather();
+} //GatherTransforms
+
+/// Gather the positions and orientations of all of the objects, and the
+/// ends of all of the lines, as they are before a physics step, so that
+/// the draw pass can interpolate from them.
+
+void CObjectManager::GatherPreviousTransforms(){
+  m_cTransforms.GatherPrevious();
+  GetLines(m_stdPrevLineEnd);
+} //GatherPreviousTransforms
+
+/// Reader function for the transform cache. The transforms are those
+/// gathered by the last call to GatherTransforms().
+/// \return Reference to the transform cache.
+
+const CTransformCache& CObjectManager::GetTransforms() const{
+  return m_cTransforms;
+} //GetTransforms
+
+/// Get the ends of every line in renderer units, in the order that they
+/// are in the line list, followed by the segments of every rope in the
+/// order that they were added.
+/// \param v [out] Line ends, two per line.
+
+void CObjectManager::GetLines(std::vector<Vector2>& v) const{
+  v.resize(2*m_stdLineList.size());
+
+  for(size_t i=0; i<m_stdLineList.size(); i++) //for each line
+    m_cLinePool.Get(m_stdLineList[i])->GetEndpoints(v[2*i], v[2*i + 1]);
+
+  for(const CRope* p: m_stdRope) //for each rope
+    p->GetLines(v);
+} //GetLines
+
+/// Get the game objects ready to be drawn. Their transforms are gathered
+/// from Physics World into the transform cache first, and they are drawn
+/// from that. If the frame falls between two physics steps, the objects
+/// and lines are drawn part of the way from where they were before the
+/// last step to where they are now. Only the objects that moved since the
+/// last frame are interpolated. Outlines are built from the same
+/// transforms, so they stay with the sprites. This is all of the draw pass
+/// that doesn't need a renderer.
+/// \param alpha Fraction of the way from previous to current, from 0 to 1.
+
+void CObjectManager::PrepareFrame(float alpha){
+  GatherTransforms();
+  m_cTransforms.Interpolate(alpha);
+  GetLines(m_stdLineEnd);
+
+  if(alpha < 1.0f && m_stdPrevLineEnd.size() == m_stdLineEnd.size())
+    for(size_t i=0; i<m_stdLineEnd.size(); i++){ //for each line end
+      Vector2& v = m_stdLineEnd[i]; //current
+      const Vector2& u = m_stdPrevLineEnd[i]; //previous
+      v = Vector2(u.x + alpha*(v.x - u.x), u.y + alpha*(v.y - u.y));
+    } //for
+} //PrepareFrame
+
+/// Determine whether an object in a transform cache might be seen in the
+/// viewport found by the last call to Cull(), which it might be if its
+/// position is within half the diagonal of its sprite of the viewport.
+/// \param t Transforms.
+/// \param i Index of the object into the transform cache.
+/// \return true if the object might be seen.
+
+bool CObjectManager::InView(const CTransformCache& t, size_t i) const{
+  float w, h; //width and height of sprite
+  m_pSpriteSizes->GetSize(t.GetSprite(i), w, h);
+  const float r = 0.5f*sqrtf(w*w + h*h); //half diagonal
+  const float x = t.GetX()[i]; //position
+  const float y = t.GetY()[i];
+
+  return x + r >= m_vViewMin.x && x - r <= m_vViewMax.x &&
+    y + r >= m_vViewMin.y && y - r <= m_vViewMax.y;
+} //InView
+
+/// Find the objects that might be seen in a viewport by asking the Physics
+/// World broadphase which fixtures overlap it, with a margin added all
+/// round for objects drawn part of a step behind and sprites bigger than
+/// their fixtures. The broadphase cannot find an object whose body has no
+/// fixtures, such as a pulley wheel, so those are tested against the
+/// viewport from their positions instead. The objects found are sorted
+/// into drawing order. The work done grows with the number of objects
+/// found and the number of objects without fixtures, not with the number
+/// of objects.
+/// \param vMin Bottom left of the viewport in renderer coordinates.
+/// \param vMax Top right of the viewport in renderer coordinates.
+
+void CObjectManager::Cull(const Vector2& vMin, const Vector2& vMax){
+  m_vViewMin = Vector2(vMin.x - fCullMargin, vMin.y - fCullMargin);
+  m_vViewMax = Vector2(vMax.x + fCullMargin, vMax.y + fCullMargin);
+
+  b2AABB box; //query box in Physics World
+  box.lowerBound = RW2PW(m_vViewMin.x, m_vViewMin.y);
+  box.upperBound = RW2PW(m_vViewMax.x, m_vViewMax.y);
+
+  m_stdVisible.clear();
+  CCullQuery query(this, m_stdVisible);
+  m_pPhysicsWorld->QueryAABB(&query, box);
+
+  for(const UINT i: m_stdBare) //for each object without fixtures
+    if(InView(m_cTransforms, i))
+      m_stdVisible.push_back(i);
+
+  std::sort(m_stdVisible.begin(), m_stdVisible.end());
+  m_stdVisible.erase(std::unique(m_stdVisible.begin(), m_stdVisible.end()), m_stdVisible.end());
+} //Cull
+
+/// Find the objects in a transform cache that might be seen in a viewport,
+/// for when there is no Physics World to ask, as in a replay. An object
+/// might be seen if its position is within half the diagonal of its
+/// sprite of the viewport with the margin added all round. This looks at
+/// every object, but only at its position.
+/// \param t Transforms.
+/// \param vMin Bottom left of the viewport in renderer coordinates.
+/// \param vMax Top right of the viewport in renderer coordinates.
+
+void CObjectManager::Cull(const CTransformCache& t, const Vector2& vMin,
+  const Vector2& vMax)
+{
+  m_vViewMin = Vector2(vMin.x - fCullMargin, vMin.y - fCullMargin);
+  m_vViewMax = Vector2(vMax.x + fCullMargin, vMax.y + fCullMargin);
+  m_stdVisible.clear();
+
+  for(size_t i=0; i<t.GetSize(); i++) //for each object
+    if(InView(t, i))
+      m_stdVisible.push_back((UINT)i);
+} //Cull
+
+/// Reader function for the objects that might be seen, as found by the
+/// last call to Cull().
+/// \return Indices of the objects into the transform cache, in drawing order.
+
+const std::vector<UINT>& CObjectManager::GetVisible() const{
+  return m_stdVisible;
+} //GetVisible
+
+#ifndef HEADLESS
+
+/// Get the part of the world that the camera sees, which is the size of
+/// the window, centered on the camera.
+/// \param vMin [out] Bottom left in renderer coordinates.
+/// \param vMax [out] Top right in renderer coordinates.
+
+void CObjectManager::GetViewport(Vector2& vMin, Vector2& vMax) const{
+  const Vector3& pos = m_pRenderer->GetCameraPos(); //camera position
+  const float w2 = m_nWinWidth/2.0f; //half window width
+  const float h2 = m_nWinHeight/2.0f; //half window height
+
+  vMin = Vector2(pos.x - w2, pos.y - h2);
+  vMax = Vector2(pos.x + w2, pos.y + h2);
+} //GetViewport
+
 /// Draw the game objects using Painter's Algorithm.
-/// The background is drawn first, then the game
-/// objects are asked to draw themselves in the
-/// order that they are in the object list. That is,
-/// they are drawn from back to front.
+/// The background is drawn first, then the lines, then the game
+/// objects in the order that they are in the transform cache.
+/// That is, they are drawn from back to front. Outlines, if any, are
+/// drawn over all of the sprites in one batch. They need the Physics
+/// World bodies, so they can be turned off for transforms that have none.
+/// Only the objects found by the last call to Cull() are drawn, and only
+/// the lines whose bounding boxes overlap its viewport.
+/// \param t Transforms.
+/// \param lines Line ends, two per line.
+/// \param bOutlines Whether outlines can be drawn.
 
-void CObjectManager::draw(){  
-  if(m_eDrawMode == eDrawMode::Sprites || m_eDrawMode == eDrawMode::Both)
+void CObjectManager::DrawFrame(const CTransformCache& t,
+  const std::vector<Vector2>& lines, bool bOutlines)
+{  
+  const bool bLines = bOutlines &&
+    (m_eDrawMode == eDrawMode::Lines || m_eDrawMode == eDrawMode::Both);
+  const bool bSprites = !bLines || m_eDrawMode == eDrawMode::Both;
+
+  if(bSprites)
     m_pRenderer->Draw(eSprite::Background, m_vWinCenter); //draw background
 
-  for (auto const& p : m_stdLineList) //for each Pulleyline
-      if (p != nullptr)
-          p->draw();
+  for(size_t i=0; i+1<lines.size(); i+=2){ //for each Pulleyline
+    const Vector2& u = lines[i]; //one end
+    const Vector2& v = lines[i + 1]; //other end
+
+    if(std::max(u.x, v.x) >= m_vViewMin.x && std::min(u.x, v.x) <= m_vViewMax.x &&
+      std::max(u.y, v.y) >= m_vViewMin.y && std::min(u.y, v.y) <= m_vViewMax.y)
+      m_pRenderer->DrawLine(eSprite::Pulleyline, u, v);
+  } //for
+
+  const float* x = t.GetX(); //x coordinates
+  const float* y = t.GetY(); //y coordinates
+  const float* a = t.GetAngle(); //orientations
+
+  if(bSprites)
+    for(const UINT i: m_stdVisible) //for each object that might be seen
+      m_pRenderer->Draw(t.GetSprite(i), Vector2(x[i], y[i]), a[i]); //draw sprite
+
+  if(bLines)
+    m_pRenderer->Drawb2Bodies(eSprite::Line, t, m_stdVisible); //draw outlines
+} //DrawFrame
+
+/// Draw the game objects that the camera might see from the transforms and
+/// line ends made ready by PrepareFrame(). After they have been drawn, the
+/// transform cache starts a new list of the objects that moved for the
+/// next frame.
+/// \param alpha Fraction of the way from previous to current, from 0 to 1.
+
+void CObjectManager::draw(float alpha){
+  PrepareFrame(alpha);
 
-  for(auto const& p: m_stdList) //for each object
-      if (p != nullptr)
-        p->draw(); //draw it in renderer
+  Vector2 vMin, vMax; //viewport
+  GetViewport(vMin, vMax);
+  Cull(vMin, vMax);
 
-  
+  DrawFrame(m_cTransforms, m_stdLineEnd, true);
+  m_cTransforms.ClearMoved();
 } //draw
 
+/// Draw the current frame of a replay instead of the game objects.
+/// There is no Physics World to draw outlines from or to cull with, so
+/// sprites are drawn in every draw mode, and the objects that might be
+/// seen are found from their positions.
+/// \param p Replay player.
+
+void CObjectManager::draw(const CReplayPlayer& p){
+  Vector2 vMin, vMax; //viewport
+  GetViewport(vMin, vMax);
+  Cull(p.GetTransforms(), vMin, vMax);
+
+  DrawFrame(p.GetTransforms(), p.GetLines(), false);
+} //draw
+
+#endif //HEADLESS
+
 /// Create world edges in Physics World.
 /// Place Box2D edge shapes in the Physics World in places that correspond to the
-/// bottom, right, and left edges of the screen in renderer. The left and
-/// right edges continue upwards for a distance. There is no top to the world.
+/// bottom, right, and left edges of the world in renderer, which is usually
+/// the window. The left and right edges continue upwards for a distance.
+/// There is no top to the world. Any edges that were created before are
+/// destroyed first, so that a level can be bigger than the window.
+/// \param width World width in renderer units.
+/// \param height Height of the left and right edges in renderer units.
 
-void CObjectManager::CreateWorldEdges(){
-  const float w = RW2PW(m_nWinWidth); //window width in Physics World units
-  const float h = RW2PW(m_nWinHeight); //window height in Physics World units
+void CObjectManager::CreateWorldEdges(float width, float height){
+  if(m_pWorldEdges)
+    m_pPhysicsWorld->DestroyBody(m_pWorldEdges);
 
-  //corners of the window
+  const float w = RW2PW(width); //world width in Physics World units
+  const float h = RW2PW(height); //world height in Physics World units
+
+  //corners of the world
   const b2Vec2 vBLeft  = b2Vec2(0, 0); //bottom left
   const b2Vec2 vBRight = b2Vec2(w, 0); //bottom right
   const b2Vec2 vTLeft  = b2Vec2(0, h); //top left
@@ -72,39 +388,104 @@ void CObjectManager::CreateWorldEdges(){
   //Box2D ground
   b2BodyDef bd; //body definition
   b2Body* pBody = m_pPhysicsWorld->CreateBody(&bd); //body
+  m_pWorldEdges = pBody;
   b2EdgeShape shape; //shape
 
-  //bottom of window
+  //bottom of world
   shape.m_vertex1 = vBLeft;
   shape.m_vertex2 = vBRight;
   pBody->CreateFixture(&shape, 0);
 
-  //left edge of window
+  //left edge of world
   shape.m_vertex1 = vBLeft;
   shape.m_vertex2 = vTLeft;
   pBody->CreateFixture(&shape, 0);
 
-  //right edge of window
+  //right edge of world
   shape.m_vertex1 = vBRight;
   shape.m_vertex2 = vTRight;
   pBody->CreateFixture(&shape, 0);
 } //CreateWorldEdges
 
 /// Create an object in object manager and link its Physics World
-/// body to it.
+/// body to it by putting the object's handle into the body's user data.
+/// Each of the body's fixtures is tagged with the sprite type for the
+/// contact listener, so the fixtures must be created first. A body with
+/// no fixtures is noted so that culling can test it from its position.
+/// Object manager then has responsibility for destroying the body.
 /// \param t Sprite type.
 /// \param p Pointer to Box2D body.
+/// \return Handle to the new object.
+
+CHandle CObjectManager::CreateObject(eSprite t, b2Body* p){
+  const CHandle h = m_cObjectPool.Create(CObject(t, p, (UINT)m_stdList.size()));
+  m_stdList.push_back(h);
+  m_cTransforms.Add(t, p);
+  p->GetUserData().pointer = h.ToUserData();
+
+  if(p->GetFixtureList() == nullptr) //broadphase can't find it
+    m_stdBare.push_back((UINT)m_stdList.size() - 1);
 
-void CObjectManager::CreateObject(eSprite t, b2Body* p){
-  CObject* pObj = new CObject(t, p);
-  m_stdList.push_back(pObj);
-  p->GetUserData().pointer = (uintptr_t)pObj;
+  for(b2Fixture* f=p->GetFixtureList(); f; f=f->GetNext()) //for each fixture
+    f->GetUserData().pointer = GetFixtureTag(t); //tag it
+
+  return h;
 } //CreateObject
 
-CLineObject* CObjectManager::CreateLine(b2Body* b0, const b2Vec2& d0, bool r0,
+/// Get an object from its handle.
+/// \param h Handle.
+/// \return Pointer to the object, or nullptr if it has been deleted.
+
+const CObject* CObjectManager::FindObject(CHandle h) const{
+  return m_cObjectPool.Get(h);
+} //FindObject
+
+/// Get the object that a Physics World body belongs to from the handle
+/// in the body's user data.
+/// \param p Pointer to Box2D body.
+/// \return Pointer to the object, or nullptr if the body has no object
+///   or its object has been deleted.
+
+const CObject* CObjectManager::FindObject(b2Body* p) const{
+  if(p == nullptr)return nullptr;
+  const CHandle h = CHandle::FromUserData(p->GetUserData().pointer);
+  return m_cObjectPool.Get(h);
+} //FindObject
+
+/// Note that an object's body has been moved by something other than a
+/// physics step, so that its transform is gathered again. This must be
+/// done for a static body moved with SetTransform(), since the transforms
+/// of static bodies are otherwise gathered only once.
+/// \param h Handle.
+
+void CObjectManager::Touch(CHandle h){
+  const CObject* p = m_cObjectPool.Get(h);
+  if(p)m_cTransforms.Touch(p->GetIndex());
+} //Touch
+
+CHandle CObjectManager::CreateLine(b2Body* b0, const b2Vec2& d0, bool r0,
     b2Body* b1, const b2Vec2& d1, bool r1)
 {
-    CLineObject* p = new CLineObject(b0, d0, r0, b1, d1, r1);
-    m_stdLineList.push_back(p);
-    return p;
-} //CreateLine
\ No newline at end of file
+    const CHandle h = m_cLinePool.Create(CLineObject(b0, d0, r0, b1, d1, r1));
+    m_stdLineList.push_back(h);
+    return h;
+} //CreateLine
+
+/// Add a rope, which is drawn as lines, one for each of its segments,
+/// after the line objects. The rope belongs to whatever made it, and must
+/// last until clear() is called.
+/// \param p Pointer to the rope.
+
+void CObjectManager::AddRope(const CRope* p){
+  m_stdRope.push_back(p);
+} //AddRope
+
+/// Take over a Physics World body that has no object, such as a pivot that
+/// a joint holds in place, so that it is destroyed with the level by
+/// clear() instead of being left in Physics World when the level is
+/// built again.
+/// \param p Pointer to a Box2D body.
+
+void CObjectManager::AddBody(b2Body* p){
+  m_stdBody.push_back(p);
+} //AddBody
\ No newline at end of file
@@ -8,15 +8,28 @@
 
 #include "Object.h"
 #include "LineObject.h"
+#include "Rope.h"
+#include "Pool.h"
+#include "TransformCache.h"
 
 #include "Component.h"
 #include "Common.h"
 #include "Settings.h"
 
+class CReplayPlayer;
+
 /// \brief object manager.
 ///
 /// object manager is an abstract representation of all of
-/// the objects in the game.
+/// the objects in the game. Objects and lines are kept by value in pools
+/// and reached through handles. Each object's handle is kept in its
+/// Physics World body's user data. The order lists keep the handles in
+/// order of creation, which is the order in which they are drawn. Only the
+/// objects that the camera might see are drawn. They are found by asking
+/// the Physics World broadphase which fixtures overlap the viewport, so the
+/// cost of drawing grows with what is on the screen, not with the size of
+/// the machine. Objects whose bodies have no fixtures can't be found that
+/// way, so they are tested against the viewport one by one.
 
 class CObjectManager: 
   public LComponent, 
@@ -24,24 +37,62 @@ class CObjectManager:
   public CCommon 
 {
   private:
-    std::vector<CObject*> m_stdList; ///< Object list.
-    std::vector<CLineObject*> m_stdLineList; ///< Line list.
+    CPool<CObject> m_cObjectPool; ///< Object pool.
+    CPool<CLineObject> m_cLinePool; ///< Line pool.
+
+    std::vector<CHandle> m_stdList; ///< Object list, in order of creation.
+    std::vector<CHandle> m_stdLineList; ///< Line list, in order of creation.
+    std::vector<const CRope*> m_stdRope; ///< Ropes, drawn as lines.
+    std::vector<b2Body*> m_stdBody; ///< Bodies that have no object.
+    CTransformCache m_cTransforms; ///< Object transforms, parallel to the object list.
+    std::vector<Vector2> m_stdLineEnd; ///< Line ends, two per line.
+    std::vector<Vector2> m_stdPrevLineEnd; ///< Previous line ends, two per line.
+    b2Body* m_pWorldEdges = nullptr; ///< Body that the world edges are fixtures of.
+
+    std::vector<UINT> m_stdBare; ///< Indices of objects whose bodies have no fixtures.
+    std::vector<UINT> m_stdVisible; ///< Indices of objects that might be seen, in drawing order.
+    Vector2 m_vViewMin; ///< Bottom left of the viewport at the last cull, with margin.
+    Vector2 m_vViewMax; ///< Top right of the viewport at the last cull, with margin.
+
+    bool InView(const CTransformCache& t, size_t i) const; ///< Might an object be seen?
+    void GetViewport(Vector2& vMin, Vector2& vMax) const; ///< Get what the camera sees.
+    void DrawFrame(const CTransformCache& t, const std::vector<Vector2>& lines,
+      bool bOutlines); ///< Draw objects and lines.
 
   public:
-    CObjectManager(); ///< Constructor.
+    CObjectManager(CContext& c); ///< Constructor.
     ~CObjectManager(); ///< Destructor.
 
-    void CreateObject(eSprite t, b2Body* p); ///< Create object.
+    CHandle CreateObject(eSprite t, b2Body* p); ///< Create object.
+    const CObject* FindObject(CHandle h) const; ///< Get object from handle.
+    const CObject* FindObject(b2Body* p) const; ///< Get object from body.
+    void Touch(CHandle h); ///< Note that an object was moved by hand.
 
     void clear(); ///< Reset to initial conditions.
-    void draw(); ///< Draw all objects.
+    void Truncate(size_t nObjects, size_t nLines); ///< Delete newest objects and lines.
 
-    void CreateWorldEdges(); ///< Create the edges of the world.
+    size_t GetObjectCount() const; ///< Get number of objects.
+    size_t GetLineCount() const; ///< Get number of lines.
 
-    CLineObject* CreateLine(b2Body*, const b2Vec2&, bool, b2Body*,
-        const b2Vec2&, bool); ///< Create new line object.
+    void GatherTransforms(); ///< Gather object transforms from Physics World.
+    void GatherPreviousTransforms(); ///< Gather transforms to interpolate from.
+    const CTransformCache& GetTransforms() const; ///< Get object transforms.
+    void GetLines(std::vector<Vector2>& v) const; ///< Get line ends.
+
+    void PrepareFrame(float alpha); ///< Get objects ready to draw.
+    void Cull(const Vector2& vMin, const Vector2& vMax); ///< Find objects that might be seen.
+    void Cull(const CTransformCache& t, const Vector2& vMin,
+      const Vector2& vMax); ///< Find objects in a transform cache that might be seen.
+    const std::vector<UINT>& GetVisible() const; ///< Get objects that might be seen.
+    void draw(float alpha=1.0f); ///< Draw all objects.
+    void draw(const CReplayPlayer& p); ///< Draw a replay frame.
 
-    
+    void CreateWorldEdges(float w, float h); ///< Create the edges of the world.
+
+    CHandle CreateLine(b2Body*, const b2Vec2&, bool, b2Body*,
+        const b2Vec2&, bool); ///< Create new line object.
+    void AddRope(const CRope* p); ///< Add a rope to draw as lines.
+    void AddBody(b2Body* p); ///< Take over a body that has no object.
 }; //CObjectManager
 
 #endif //__L4RC_GAME_OBJECTMANAGER_H__
\ No newline at end of file
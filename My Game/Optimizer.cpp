@@ -0,0 +1,331 @@
+/// \file Optimizer.cpp
+/// \brief Code for the parameter optimizer COptimizer.
+
+#include <algorithm>
+#include <atomic>
+#include <thread>
+
+#include "Optimizer.h"
+#include "Machine.h"
+#include "SpriteSizes.h"
+#include "ComponentIncludes.h"
+
+/// Tuning parameters, in the order that they are in a candidate.
+
+const CParam CCandidate::m_cParam[PARAMS] = {
+  {"heavy ball density", 1.0f, 40.0f},
+  {"bird impulse x", -1800.0f, -200.0f},
+  {"bird impulse y", 200.0f, 1800.0f},
+  {"catapult speed", 0.5f, 12.0f},
+  {"bumper restitution", 0.2f, 3.0f},
+}; //m_cParam
+
+/// Get the tuning parameters that this candidate's values stand for.
+/// \return Tuning parameters.
+
+CTuning CCandidate::GetTuning() const{
+  CTuning t;
+  t.m_fHeavyBallDensity = m_fValue[0];
+  t.m_vBirdImpulse = b2Vec2(m_fValue[1], m_fValue[2]);
+  t.m_fCatapultSpeed = m_fValue[3];
+  t.m_fBumperRestitution = m_fValue[4];
+  return t;
+} //GetTuning
+
+/// Set this candidate's values from tuning parameters.
+/// \param t Tuning parameters.
+
+void CCandidate::SetTuning(const CTuning& t){
+  m_fValue[0] = t.m_fHeavyBallDensity;
+  m_fValue[1] = t.m_vBirdImpulse.x;
+  m_fValue[2] = t.m_vBirdImpulse.y;
+  m_fValue[3] = t.m_fCatapultSpeed;
+  m_fValue[4] = t.m_fBumperRestitution;
+} //SetTuning
+
+/// Clamp each value to the range of its parameter.
+
+void CCandidate::Clamp(){
+  for(UINT i=0; i<PARAMS; i++) //for each parameter
+    m_fValue[i] = std::max(m_cParam[i].m_fMin, std::min(m_cParam[i].m_fMax, m_fValue[i]));
+} //Clamp
+
+/// \brief A runner.
+///
+/// A runner is a machine together with the simulation context that it
+/// owns, which runs one candidate and is then thrown away.
+
+class CRunner{
+  private:
+    CContext m_cContext; ///< Simulation context, which must be constructed first.
+    CMachine m_cMachine; ///< The Rube Goldberg machine.
+
+  public:
+    CRunner(); ///< Constructor.
+
+    bool Initialize(const std::string& settings, const std::string& level,
+      const std::string& hulls); ///< Initialize.
+    void Run(CCandidate& c, float dt, float timeout); ///< Run a candidate.
+}; //CRunner
+
+/// Construct the machine with the runner's own context.
+
+CRunner::CRunner():
+  m_cMachine(m_cContext){
+} //constructor
+
+/// Initialize the machine, load the sprite sizes from the image files,
+/// load the hull file if there is one, and load the level file.
+/// \param settings Path to `gamesettings.xml`.
+/// \param level Path to binary level file.
+/// \param hulls Path to hull file, empty for none.
+/// \return true if all of the sprite sizes were found and the level loaded.
+
+bool CRunner::Initialize(const std::string& settings, const std::string& level,
+  const std::string& hulls)
+{
+  m_cMachine.Initialize();
+  if(!hulls.empty())m_cMachine.LoadHulls(hulls);
+  return m_cContext.m_pSpriteSizes->Load(settings) && m_cMachine.LoadLevel(level);
+} //Initialize
+
+/// Build the level with a candidate's tuning parameters and run it until
+/// it finishes or times out, then record the result in the candidate.
+/// \param c [in, out] Candidate.
+/// \param dt Frame time in seconds.
+/// \param timeout Longest simulated time to wait for the machine to finish.
+
+void CRunner::Run(CCandidate& c, float dt, float timeout){
+  m_cMachine.SetTuning(c.GetTuning());
+  m_cMachine.Reset();
+  m_cMachine.Launch();
+
+  const float fTimeout = m_cContext.m_fTime + timeout; //time to give up
+
+  while(m_cContext.m_eGameState != eGameState::Finished && m_cContext.m_fTime < fTimeout)
+    m_cMachine.Step(dt); //move all objects
+
+  c.m_bFinished = m_cContext.m_eGameState == eGameState::Finished;
+  c.m_fTime = c.m_bFinished? m_cContext.m_fTotalTime: timeout;
+} //Run
+
+/// \param threads Number of threads.
+/// \param seed Random number seed.
+
+COptimizer::COptimizer(UINT threads, UINT seed):
+  m_nThreads(std::max(1U, threads)),
+  m_stdRandom(seed){
+} //constructor
+
+/// Remember where the files are and how to run the candidates, then check
+/// that a machine can be built from the files.
+/// \param settings Path to `gamesettings.xml`.
+/// \param level Path to binary level file.
+/// \param hulls Path to hull file, empty for none.
+/// \param dt Frame time in seconds.
+/// \param timeout Longest simulated time to wait for the machine to finish.
+/// \return true if the sprite sizes and the level could be loaded.
+
+bool COptimizer::Initialize(const std::string& settings, const std::string& level,
+  const std::string& hulls, float dt, float timeout)
+{
+  m_strSettings = settings;
+  m_strLevel = level;
+  m_strHulls = hulls;
+  m_fFrameTime = dt;
+  m_fTimeout = timeout;
+
+  CRunner* p = new CRunner; //to try loading the files
+  const bool bLoaded = p->Initialize(settings, level, hulls);
+  delete p;
+
+  if(!bLoaded)
+    fprintf(stderr, "Cannot load sprite sizes using %s or level file %s\n",
+      settings.c_str(), level.c_str());
+
+  return bLoaded;
+} //Initialize
+
+/// Writer function for where the candidates are printed.
+/// \param p File to print to, nullptr to print nothing.
+
+void COptimizer::SetOutput(FILE* p){
+  m_pOutput = p;
+} //SetOutput
+
+/// Choose a candidate with each parameter uniformly distributed over
+/// its range.
+/// \return Candidate.
+
+CCandidate COptimizer::Random(){
+  CCandidate c;
+
+  for(UINT i=0; i<CCandidate::PARAMS; i++){ //for each parameter
+    const CParam& p = CCandidate::m_cParam[i];
+    std::uniform_real_distribution<float> d(p.m_fMin, p.m_fMax);
+    c.m_fValue[i] = d(m_stdRandom);
+  } //for
+
+  return c;
+} //Random
+
+/// Run a candidate in a runner of its own, so that nothing is left over
+/// from whatever was run before it.
+/// \param c [in, out] Candidate.
+
+void COptimizer::RunCandidate(CCandidate& c) const{
+  CRunner* p = new CRunner; //fresh context and Physics World
+
+  if(p->Initialize(m_strSettings, m_strLevel, m_strHulls))
+    p->Run(c, m_fFrameTime, m_fTimeout);
+
+  else{ //files have gone away since Initialize()
+    c.m_bFinished = false;
+    c.m_fTime = m_fTimeout;
+  } //else
+
+  delete p;
+} //RunCandidate
+
+/// Run a batch of candidates spread over the threads, then print them in
+/// batch order and update the best candidate. Ties go to the candidate
+/// earliest in the batch, whichever thread ran it.
+/// \param v [in, out] Candidates.
+/// \param phase Name of search phase, for output.
+/// \return true if the best candidate got better.
+
+bool COptimizer::Evaluate(std::vector<CCandidate>& v, const char* phase){
+  std::atomic<size_t> nNext(0); //index of next candidate to run
+  std::vector<std::thread> stdThread; //worker threads
+
+  const size_t n = std::min((size_t)m_nThreads, v.size()); //number of threads to use
+
+  for(size_t i=0; i<n; i++) //for each thread
+    stdThread.push_back(std::thread([&](){
+      for(size_t j=nNext++; j<v.size(); j=nNext++) //for each candidate left
+        RunCandidate(v[j]);
+    }));
+
+  for(auto& t: stdThread) //for each thread
+    t.join();
+
+  bool bBetter = false; //whether the best got better
+
+  for(auto const& c: v){ //for each candidate, in order
+    if(m_pOutput){
+      fprintf(m_pOutput, "%s,%u,%s,%.3f", phase, m_nTrials, c.m_bFinished? "yes": "no", c.m_fTime);
+
+      for(UINT i=0; i<CCandidate::PARAMS; i++) //for each parameter
+        fprintf(m_pOutput, ",%.3f", c.m_fValue[i]);
+
+      fprintf(m_pOutput, "\n");
+    } //if
+
+    m_nTrials++;
+
+    if(c.m_bFinished && (!m_bHasBest || c.m_fTime < m_cBest.m_fTime)){
+      m_cBest = c;
+      m_bHasBest = bBetter = true;
+    } //if
+  } //for
+
+  return bBetter;
+} //Evaluate
+
+/// Search for the fastest candidate that finishes. The first batch is the
+/// hand-tuned parameters and a number of random candidates. Then, in each
+/// round of refinement, the best so far is stepped up and down in each
+/// parameter in turn, and also by RANDOMSTEPS random steps in all
+/// parameters at once. The step size starts at a quarter of each
+/// parameter's range and is halved after every round that finds nothing
+/// better, until it gets too small to matter.
+/// \param samples Number of random candidates.
+/// \param rounds Greatest number of rounds of refinement.
+/// \return true if any candidate finished.
+
+bool COptimizer::Run(UINT samples, UINT rounds){
+  if(m_pOutput){
+    fprintf(m_pOutput, "phase,trial,finished,completion time (s)");
+
+    for(UINT i=0; i<CCandidate::PARAMS; i++) //for each parameter
+      fprintf(m_pOutput, ",%s", CCandidate::m_cParam[i].m_szName);
+
+    fprintf(m_pOutput, "\n");
+  } //if
+
+  //hand-tuned and random candidates
+
+  std::vector<CCandidate> v(1); //candidates
+  v[0].SetTuning(CTuning()); //hand-tuned
+
+  for(UINT i=0; i<samples; i++) //for each random candidate
+    v.push_back(Random());
+
+  Evaluate(v, "random");
+
+  const CCandidate cHandTuned = v[0]; //for comparison at the end
+
+  //refinement
+
+  std::normal_distribution<float> stdNormal(0.0f, 1.0f); //for random steps
+  float fStep = 0.25f; //step size as a fraction of each parameter's range
+
+  for(UINT r=0; r<rounds && m_bHasBest && fStep > 1.0f/256.0f; r++){ //for each round
+    v.clear();
+
+    for(UINT i=0; i<CCandidate::PARAMS; i++){ //for each parameter
+      const CParam& p = CCandidate::m_cParam[i];
+
+      for(float s: {-fStep, fStep}){ //step down and up
+        CCandidate c = m_cBest;
+        c.m_fValue[i] += s*(p.m_fMax - p.m_fMin);
+        c.Clamp();
+        v.push_back(c);
+      } //for
+    } //for
+
+    for(UINT j=0; j<RANDOMSTEPS; j++){ //for each random step
+      CCandidate c = m_cBest;
+
+      for(UINT i=0; i<CCandidate::PARAMS; i++){ //for each parameter
+        const CParam& p = CCandidate::m_cParam[i];
+        c.m_fValue[i] += fStep*stdNormal(m_stdRandom)*(p.m_fMax - p.m_fMin);
+      } //for
+
+      c.Clamp();
+      v.push_back(c);
+    } //for
+
+    if(!Evaluate(v, "refine"))
+      fStep *= 0.5f;
+  } //for
+
+  //report
+
+  if(m_pOutput == nullptr)
+    return m_bHasBest;
+
+  if(!m_bHasBest){
+    fprintf(m_pOutput, "no candidate finished within %.1f seconds\n", m_fTimeout);
+    return false;
+  } //if
+
+  fprintf(m_pOutput, "best completion time: %.3f s", m_cBest.m_fTime);
+  if(cHandTuned.m_bFinished)fprintf(m_pOutput, " (hand-tuned %.3f s)", cHandTuned.m_fTime);
+  else fprintf(m_pOutput, " (hand-tuned did not finish)");
+  fprintf(m_pOutput, "\n");
+
+  for(UINT i=0; i<CCandidate::PARAMS; i++) //for each parameter
+    fprintf(m_pOutput, "%s: %.3f\n", CCandidate::m_cParam[i].m_szName, m_cBest.m_fValue[i]);
+
+  return true;
+} //Run
+
+/// Reader function for the best candidate.
+/// \param c [out] Fastest candidate that finished, if any did.
+/// \return true if any candidate finished.
+
+bool COptimizer::GetBest(CCandidate& c) const{
+  if(m_bHasBest)c = m_cBest;
+  return m_bHasBest;
+} //GetBest
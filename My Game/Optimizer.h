@@ -0,0 +1,85 @@
+/// \file Optimizer.h
+/// \brief Interface for the parameter optimizer COptimizer.
+
+#ifndef __L4RC_GAME_OPTIMIZER_H__
+#define __L4RC_GAME_OPTIMIZER_H__
+
+#include <cstdio>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "Common.h"
+
+/// \brief A tuning parameter.
+///
+/// The name and range of a tuning parameter.
+
+struct CParam{
+  const char* m_szName = nullptr; ///< Name, for output.
+  float m_fMin = 0; ///< Least value.
+  float m_fMax = 0; ///< Greatest value.
+}; //CParam
+
+/// \brief A candidate.
+///
+/// A set of values for the tuning parameters, and the result of running
+/// the machine with them.
+
+struct CCandidate{
+  static const UINT PARAMS = 5; ///< Number of tuning parameters.
+  static const CParam m_cParam[PARAMS]; ///< Tuning parameters, in the order of the values.
+
+  float m_fValue[PARAMS] = {0}; ///< Parameter values, in the order of m_cParam.
+  bool m_bFinished = false; ///< Whether the machine finished.
+  float m_fTime = 0; ///< Completion time in seconds, if it finished.
+
+  CTuning GetTuning() const; ///< Get tuning parameters.
+  void SetTuning(const CTuning& t); ///< Set from tuning parameters.
+  void Clamp(); ///< Clamp values to their ranges.
+}; //CCandidate
+
+/// \brief The optimizer.
+///
+/// The optimizer searches for the tuning parameters that make the machine
+/// reach the pig in the shortest simulated time. It chooses candidates on
+/// the calling thread from a seeded random number generator, has them run
+/// in parallel, and keeps track of the best one. Every candidate is run in
+/// a machine of its own, built from scratch in a new simulation context
+/// and Physics World, so its result depends only on its parameters. The
+/// number of candidates in each batch does not depend on the number of
+/// threads either, so for a given seed neither does the search.
+
+class COptimizer{
+  private:
+    static const UINT RANDOMSTEPS = 6; ///< Random steps per round of refinement.
+
+    UINT m_nThreads = 1; ///< Number of threads.
+    std::mt19937 m_stdRandom; ///< Random number generator.
+
+    std::string m_strSettings; ///< Path to `gamesettings.xml`.
+    std::string m_strLevel; ///< Path to binary level file.
+    std::string m_strHulls; ///< Path to hull file, empty for none.
+    float m_fFrameTime = fStepTime; ///< Frame time in seconds.
+    float m_fTimeout = 120.0f; ///< Timeout in seconds of simulated time.
+    FILE* m_pOutput = stdout; ///< Where to print the candidates, nullptr for nowhere.
+
+    UINT m_nTrials = 0; ///< Number of candidates tried so far.
+    bool m_bHasBest = false; ///< Whether any candidate has finished.
+    CCandidate m_cBest; ///< Fastest candidate that finished.
+
+    CCandidate Random(); ///< Choose a random candidate.
+    void RunCandidate(CCandidate& c) const; ///< Run a candidate.
+    bool Evaluate(std::vector<CCandidate>& v, const char* phase); ///< Try a batch.
+
+  public:
+    COptimizer(UINT threads, UINT seed); ///< Constructor.
+
+    bool Initialize(const std::string& settings, const std::string& level,
+      const std::string& hulls, float dt, float timeout); ///< Initialize.
+    void SetOutput(FILE* p); ///< Set where to print the candidates.
+    bool Run(UINT samples, UINT rounds); ///< Search.
+    bool GetBest(CCandidate& c) const; ///< Get the best candidate.
+}; //COptimizer
+
+#endif //__L4RC_GAME_OPTIMIZER_H__
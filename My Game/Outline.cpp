@@ -0,0 +1,451 @@
+/// \file Outline.cpp
+/// \brief Code for the outline builder COutline.
+
+#include <algorithm>
+
+#include "Outline.h"
+
+#if defined(_M_X64) || defined(__SSE2__)
+  #define OUTLINE_SSE //use SSE to transform points
+  #include <xmmintrin.h>
+#endif
+
+/// Length in pixels of the side of a circle drawn at lower detail.
+
+static const float fLODSegmentLength = 8.0f;
+
+/// Least number of sides of a circle drawn at lower detail.
+
+static const UINT nLODMinSegments = 8;
+
+/// Get the number of segments that a circle must be broken into so that
+/// the gaps between them are no longer than the line sprite is wide.
+/// \param r Radius in renderer units.
+/// \param w Width of line sprite.
+/// \return Number of segments.
+
+UINT COutline::GetCircleSegments(float r, float w){
+  return (UINT)ceilf(XM_2PI*r/w) + 1;
+} //GetCircleSegments
+
+/// Get the number of sides of a regular polygon that will do instead of
+/// a circle, given how big the circle is on screen. Small circles get
+/// a few long sides, large ones more of them.
+/// \param r Radius in renderer units.
+/// \return Number of sides.
+
+UINT COutline::GetCircleSegmentsLOD(float r){
+  const UINT n = (UINT)ceilf(XM_2PI*r/fLODSegmentLength); //number of sides
+  return n < nLODMinSegments? nLODMinSegments: n;
+} //GetCircleSegmentsLOD
+
+/// Get the unit circle table for a number of segments, computing it if it
+/// has not been needed before. The tables are padded with zeros to a
+/// multiple of four entries.
+/// \param n Number of segments.
+/// \return Reference to the unit circle table.
+
+const COutline::CCircleTable& COutline::GetCircleTable(UINT n){
+  if(n >= m_stdCircle.size())
+    m_stdCircle.resize(n + 1);
+
+  CCircleTable& table = m_stdCircle[n];
+
+  if(table.m_stdCos.empty() && n > 0){ //compute table
+    const size_t size = (n + 3) & ~3; //padded size
+
+    table.m_stdCos.resize(size, 0.0f);
+    table.m_stdSin.resize(size, 0.0f);
+    table.m_stdAngle.resize(size, 0.0f);
+
+    for(UINT i=0; i<n; i++){ //for each point
+      const float theta = XM_2PI*i/(float)n; //rotation angle
+      table.m_stdCos[i] = cosf(theta);
+      table.m_stdSin[i] = sinf(theta);
+      table.m_stdAngle[i] = XM_PI/2.0f + theta; //tangent to circle
+    } //for
+  } //if
+
+  return table;
+} //GetCircleTable
+
+/// Build the outline of a circle by scaling and translating a unit circle.
+/// \param c Center in renderer coordinates.
+/// \param r Radius in renderer units.
+/// \param n Number of segments.
+
+void COutline::Circle(const Vector2& c, float r, UINT n){
+  const CCircleTable& table = GetCircleTable(n);
+  const size_t size = table.m_stdCos.size(); //padded size
+
+  if(m_stdX.size() < size){
+    m_stdX.resize(size);
+    m_stdY.resize(size);
+  } //if
+
+  const float* pCos = table.m_stdCos.data(); //cosines
+  const float* pSin = table.m_stdSin.data(); //sines
+  float* x = m_stdX.data(); //x coordinates
+  float* y = m_stdY.data(); //y coordinates
+
+#ifdef OUTLINE_SSE
+  const __m128 cx = _mm_set1_ps(c.x); //center x coordinate, four times
+  const __m128 cy = _mm_set1_ps(c.y); //center y coordinate, four times
+  const __m128 rr = _mm_set1_ps(r); //radius, four times
+
+  for(size_t i=0; i<size; i+=4){ //for each group of four points
+    _mm_storeu_ps(x + i, _mm_add_ps(cx, _mm_mul_ps(rr, _mm_loadu_ps(pCos + i))));
+    _mm_storeu_ps(y + i, _mm_add_ps(cy, _mm_mul_ps(rr, _mm_loadu_ps(pSin + i))));
+  } //for
+#else
+  for(size_t i=0; i<size; i++){ //for each point
+    x[i] = c.x + r*pCos[i];
+    y[i] = c.y + r*pSin[i];
+  } //for
+#endif //OUTLINE_SSE
+
+  m_pAngle = table.m_stdAngle.data();
+  m_nCount = n;
+} //Circle
+
+/// Reader function for the number of points in the last outline built.
+/// \return Number of points.
+
+size_t COutline::GetCount() const{
+  return m_nCount;
+} //GetCount
+
+/// Reader function for the X coordinates of the points in the last outline built.
+/// \return Pointer to X coordinates in renderer units.
+
+const float* COutline::GetX() const{
+  return m_stdX.data();
+} //GetX
+
+/// Reader function for the Y coordinates of the points in the last outline built.
+/// \return Pointer to Y coordinates in renderer units.
+
+const float* COutline::GetY() const{
+  return m_stdY.data();
+} //GetY
+
+/// Reader function for the orientations at the points in the last outline
+/// built. For a circle, this is the orientation of the tangent.
+/// \return Pointer to orientations.
+
+const float* COutline::GetAngle() const{
+  return m_pAngle;
+} //GetAngle
+
+/// Empty the line vertex buffer and the list of circles, keeping their
+/// memory for the next batch.
+
+void COutline::BeginBatch(){
+  m_stdLine.clear();
+  m_stdCircleCenter.clear();
+  m_stdCircleRadius.clear();
+  m_bKept = false;
+} //BeginBatch
+
+/// Add the outline of every fixture of a body to the batch, where the body
+/// is in Physics World.
+/// \param p Pointer to a Box2D body.
+
+void COutline::AddBody(b2Body* p){
+  AddBody(p, p->GetPosition(), p->GetAngle());
+} //AddBody
+
+/// Add the outline of every fixture of a body in a transform cache to the
+/// batch, where the transform cache says that the body is. That is where
+/// its sprite is drawn, which is part of the way from where the body was
+/// before the last physics step to where it is now if the cache has been
+/// interpolated.
+/// \param c Transform cache.
+/// \param i Index of the body in the transform cache.
+
+void COutline::AddBody(const CTransformCache& c, size_t i){
+  const b2Vec2 pos(RW2PW(c.GetX()[i]), RW2PW(c.GetY()[i])); //position in Physics World
+  AddBody(c.GetBody(i), pos, c.GetAngle()[i]);
+} //AddBody
+
+/// Add the outline of every fixture of a body to the batch, with the body
+/// at a given position and orientation. The rotation is computed once and
+/// shared by all of its fixtures. Chain shapes are not drawn.
+/// \param p Pointer to a Box2D body.
+/// \param pos Position in Physics World.
+/// \param a Orientation.
+
+void COutline::AddBody(b2Body* p, const b2Vec2& pos, float a){
+  const b2Rot q(a); //rotation
+
+  for(b2Fixture* f=p->GetFixtureList(); f; f=f->GetNext()){ //for each fixture
+    b2Shape* s = f->GetShape(); //shape of fixture
+
+    switch(s->GetType()){
+      case b2Shape::e_circle:
+        m_stdCircleCenter.push_back(PW2RW(pos));
+        m_stdCircleRadius.push_back(PW2RW(s->m_radius));
+        break;
+
+      case b2Shape::e_edge:
+        AddEdge((b2EdgeShape*)s, pos);
+        break;
+
+      case b2Shape::e_polygon:
+        AddPolygon((b2PolygonShape*)s, pos, q);
+        break;
+
+      default: break;
+    } //switch
+  } //for
+} //AddBody
+
+/// Start a kept batch again from scratch if need be. That is the first
+/// time, after a batch has been begun in some other way, when the
+/// transform cache generation changes, when bodies have been removed, or
+/// when a list of bodies that moved has been emptied without the batch
+/// seeing it.
+/// \param c Transform cache.
+/// \return Number of bodies already in the batch.
+
+size_t COutline::KeepBatch(const CTransformCache& c){
+  const UINT nClears = c.GetClearCount(); //number of times moved list was emptied
+
+  if(!m_bKept || c.GetGeneration() != m_nGeneration ||
+    (nClears != m_nClearCount && nClears != m_nClearCount + 1) ||
+    c.GetSize() + 1 < m_stdBodyLine.size())
+  { //start again
+    BeginBatch();
+    m_stdBodyLine.assign(1, 0);
+    m_stdBodyCircle.assign(1, 0);
+    m_stdStale.clear();
+    m_stdStaleList.clear();
+    m_nGeneration = c.GetGeneration();
+    m_bKept = true;
+  } //if
+
+  m_nClearCount = nClears;
+  return m_stdBodyLine.size() - 1;
+} //KeepBatch
+
+/// Append the bodies that have been added to a transform cache since the
+/// last time to a kept batch.
+/// \param c Transform cache.
+/// \param n Number of bodies already in the batch.
+
+void COutline::AddNewBodies(const CTransformCache& c, size_t n){
+  for(size_t i=n; i<c.GetSize(); i++){ //for each new body
+    AddBody(c, i);
+    m_stdBodyLine.push_back((UINT)m_stdLine.size());
+    m_stdBodyCircle.push_back((UINT)m_stdCircleCenter.size());
+  } //for
+
+  m_stdStale.resize(c.GetSize(), 0);
+} //AddNewBodies
+
+/// Bring a kept batch up to date with the bodies in a transform cache.
+/// The batch is built from scratch when KeepBatch() says so. Otherwise,
+/// bodies that have been added since the last time are appended, and the
+/// stale bodies and the bodies in the list of bodies that moved are built
+/// again in place. Everything else is left as it was, so the work done
+/// scales with the number of bodies that moved.
+/// \param c Transform cache.
+
+void COutline::UpdateBatch(const CTransformCache& c){
+  const size_t nOld = KeepBatch(c); //number of bodies already in batch
+
+  for(const UINT i: m_stdStaleList) //for each body that may be stale
+    if(m_stdStale[i]){
+      RebuildBody(c, i);
+      m_stdStale[i] = 0;
+    } //if
+
+  m_stdStaleList.clear();
+
+  const size_t nMoved = c.GetMovedCount(); //number of bodies that moved
+  const UINT* pMoved = c.GetMoved(); //indices of bodies that moved
+
+  for(size_t j=0; j<nMoved; j++) //for each body that moved
+    if(pMoved[j] < nOld)
+      RebuildBody(c, pMoved[j]);
+
+  AddNewBodies(c, nOld);
+} //UpdateBatch
+
+/// Bring the bodies that are about to be drawn in a kept batch up to date
+/// with a transform cache. This is the same as UpdateBatch() except that
+/// the bodies that moved are only marked stale, and only the stale bodies
+/// that are to be drawn are built again, so that the work done scales with
+/// the number of bodies drawn that moved.
+/// \param c Transform cache.
+/// \param visible Indices of the bodies to be drawn.
+/// \param n Number of bodies to be drawn.
+
+void COutline::UpdateBatch(const CTransformCache& c, const UINT* visible, size_t n){
+  const size_t nOld = KeepBatch(c); //number of bodies already in batch
+
+  const size_t nMoved = c.GetMovedCount(); //number of bodies that moved
+  const UINT* pMoved = c.GetMoved(); //indices of bodies that moved
+
+  if(m_stdStaleList.size() + nMoved > 2*nOld){ //forget bodies no longer stale
+    const auto fresh = [&](UINT i){return m_stdStale[i] == 0;};
+    m_stdStaleList.erase(std::remove_if(m_stdStaleList.begin(), m_stdStaleList.end(), fresh),
+      m_stdStaleList.end());
+  } //if
+
+  for(size_t j=0; j<nMoved; j++) //for each body that moved
+    if(pMoved[j] < nOld && !m_stdStale[pMoved[j]]){
+      m_stdStale[pMoved[j]] = 1;
+      m_stdStaleList.push_back(pMoved[j]);
+    } //if
+
+  AddNewBodies(c, nOld);
+
+  for(size_t j=0; j<n; j++){ //for each body to be drawn
+    const UINT i = visible[j]; //index of body
+
+    if(m_stdStale[i]){
+      RebuildBody(c, i);
+      m_stdStale[i] = 0;
+    } //if
+  } //for
+} //UpdateBatch
+
+/// Build a body's outline again in a kept batch, in the same place as
+/// before. It is added to the end of the buffers as usual, then moved
+/// over its old outline.
+/// \param c Transform cache.
+/// \param i Index of body in transform cache.
+
+void COutline::RebuildBody(const CTransformCache& c, size_t i){
+  const size_t nLines = m_stdLine.size(); //end of line vertex buffer
+  const size_t nCircles = m_stdCircleCenter.size(); //end of circles
+
+  AddBody(c, i);
+
+  std::copy(m_stdLine.begin() + nLines, m_stdLine.end(),
+    m_stdLine.begin() + m_stdBodyLine[i]);
+  std::copy(m_stdCircleCenter.begin() + nCircles, m_stdCircleCenter.end(),
+    m_stdCircleCenter.begin() + m_stdBodyCircle[i]);
+
+  m_stdLine.resize(nLines);
+  m_stdCircleCenter.resize(nCircles);
+  m_stdCircleRadius.resize(nCircles);
+} //RebuildBody
+
+/// Add the sides of a polygon to the line vertex buffer. The vertices are
+/// rotated, translated, and scaled into renderer coordinates four at a time,
+/// then each one is joined to the one before it, and the first to the last.
+/// \param p Pointer to a Box2D polygon shape.
+/// \param pos Position in Physics World.
+/// \param q Rotation.
+
+void COutline::AddPolygon(const b2PolygonShape* p, const b2Vec2& pos, const b2Rot& q){
+  const int32 n = p->m_count; //number of vertices
+  if(n < 2)return;
+
+  const int32 size = (n + 3) & ~3; //padded to a multiple of four
+  float vx[b2_maxPolygonVertices + 3] = {0}; //vertex x coordinates in Physics World
+  float vy[b2_maxPolygonVertices + 3] = {0}; //vertex y coordinates in Physics World
+  float x[b2_maxPolygonVertices + 3]; //vertex x coordinates in renderer
+  float y[b2_maxPolygonVertices + 3]; //vertex y coordinates in renderer
+
+  for(int32 i=0; i<n; i++){ //gather vertices
+    vx[i] = p->m_vertices[i].x;
+    vy[i] = p->m_vertices[i].y;
+  } //for
+
+#ifdef OUTLINE_SSE
+  const __m128 c = _mm_set1_ps(q.c); //cosine, four times
+  const __m128 s = _mm_set1_ps(q.s); //sine, four times
+  const __m128 px = _mm_set1_ps(pos.x); //position x coordinate, four times
+  const __m128 py = _mm_set1_ps(pos.y); //position y coordinate, four times
+  const __m128 k = _mm_set1_ps(fPRV); //rescale value, four times
+
+  for(int32 i=0; i<size; i+=4){ //for each group of four vertices
+    const __m128 ux = _mm_loadu_ps(vx + i);
+    const __m128 uy = _mm_loadu_ps(vy + i);
+    const __m128 rx = _mm_sub_ps(_mm_mul_ps(c, ux), _mm_mul_ps(s, uy)); //rotated x
+    const __m128 ry = _mm_add_ps(_mm_mul_ps(s, ux), _mm_mul_ps(c, uy)); //rotated y
+    _mm_storeu_ps(x + i, _mm_mul_ps(_mm_add_ps(px, rx), k));
+    _mm_storeu_ps(y + i, _mm_mul_ps(_mm_add_ps(py, ry), k));
+  } //for
+#else
+  for(int32 i=0; i<size; i++){ //for each vertex
+    x[i] = (pos.x + (q.c*vx[i] - q.s*vy[i]))*fPRV;
+    y[i] = (pos.y + (q.s*vx[i] + q.c*vy[i]))*fPRV;
+  } //for
+#endif //OUTLINE_SSE
+
+  for(int32 i=1; i<n; i++){ //for each side but the last
+    m_stdLine.push_back(Vector2(x[i - 1], y[i - 1]));
+    m_stdLine.push_back(Vector2(x[i], y[i]));
+  } //for
+
+  m_stdLine.push_back(Vector2(x[0], y[0])); //first to last
+  m_stdLine.push_back(Vector2(x[n - 1], y[n - 1]));
+} //AddPolygon
+
+/// Add an edge to the line vertex buffer. Edges do not rotate with their
+/// bodies.
+/// \param p Pointer to a Box2D edge shape.
+/// \param pos Position in Physics World.
+
+void COutline::AddEdge(const b2EdgeShape* p, const b2Vec2& pos){
+  m_stdLine.push_back(PW2RW(pos + p->m_vertex1));
+  m_stdLine.push_back(PW2RW(pos + p->m_vertex2));
+} //AddEdge
+
+/// Reader function for the number of lines in the batch.
+/// \return Number of lines.
+
+size_t COutline::GetLineCount() const{
+  return m_stdLine.size()/2;
+} //GetLineCount
+
+/// Reader function for the line vertex buffer. Line i goes from vertex 2i
+/// to vertex 2i + 1.
+/// \return Pointer to line vertices in renderer coordinates.
+
+const Vector2* COutline::GetLines() const{
+  return m_stdLine.data();
+} //GetLines
+
+/// Reader function for the number of circles in the batch.
+/// \return Number of circles.
+
+size_t COutline::GetCircleCount() const{
+  return m_stdCircleCenter.size();
+} //GetCircleCount
+
+/// Reader function for the centers of the circles in the batch.
+/// \return Pointer to centers in renderer coordinates.
+
+const Vector2* COutline::GetCircleCenters() const{
+  return m_stdCircleCenter.data();
+} //GetCircleCenters
+
+/// Reader function for the radii of the circles in the batch.
+/// \return Pointer to radii in renderer units.
+
+const float* COutline::GetCircleRadii() const{
+  return m_stdCircleRadius.data();
+} //GetCircleRadii
+
+/// Reader function for where each body's line vertices start in a kept
+/// batch. There is one more entry than there are bodies, so the vertices
+/// of body i run from entry i up to entry i + 1.
+/// \return Pointer to offsets into the line vertex buffer.
+
+const UINT* COutline::GetBodyLines() const{
+  return m_stdBodyLine.data();
+} //GetBodyLines
+
+/// Reader function for where each body's circles start in a kept batch.
+/// There is one more entry than there are bodies, so the circles of body i
+/// run from entry i up to entry i + 1.
+/// \return Pointer to offsets into the circles.
+
+const UINT* COutline::GetBodyCircles() const{
+  return m_stdBodyCircle.data();
+} //GetBodyCircles
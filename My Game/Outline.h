@@ -0,0 +1,105 @@
+/// \file Outline.h
+/// \brief Interface for the outline builder COutline.
+
+#ifndef __L4RC_GAME_OUTLINE_H__
+#define __L4RC_GAME_OUTLINE_H__
+
+#include <vector>
+
+#include "GameDefines.h"
+#include "TransformCache.h"
+
+/// \brief The outline builder.
+///
+/// The outline builder works out where the pieces of a shape's outline go in
+/// renderer coordinates, leaving the drawing to the renderer. Circles are
+/// built from unit circle tables that are computed the first time that a
+/// circle with a given number of segments is needed and kept from then on,
+/// so that drawing a circle needs no trigonometry. The points are scaled and
+/// translated into renderer coordinates four at a time using SSE.
+///
+/// The outline builder also batches the outlines of whole bodies. The
+/// sides of their polygons and their edges go into a single line vertex
+/// buffer, two vertices per line. The rotation of each body is computed
+/// once, and its polygon vertices are transformed four at a time using SSE.
+/// Circles are put aside to be built later by Circle().
+///
+/// A batch can also be kept from one frame to the next by UpdateBatch().
+/// Its bodies are built where the transform cache says they are, so their
+/// outlines are drawn where their sprites are, even when the transforms
+/// have been interpolated. Each body's lines and circles stay in the same
+/// place in the buffers, and only the bodies that the transform cache says
+/// have moved are built again, into the same places, since a body's
+/// fixtures do not change once it has been created. When only some of the
+/// bodies are to be drawn, the ones that moved out of sight are marked
+/// stale instead, and built again only when they are next drawn, so the
+/// work done scales with what is drawn rather than with the whole machine.
+
+class COutline{
+  private:
+    /// \brief A unit circle table.
+    ///
+    /// The points of a unit circle divided into a fixed number of equal
+    /// segments, and the orientation of the tangent at each point.
+
+    struct CCircleTable{
+      std::vector<float> m_stdCos; ///< Cosines.
+      std::vector<float> m_stdSin; ///< Sines.
+      std::vector<float> m_stdAngle; ///< Tangent orientations.
+    }; //CCircleTable
+
+    std::vector<CCircleTable> m_stdCircle; ///< Unit circle tables, indexed by number of segments.
+
+    std::vector<float> m_stdX; ///< X coordinates of points.
+    std::vector<float> m_stdY; ///< Y coordinates of points.
+    const float* m_pAngle = nullptr; ///< Orientations at points.
+    size_t m_nCount = 0; ///< Number of points.
+
+    std::vector<Vector2> m_stdLine; ///< Line vertex buffer, two per line.
+    std::vector<Vector2> m_stdCircleCenter; ///< Centers of circles in batch.
+    std::vector<float> m_stdCircleRadius; ///< Radii of circles in batch.
+
+    std::vector<UINT> m_stdBodyLine; ///< Where each body's line vertices start in a kept batch, and where the last one's end.
+    std::vector<UINT> m_stdBodyCircle; ///< Where each body's circles start in a kept batch, and where the last one's end.
+    std::vector<BYTE> m_stdStale; ///< Whether each body in a kept batch must be built again before it is drawn.
+    std::vector<UINT> m_stdStaleList; ///< Indices of stale bodies, some of which may no longer be stale.
+    bool m_bKept = false; ///< Whether the batch is kept from frame to frame.
+    UINT m_nGeneration = 0; ///< Transform cache generation when the batch was built.
+    UINT m_nClearCount = 0; ///< Transform cache clear count when the batch was last updated.
+
+    const CCircleTable& GetCircleTable(UINT n); ///< Get unit circle table.
+
+    void AddPolygon(const b2PolygonShape*, const b2Vec2&, const b2Rot&); ///< Add polygon to batch.
+    void AddEdge(const b2EdgeShape*, const b2Vec2&); ///< Add edge to batch.
+    void AddBody(b2Body* p, const b2Vec2& pos, float a); ///< Add body outline at a pose to batch.
+    void RebuildBody(const CTransformCache& c, size_t i); ///< Build a body again in a kept batch.
+    size_t KeepBatch(const CTransformCache& c); ///< Start a kept batch again if need be.
+    void AddNewBodies(const CTransformCache& c, size_t n); ///< Append new bodies to a kept batch.
+
+  public:
+    static UINT GetCircleSegments(float r, float w); ///< Number of segments for a circle.
+    static UINT GetCircleSegmentsLOD(float r); ///< Number of segments for a circle at lower detail.
+
+    void Circle(const Vector2& c, float r, UINT n); ///< Build circle outline.
+
+    size_t GetCount() const; ///< Get number of points.
+    const float* GetX() const; ///< Get X coordinates.
+    const float* GetY() const; ///< Get Y coordinates.
+    const float* GetAngle() const; ///< Get orientations.
+
+    void BeginBatch(); ///< Begin a batch of body outlines.
+    void AddBody(b2Body* p); ///< Add body outline to batch.
+    void AddBody(const CTransformCache& c, size_t i); ///< Add body outline from transform cache to batch.
+    void UpdateBatch(const CTransformCache& c); ///< Keep a batch up to date with a transform cache.
+    void UpdateBatch(const CTransformCache& c, const UINT* visible, size_t n); ///< Keep some of a batch up to date.
+
+    size_t GetLineCount() const; ///< Get number of lines in batch.
+    const Vector2* GetLines() const; ///< Get line vertex buffer.
+    size_t GetCircleCount() const; ///< Get number of circles in batch.
+    const Vector2* GetCircleCenters() const; ///< Get centers of circles in batch.
+    const float* GetCircleRadii() const; ///< Get radii of circles in batch.
+    const UINT* GetBodyLines() const; ///< Get where each body's line vertices start in a kept batch.
+    const UINT* GetBodyCircles() const; ///< Get where each body's circles start in a kept batch.
+}; //COutline
+
+#endif //__L4RC_GAME_OUTLINE_H__
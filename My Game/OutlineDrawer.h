@@ -0,0 +1,195 @@
+/// \file OutlineDrawer.h
+/// \brief Interface and code for the outline drawer COutlineDrawer.
+
+#ifndef __L4RC_GAME_OUTLINEDRAWER_H__
+#define __L4RC_GAME_OUTLINEDRAWER_H__
+
+#include <vector>
+
+#include "GameDefines.h"
+#include "Outline.h"
+#include "TransformCache.h"
+
+/// \brief An outline drawer for a renderer of type T.
+///
+/// The outline drawer is a base class of the renderer T that it draws
+/// with. It owns an outline builder and turns what that builds into calls
+/// to T's `DrawLine(eSprite, const Vector2&, const Vector2&)`,
+/// `Draw(eSprite, const Vector2&, float)`, and `GetWidth(eSprite)`, which
+/// it must let the outline drawer see. The game's renderer is one such T,
+/// and a renderer that records what is drawn instead of drawing it is
+/// another, so both draw outlines the same way. Polygon sides and edges are
+/// drawn as lines, and circles as tiny line sprites tangent to the circle,
+/// or at lower detail, as regular polygons.
+
+template<class T> class COutlineDrawer{
+  private:
+    COutline m_cOutline; ///< Outline builder.
+    bool m_bOutlineLOD = false; ///< Whether to draw outlines at lower detail.
+
+    void DrawCircle(eSprite t, const Vector2& c, float r); ///< Draw circle outline.
+    void DrawOutlineBatch(eSprite t); ///< Draw batched outlines.
+    void DrawOutlineBatch(eSprite t, const std::vector<UINT>& visible); ///< Draw some batched outlines.
+    T& GetRenderer(); ///< Get the renderer that this is part of.
+
+  public:
+    void Drawb2Body(eSprite t, b2Body* p); ///< Draw Box2D body.
+    void Drawb2Body(eSprite t, const CTransformCache& cache, size_t i); ///< Draw Box2D body from a transform cache.
+    void Drawb2Bodies(eSprite t, const CTransformCache& cache); ///< Draw Box2D bodies.
+    void Drawb2Bodies(eSprite t, const CTransformCache& cache,
+      const std::vector<UINT>& visible); ///< Draw some Box2D bodies.
+
+    void SetOutlineLOD(bool b); ///< Set whether to draw outlines at lower detail.
+    bool GetOutlineLOD() const; ///< Get whether outlines are drawn at lower detail.
+}; //COutlineDrawer
+
+/// Get the renderer that this outline drawer is a base class of.
+/// \return Reference to the renderer.
+
+template<class T> T& COutlineDrawer<T>::GetRenderer(){
+  return static_cast<T&>(*this);
+} //GetRenderer
+
+/// Draw a circle by breaking it up into lots of little lines,
+/// each one a line sprite drawn tangent to the circle, or at lower detail,
+/// as a regular polygon whose number of sides depends on the radius. The
+/// points are built by the outline builder from cached unit circle tables.
+/// \param t Line sprite type.
+/// \param c Center in renderer coordinates.
+/// \param r Radius in renderer units.
+
+template<class T> void COutlineDrawer<T>::DrawCircle(eSprite t, const Vector2& c, float r){
+  if(m_bOutlineLOD){ //polygon
+    m_cOutline.Circle(c, r, COutline::GetCircleSegmentsLOD(r));
+
+    const size_t n = m_cOutline.GetCount(); //number of points
+    const float* x = m_cOutline.GetX(); //x coordinates
+    const float* y = m_cOutline.GetY(); //y coordinates
+
+    for(size_t i=0, j=n - 1; i<n; j=i++) //for each side
+      GetRenderer().DrawLine(t, Vector2(x[j], y[j]), Vector2(x[i], y[i]));
+  } //if
+
+  else{ //tiny lines
+    m_cOutline.Circle(c, r, COutline::GetCircleSegments(r, GetRenderer().GetWidth(eSprite::Line)));
+
+    const size_t n = m_cOutline.GetCount(); //number of points
+    const float* x = m_cOutline.GetX(); //x coordinates
+    const float* y = m_cOutline.GetY(); //y coordinates
+    const float* a = m_cOutline.GetAngle(); //orientations
+
+    for(size_t i=0; i<n; i++) //for each tiny line (almost a point really)
+      GetRenderer().Draw(t, Vector2(x[i], y[i]), a[i]); //draw line tangent to circle
+  } //else
+} //DrawCircle
+
+/// Draw the body outlines that have been batched in the outline builder.
+/// The polygon sides and edges are drawn first, straight from the line
+/// vertex buffer, then the circles.
+/// \param t Line sprite type.
+
+template<class T> void COutlineDrawer<T>::DrawOutlineBatch(eSprite t){
+  const size_t nLines = m_cOutline.GetLineCount(); //number of lines
+  const Vector2* v = m_cOutline.GetLines(); //line vertices
+
+  for(size_t i=0; i<nLines; i++) //for each line
+    GetRenderer().DrawLine(t, v[2*i], v[2*i + 1]);
+
+  const size_t nCircles = m_cOutline.GetCircleCount(); //number of circles
+  const Vector2* c = m_cOutline.GetCircleCenters(); //centers
+  const float* r = m_cOutline.GetCircleRadii(); //radii
+
+  for(size_t i=0; i<nCircles; i++) //for each circle
+    DrawCircle(t, c[i], r[i]);
+} //DrawOutlineBatch
+
+/// Draw the outlines of some of the bodies in a kept batch in the outline
+/// builder, each body's polygon sides and edges followed by its circles.
+/// \param t Line sprite type.
+/// \param visible Indices of the bodies to draw.
+
+template<class T> void COutlineDrawer<T>::DrawOutlineBatch(eSprite t,
+  const std::vector<UINT>& visible)
+{
+  const Vector2* v = m_cOutline.GetLines(); //line vertices
+  const Vector2* c = m_cOutline.GetCircleCenters(); //centers
+  const float* r = m_cOutline.GetCircleRadii(); //radii
+  const UINT* pLine = m_cOutline.GetBodyLines(); //where each body's lines start
+  const UINT* pCircle = m_cOutline.GetBodyCircles(); //where each body's circles start
+
+  for(const UINT i: visible){ //for each body
+    for(UINT j=pLine[i]; j<pLine[i + 1]; j+=2) //for each line
+      GetRenderer().DrawLine(t, v[j], v[j + 1]);
+
+    for(UINT j=pCircle[i]; j<pCircle[i + 1]; j++) //for each circle
+      DrawCircle(t, c[j], r[j]);
+  } //for
+} //DrawOutlineBatch
+
+/// Draw a Box2D body using lines. The outline builder works out where the
+/// lines go for every fixture attached to the body.
+/// \param t Line sprite type.
+/// \param p Pointer to a Box2D body.
+
+template<class T> void COutlineDrawer<T>::Drawb2Body(eSprite t, b2Body* p){
+  m_cOutline.BeginBatch();
+  m_cOutline.AddBody(p);
+  DrawOutlineBatch(t);
+} //Drawb2Body
+
+/// Draw a Box2D body in a transform cache using lines, where the transform
+/// cache says that it is.
+/// \param t Line sprite type.
+/// \param cache Transform cache.
+/// \param i Index of the body in the transform cache.
+
+template<class T> void COutlineDrawer<T>::Drawb2Body(eSprite t,
+  const CTransformCache& cache, size_t i)
+{
+  m_cOutline.BeginBatch();
+  m_cOutline.AddBody(cache, i);
+  DrawOutlineBatch(t);
+} //Drawb2Body
+
+/// Draw the bodies in a transform cache using lines, all in one batch.
+/// The batch is kept from frame to frame, and only the outlines of the
+/// bodies that moved are built again.
+/// \param t Line sprite type.
+/// \param cache Transform cache.
+
+template<class T> void COutlineDrawer<T>::Drawb2Bodies(eSprite t,
+  const CTransformCache& cache)
+{
+  m_cOutline.UpdateBatch(cache);
+  DrawOutlineBatch(t);
+} //Drawb2Bodies
+
+/// Draw some of the bodies in a transform cache using lines. The batch is
+/// kept from frame to frame as in the other Drawb2Bodies(), but only the
+/// bodies to be drawn are built again if they moved.
+/// \param t Line sprite type.
+/// \param cache Transform cache.
+/// \param visible Indices of the bodies to draw, in increasing order.
+
+template<class T> void COutlineDrawer<T>::Drawb2Bodies(eSprite t,
+  const CTransformCache& cache, const std::vector<UINT>& visible)
+{
+  m_cOutline.UpdateBatch(cache, visible.data(), visible.size());
+  DrawOutlineBatch(t, visible);
+} //Drawb2Bodies
+
+/// Writer function for whether outlines are drawn at lower detail.
+/// \param b true to draw circle outlines as polygons.
+
+template<class T> void COutlineDrawer<T>::SetOutlineLOD(bool b){
+  m_bOutlineLOD = b;
+} //SetOutlineLOD
+
+/// Reader function for whether outlines are drawn at lower detail.
+/// \return true if circle outlines are drawn as polygons.
+
+template<class T> bool COutlineDrawer<T>::GetOutlineLOD() const{
+  return m_bOutlineLOD;
+} //GetOutlineLOD
+
+#endif //__L4RC_GAME_OUTLINEDRAWER_H__
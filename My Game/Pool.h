@@ -0,0 +1,177 @@
+/// \file Pool.h
+/// \brief Interface and code for the handle CHandle and the pool CPool.
+
+#ifndef __L4RC_GAME_POOL_H__
+#define __L4RC_GAME_POOL_H__
+
+#include <cstdint>
+#include <vector>
+
+#include "Defines.h"
+
+static_assert(sizeof(uintptr_t) >= 8, "a handle must fit into Box2D user data");
+
+/// \brief A handle to an item in a pool.
+///
+/// A handle is the index of a slot in a pool together with the generation
+/// of the slot at the time the item was put in it. Each time an item is
+/// destroyed its slot's generation goes up, so a handle that is kept after
+/// its item is gone no longer matches the slot and is recognized as stale,
+/// even if the slot has since been reused. Generations start at 1, so a
+/// handle packed into Box2D user data is never 0, which Box2D uses to
+/// mean "no user data".
+
+struct CHandle{
+  UINT m_nIndex = 0; ///< Slot index.
+  UINT m_nGeneration = 0; ///< Slot generation, 0 for the null handle.
+
+  /// Whether this is the null handle.
+  /// \return true if this is the null handle.
+
+  bool IsNull() const{
+    return m_nGeneration == 0;
+  } //IsNull
+
+  /// Pack this handle into Box2D user data.
+  /// \return Packed handle.
+
+  uintptr_t ToUserData() const{
+    return (uintptr_t)m_nGeneration << 32 | m_nIndex;
+  } //ToUserData
+
+  /// Unpack a handle from Box2D user data.
+  /// \param n Packed handle.
+  /// \return Unpacked handle, which is the null handle if n is 0.
+
+  static CHandle FromUserData(uintptr_t n){
+    CHandle h;
+    h.m_nIndex = (UINT)(n & 0xFFFFFFFF);
+    h.m_nGeneration = (UINT)(n >> 32);
+    return h;
+  } //FromUserData
+}; //CHandle
+
+/// \brief A pool of items of type T.
+///
+/// The items are stored by value in one contiguous array of slots.
+/// Destroying an item puts its slot on a free list, and creating an item
+/// takes a slot off the free list if there is one, so once the pool has
+/// grown to its working size, creating and destroying items does not
+/// allocate memory. Items are reached through handles, which are checked
+/// against the slot's generation. Pointers returned by Get() are valid
+/// only until the next call to Create(), since that may move the slots.
+
+template<class T> class CPool{
+  private:
+    std::vector<T> m_stdItem; ///< Slots.
+    std::vector<UINT> m_stdGeneration; ///< Generation of each slot, odd if in use.
+    std::vector<UINT> m_stdFree; ///< Indices of free slots.
+
+  public:
+    void Reserve(size_t n); ///< Reserve slots.
+
+    CHandle Create(const T& t); ///< Create an item.
+    bool Destroy(CHandle h); ///< Destroy an item.
+    void Clear(); ///< Destroy all items.
+
+    bool IsValid(CHandle h) const; ///< Whether a handle is current.
+    T* Get(CHandle h); ///< Get an item.
+    const T* Get(CHandle h) const; ///< Get an item.
+
+    size_t GetCount() const; ///< Get number of items.
+}; //CPool
+
+/// Reserve space for a number of slots, so that the pool need not grow
+/// until it holds more than that many items.
+/// \param n Number of slots.
+
+template<class T> void CPool<T>::Reserve(size_t n){
+  m_stdItem.reserve(n);
+  m_stdGeneration.reserve(n);
+  m_stdFree.reserve(n);
+} //Reserve
+
+/// Put an item into a free slot, or a new one if there are no free slots.
+/// Free slots are reused in last-in first-out order.
+/// \param t Item.
+/// \return Handle to the item.
+
+template<class T> CHandle CPool<T>::Create(const T& t){
+  CHandle h;
+
+  if(m_stdFree.empty()){ //no free slots, so add one
+    h.m_nIndex = (UINT)m_stdItem.size();
+    m_stdItem.push_back(t);
+    m_stdGeneration.push_back(1);
+  } //if
+
+  else{ //reuse a free slot
+    h.m_nIndex = m_stdFree.back();
+    m_stdFree.pop_back();
+    m_stdItem[h.m_nIndex] = t;
+    m_stdGeneration[h.m_nIndex]++; //even to odd, in use
+  } //else
+
+  h.m_nGeneration = m_stdGeneration[h.m_nIndex];
+  return h;
+} //Create
+
+/// Free the slot of an item, if the handle to it is current.
+/// \param h Handle.
+/// \return true if the handle was current.
+
+template<class T> bool CPool<T>::Destroy(CHandle h){
+  if(!IsValid(h))
+    return false;
+
+  m_stdGeneration[h.m_nIndex]++; //odd to even, free
+  m_stdFree.push_back(h.m_nIndex);
+  return true;
+} //Destroy
+
+/// Free every slot. The slots themselves are kept for reuse, and every
+/// handle to the items that were in them becomes stale.
+
+template<class T> void CPool<T>::Clear(){
+  m_stdFree.clear();
+
+  for(UINT i=(UINT)m_stdGeneration.size(); i>0; i--){ //for each slot, last first
+    UINT& n = m_stdGeneration[i - 1];
+    if(n & 1)n++; //free it if in use
+    m_stdFree.push_back(i - 1);
+  } //for
+} //Clear
+
+/// Check whether a handle refers to an item that is still in the pool.
+/// \param h Handle.
+/// \return true if the handle is current.
+
+template<class T> bool CPool<T>::IsValid(CHandle h) const{
+  return !h.IsNull() && h.m_nIndex < m_stdGeneration.size() &&
+    m_stdGeneration[h.m_nIndex] == h.m_nGeneration;
+} //IsValid
+
+/// Get a pointer to an item from its handle.
+/// \param h Handle.
+/// \return Pointer to the item, or nullptr if the handle is stale.
+
+template<class T> T* CPool<T>::Get(CHandle h){
+  return IsValid(h)? &m_stdItem[h.m_nIndex]: nullptr;
+} //Get
+
+/// Get a const pointer to an item from its handle.
+/// \param h Handle.
+/// \return Pointer to the item, or nullptr if the handle is stale.
+
+template<class T> const T* CPool<T>::Get(CHandle h) const{
+  return IsValid(h)? &m_stdItem[h.m_nIndex]: nullptr;
+} //Get
+
+/// Reader function for the number of items in the pool.
+/// \return Number of items.
+
+template<class T> size_t CPool<T>::GetCount() const{
+  return m_stdItem.size() - m_stdFree.size();
+} //GetCount
+
+#endif //__L4RC_GAME_POOL_H__
@@ -0,0 +1,217 @@
+/// \file Profiler.cpp
+/// \brief Code for the profiler CProfiler and the profile scope CProfileScope.
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <vector>
+
+#include "Profiler.h"
+#include "GameDefines.h"
+
+/// \brief A profile event.
+
+struct CProfileEvent{
+  const char* m_pName = nullptr; ///< Phase name, which must outlive the profiler.
+  uint64_t m_nStart = 0; ///< Start time in nanoseconds.
+  uint64_t m_nDuration = 0; ///< Duration in nanoseconds.
+}; //CProfileEvent
+
+/// \brief A ring buffer of profile events.
+///
+/// Each thread that records events has one of these. Only that thread
+/// writes to it, and it publishes each event by incrementing the count
+/// after the event is written.
+
+struct CProfileBuffer{
+  static const size_t SIZE = 1 << 16; ///< Number of events, a power of two.
+
+  CProfileEvent m_pEvent[SIZE]; ///< Events.
+  std::atomic<uint64_t> m_nCount{0}; ///< Number of events ever recorded.
+  UINT m_nThread = 0; ///< Thread number, in the order that buffers were created.
+  CProfileBuffer* m_pNext = nullptr; ///< Next buffer in list.
+}; //CProfileBuffer
+
+/// \brief The list of ring buffers.
+///
+/// New buffers are pushed onto the front of the list with a compare and
+/// swap. The buffers last as long as the program, since a thread that
+/// has finished may have left events in its buffer that are yet to be saved.
+
+struct CProfileBufferList{
+  std::atomic<CProfileBuffer*> m_pHead{nullptr}; ///< First buffer.
+  std::atomic<UINT> m_nThreads{0}; ///< Number of buffers.
+
+  ~CProfileBufferList(){
+    CProfileBuffer* p = m_pHead.load();
+
+    while(p){ //for each buffer
+      CProfileBuffer* q = p->m_pNext;
+      delete p;
+      p = q;
+    } //while
+  } //destructor
+}; //CProfileBufferList
+
+static CProfileBufferList g_cBufferList; ///< Ring buffers of all threads.
+static thread_local CProfileBuffer* g_pBuffer = nullptr; ///< This thread's ring buffer.
+static std::atomic<bool> g_bEnabled{false}; ///< Whether recording is on.
+
+/// Time that the program started, which the times of events are measured from.
+
+static const std::chrono::steady_clock::time_point g_tStart = std::chrono::steady_clock::now();
+
+/// Writer function for whether events are recorded.
+/// \param b true to record events.
+
+void CProfiler::SetEnabled(bool b){
+  g_bEnabled.store(b, std::memory_order_relaxed);
+} //SetEnabled
+
+/// Reader function for whether events are recorded.
+/// \return true if events are recorded.
+
+bool CProfiler::IsEnabled(){
+  return g_bEnabled.load(std::memory_order_relaxed);
+} //IsEnabled
+
+/// Get the time since the program started.
+/// \return Time in nanoseconds.
+
+uint64_t CProfiler::Now(){
+  return (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(
+    std::chrono::steady_clock::now() - g_tStart).count();
+} //Now
+
+/// Record an event in this thread's ring buffer, creating the buffer if
+/// this thread hasn't recorded anything before.
+/// \param name Phase name, which must outlive the profiler, such as a string literal.
+/// \param start Start time in nanoseconds.
+/// \param duration Duration in nanoseconds.
+
+void CProfiler::Record(const char* name, uint64_t start, uint64_t duration){
+  CProfileBuffer* p = g_pBuffer;
+
+  if(p == nullptr){ //first event on this thread
+    p = g_pBuffer = new CProfileBuffer;
+    p->m_nThread = g_cBufferList.m_nThreads.fetch_add(1);
+    p->m_pNext = g_cBufferList.m_pHead.load();
+
+    while(!g_cBufferList.m_pHead.compare_exchange_weak(p->m_pNext, p));
+  } //if
+
+  const uint64_t n = p->m_nCount.load(std::memory_order_relaxed); //only this thread writes it
+  p->m_pEvent[n & (CProfileBuffer::SIZE - 1)] = {name, start, duration};
+  p->m_nCount.store(n + 1, std::memory_order_release);
+} //Record
+
+/// Record the phases of a physics step from Box2D's profile of it. Box2D
+/// gives only how long each phase took, in milliseconds, so they are laid
+/// out one after the other from the start of the step in the order that
+/// Box2D does them: collide, then solve, which ends by updating the broad
+/// phase, then solve time of impact.
+/// \param p Box2D's profile of the step.
+/// \param start Start time of the step in nanoseconds.
+
+void CProfiler::RecordPhysics(const b2Profile& p, uint64_t start){
+  const uint64_t collide = (uint64_t)(1000000.0*p.collide); //collide time in nanoseconds
+  const uint64_t solve = (uint64_t)(1000000.0*p.solve); //solve time in nanoseconds
+  const uint64_t broadphase = (uint64_t)(1000000.0*p.broadphase); //broad phase time in nanoseconds
+  const uint64_t toi = (uint64_t)(1000000.0*p.solveTOI); //solve time of impact time in nanoseconds
+
+  Record("Collide", start, collide);
+  Record("Solve", start + collide, solve);
+  Record("Broadphase", start + collide + solve - std::min(broadphase, solve), broadphase);
+  Record("SolveTOI", start + collide + solve, toi);
+} //RecordPhysics
+
+/// Copy the events out of every ring buffer. The events that a thread
+/// recorded while they were being copied may have overwritten some of the
+/// copies, so the count is read again afterwards and those are dropped,
+/// along with the one that may be being written.
+/// \param v [out] Events.
+/// \param t [out] Thread number of each event.
+
+static void GetEvents(std::vector<CProfileEvent>& v, std::vector<UINT>& t){
+  v.clear();
+  t.clear();
+
+  for(CProfileBuffer* p=g_cBufferList.m_pHead.load(); p; p=p->m_pNext){ //for each buffer
+    const uint64_t n = p->m_nCount.load(std::memory_order_acquire); //events recorded
+    const uint64_t first = n > CProfileBuffer::SIZE? n - CProfileBuffer::SIZE: 0; //oldest kept
+    const size_t base = v.size(); //where this buffer's events start
+
+    for(uint64_t i=first; i<n; i++) //for each event
+      v.push_back(p->m_pEvent[i & (CProfileBuffer::SIZE - 1)]);
+
+    const uint64_t n2 = p->m_nCount.load(std::memory_order_acquire); //events recorded since
+    const uint64_t end = n2 == n? n: n2 + 1; //one past the last event that may have been written
+    const uint64_t lost = end > CProfileBuffer::SIZE + first? end - CProfileBuffer::SIZE - first: 0; //events overwritten
+    v.erase(v.begin() + base, v.begin() + base + (size_t)std::min(lost, n - first));
+    t.resize(v.size(), p->m_nThread);
+  } //for
+} //GetEvents
+
+/// Save the events of every thread as comma-separated values, with times
+/// in microseconds.
+/// \param fname File name.
+/// \return true if the file was written.
+
+bool CProfiler::SaveCSV(const std::string& fname){
+  std::vector<CProfileEvent> v; //events
+  std::vector<UINT> t; //thread numbers
+  GetEvents(v, t);
+
+  FILE* output = fopen(fname.c_str(), "wt");
+  if(output == nullptr)return false;
+
+  fprintf(output, "thread,phase,start (us),duration (us)\n");
+
+  for(size_t i=0; i<v.size(); i++) //for each event
+    fprintf(output, "%u,%s,%.3f,%.3f\n", t[i], v[i].m_pName,
+      v[i].m_nStart/1000.0, v[i].m_nDuration/1000.0);
+
+  return fclose(output) == 0;
+} //SaveCSV
+
+/// Save the events of every thread as a Chrome trace, which is a JSON
+/// file of complete events with times in microseconds.
+/// \param fname File name.
+/// \return true if the file was written.
+
+bool CProfiler::SaveTrace(const std::string& fname){
+  std::vector<CProfileEvent> v; //events
+  std::vector<UINT> t; //thread numbers
+  GetEvents(v, t);
+
+  FILE* output = fopen(fname.c_str(), "wt");
+  if(output == nullptr)return false;
+
+  fprintf(output, "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[");
+
+  for(size_t i=0; i<v.size(); i++) //for each event
+    fprintf(output, "%s\n{\"name\":\"%s\",\"ph\":\"X\",\"pid\":1,\"tid\":%u,\"ts\":%.3f,\"dur\":%.3f}",
+      i > 0? ",": "", v[i].m_pName, t[i], v[i].m_nStart/1000.0, v[i].m_nDuration/1000.0);
+
+  fprintf(output, "\n]}\n");
+  return fclose(output) == 0;
+} //SaveTrace
+
+/// Note the start time, if recording is on.
+/// \param name Phase name, which must outlive the profiler, such as a string literal.
+
+CProfileScope::CProfileScope(const char* name):
+  m_pName(name),
+  m_bEnabled(CProfiler::IsEnabled())
+{
+  if(m_bEnabled)
+    m_nStart = CProfiler::Now();
+} //constructor
+
+/// Record the event, if recording was on at the start.
+
+CProfileScope::~CProfileScope(){
+  if(m_bEnabled)
+    CProfiler::Record(m_pName, m_nStart, CProfiler::Now() - m_nStart);
+} //destructor
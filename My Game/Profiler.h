@@ -0,0 +1,55 @@
+/// \file Profiler.h
+/// \brief Interface for the profiler CProfiler and the profile scope CProfileScope.
+
+#ifndef __L4RC_GAME_PROFILER_H__
+#define __L4RC_GAME_PROFILER_H__
+
+#include <cstdint>
+#include <string>
+
+struct b2Profile;
+
+/// \brief The profiler.
+///
+/// The profiler records how long each phase of a frame takes. Each event
+/// is a phase name, a start time, and a duration, and goes into a ring
+/// buffer that belongs to the thread that recorded it, so recording
+/// needs no lock. A thread's ring buffer is created the first time that
+/// it records an event and linked into a list of buffers without a lock
+/// either. Once a ring buffer is full, each new event overwrites the
+/// oldest. The events can be saved as comma-separated values or as a
+/// Chrome trace, which can be opened in `chrome://tracing` or Perfetto.
+/// Recording is off until it is turned on, and while it is off a profile
+/// scope costs one flag test.
+
+class CProfiler{
+  public:
+    static void SetEnabled(bool b); ///< Turn recording on or off.
+    static bool IsEnabled(); ///< Whether recording is on.
+
+    static uint64_t Now(); ///< Get the time.
+    static void Record(const char* name, uint64_t start, uint64_t duration); ///< Record an event.
+    static void RecordPhysics(const b2Profile& p, uint64_t start); ///< Record the phases of a physics step.
+
+    static bool SaveCSV(const std::string& fname); ///< Save events as comma-separated values.
+    static bool SaveTrace(const std::string& fname); ///< Save events as a Chrome trace.
+}; //CProfiler
+
+/// \brief A profile scope.
+///
+/// A profile scope records an event from when it is constructed until it
+/// is destroyed, so a phase can be timed by putting a profile scope at
+/// the start of a block.
+
+class CProfileScope{
+  private:
+    const char* m_pName = nullptr; ///< Phase name.
+    uint64_t m_nStart = 0; ///< Start time.
+    bool m_bEnabled = false; ///< Whether recording was on at the start.
+
+  public:
+    CProfileScope(const char* name); ///< Constructor.
+    ~CProfileScope(); ///< Destructor.
+}; //CProfileScope
+
+#endif //__L4RC_GAME_PROFILER_H__
@@ -0,0 +1,375 @@
+/// \file Prototypes.cpp
+/// \brief Code for the shape prototype registry CPrototypes.
+
+#include "Prototypes.h"
+#include "Common.h"
+#include "HullFile.h"
+#include "SpriteSizes.h"
+
+/// Ramp vertices in the artist's coordinates, which are pixels from the
+/// top left of the sprite.
+
+static const Vector2 vRamp[] = {
+  Vector2(199.0f, 0.0f), Vector2(0.0f, 199.0f), Vector2(199.0f, 199.0f)
+}; //vRamp
+
+/// Vertices of the top of a pin in the artist's coordinates.
+
+static const Vector2 vPinTop[] = {
+  Vector2(7.0f, 74.0f), Vector2(0.0f, 56.0f), Vector2(0.0f, 48.0f),
+  Vector2(8.0f, 22.0f), Vector2(16.0f, 22.0f), Vector2(24.0f, 48.0f),
+  Vector2(24.0f, 56.0f), Vector2(18.0f, 74.0f)
+}; //vPinTop
+
+/// Vertices of the bottom of a pin in the artist's coordinates.
+
+static const Vector2 vPinBottom[] = {
+  Vector2(8.0f, 21.0f), Vector2(5.0f, 14.0f), Vector2(5.0f, 8.0f),
+  Vector2(10.0f, 0.0f), Vector2(14.0f, 0.0f), Vector2(19.0f, 8.0f),
+  Vector2(19.0f, 14.0f), Vector2(16.0f, 21.0f)
+}; //vPinBottom
+
+/// Vertices of the catapult arm in the artist's coordinates.
+
+static const Vector2 vArm[] = {
+  Vector2(0.0f, 65.0f), Vector2(159.0f, 65.0f),
+  Vector2(159.0f, 79.0f), Vector2(0.0f, 79.0f)
+}; //vArm
+
+/// Vertices of the catapult's cup, which is the upright at the end of its
+/// arm, in the artist's coordinates.
+
+static const Vector2 vCup[] = {
+  Vector2(142.0f, 0.0f), Vector2(159.0f, 0.0f),
+  Vector2(159.0f, 79.0f), Vector2(142.0f, 79.0f)
+}; //vCup
+
+/// Whether a point is inside a convex polygon shape, or on its boundary.
+/// \param s Polygon shape.
+/// \param v Point.
+/// \return true if the point is inside the polygon.
+
+static bool Contains(const b2PolygonShape& s, const b2Vec2& v){
+  for(int32 i=0; i<s.m_count; i++) //for each side
+    if(b2Dot(s.m_normals[i], v - s.m_vertices[i]) > 0.0f)
+      return false;
+
+  return true;
+} //Contains
+
+/// Add a fixture with a given shape to a prototype. The fixture definition
+/// starts out with Box2D's defaults.
+/// \param p Prototype.
+/// \param s Shape, which must be in the prototype.
+/// \return Reference to the fixture definition.
+
+b2FixtureDef& CPrototypes::AddFixture(CPrototype& p, const b2Shape& s){
+  b2FixtureDef& fd = p.m_cFixture[p.m_nFixtures++];
+  fd = b2FixtureDef();
+  fd.shape = &s;
+  return fd;
+} //AddFixture
+
+/// Add a box the size of a sprite to a prototype.
+/// \param p Prototype.
+/// \param w Width in renderer units.
+/// \param h Height in renderer units.
+/// \return Reference to the fixture definition.
+
+b2FixtureDef& CPrototypes::AddBox(CPrototype& p, float w, float h){
+  b2PolygonShape& s = p.m_cPolygon[p.m_nFixtures];
+  s.SetAsBox(RW2PW(w)/2.0f, RW2PW(h)/2.0f);
+  return AddFixture(p, s);
+} //AddBox
+
+/// Add a circle the size of a sprite to a prototype. A prototype can have
+/// only one circle.
+/// \param p Prototype.
+/// \param d Diameter in renderer units.
+/// \return Reference to the fixture definition.
+
+b2FixtureDef& CPrototypes::AddCircle(CPrototype& p, float d){
+  p.m_cCircle.m_radius = RW2PW(d)/2.0f;
+  return AddFixture(p, p.m_cCircle);
+} //AddCircle
+
+/// Add a polygon to a prototype. The vertices are in the artist's
+/// coordinates, which are relative to the top left of the sprite with
+/// y pointing down. Physics World coordinates are relative to the center
+/// of the sprite with y pointing up, so each vertex is moved by half the
+/// sprite size, flipped, and scaled.
+/// \param p Prototype.
+/// \param v Array of vertices in the artist's coordinates.
+/// \param n Number of vertices.
+/// \param w Sprite width in renderer units.
+/// \param h Sprite height in renderer units.
+/// \return Reference to the fixture definition.
+
+b2FixtureDef& CPrototypes::AddPolygon(CPrototype& p, const Vector2* v, UINT n,
+  float w, float h)
+{
+  b2Vec2 vertex[b2_maxPolygonVertices]; //vertices in Physics World units
+
+  for(UINT i=0; i<n; i++) //for each vertex
+    vertex[i].Set(RW2PW(v[i].x - w/2.0f), RW2PW(h/2.0f - v[i].y));
+
+  b2PolygonShape& s = p.m_cPolygon[p.m_nFixtures];
+  s.Set(vertex, (int32)n);
+  return AddFixture(p, s);
+} //AddPolygon
+
+/// Replace the hand-made polygons of a prototype with the hulls of its
+/// sprite from a hull file. Prototypes with a circle, and sprites with more
+/// hulls than a prototype can hold, are left alone. Each hull gets the
+/// density, friction, restitution, and filter of the hand-made polygon that
+/// its middle is in, so that parts of an object that were made to behave
+/// differently still do, or of the first polygon if its middle is in none.
+/// \param t Sprite type.
+/// \param hulls Hull file.
+/// \param w Sprite width in renderer units.
+/// \param h Sprite height in renderer units.
+
+void CPrototypes::AddHulls(eSprite t, const CHullFile& hulls, float w, float h){
+  CPrototype& p = m_cPrototype[(UINT)t];
+  const UINT n = hulls.GetHullCount(t); //number of hulls
+  if(n == 0 || n > CPrototype::MAXFIXTURES || p.m_nFixtures == 0)return;
+
+  for(UINT i=0; i<p.m_nFixtures; i++) //keep circles
+    if(p.m_cFixture[i].shape == &p.m_cCircle)return;
+
+  b2FixtureDef fd[CPrototype::MAXFIXTURES]; //fixture definition for each hull
+
+  for(UINT i=0; i<n; i++){ //for each hull
+    const CHullRecord& r = hulls.GetHull(t, i);
+    b2Vec2 middle(0.0f, 0.0f); //average of vertices in Physics World units
+
+    for(UINT j=0; j<r.m_nCount; j++)
+      middle += b2Vec2(RW2PW(r.m_nVertex[j][0] - w/2.0f), RW2PW(h/2.0f - r.m_nVertex[j][1]));
+
+    middle *= 1.0f/r.m_nCount;
+
+    UINT k = 0; //hand-made polygon that it is in
+    while(k < p.m_nFixtures && !Contains(p.m_cPolygon[k], middle))k++;
+    fd[i] = p.m_cFixture[k < p.m_nFixtures? k: 0];
+  } //for
+
+  p.m_nFixtures = 0;
+
+  for(UINT i=0; i<n; i++){ //for each hull
+    const CHullRecord& r = hulls.GetHull(t, i);
+    Vector2 v[CHullFile::MAXVERTICES]; //vertices in the artist's coordinates
+
+    for(UINT j=0; j<r.m_nCount; j++)
+      v[j] = Vector2(r.m_nVertex[j][0], r.m_nVertex[j][1]);
+
+    b2FixtureDef& f = AddPolygon(p, v, r.m_nCount, w, h);
+    const b2Shape* s = f.shape; //the new shape
+    f = fd[i];
+    f.shape = s;
+  } //for
+} //AddHulls
+
+/// Build the prototypes from the sprite sizes, and from the hulls in a
+/// hull file if there is one. This must be done after the sprite size
+/// table is filled in and before the level is built. It may be done again
+/// if the sprite sizes or hulls change.
+/// \param sizes Sprite size table.
+/// \param hulls Pointer to hull file, nullptr for none.
+
+void CPrototypes::Build(const CSpriteSizes& sizes, const CHullFile* hulls){
+  for(CPrototype& p: m_cPrototype){ //start afresh
+    p.m_eType = b2_staticBody;
+    p.m_nFixtures = 0;
+  } //for
+
+  float w, h; //width and height of sprite
+
+  //pig, which is the button at the end of the machine
+
+  sizes.GetSize(eSprite::Pig, w, h);
+  b2FixtureDef* fd = &AddBox(m_cPrototype[(UINT)eSprite::Pig], w, h);
+  fd->density = 1.0f;
+  fd->restitution = 0.2f;
+
+  //platforms
+
+  for(eSprite t: {eSprite::Platform, eSprite::Smallplatform}){
+    sizes.GetSize(t, w, h);
+    fd = &AddBox(m_cPrototype[(UINT)t], w, h);
+    fd->density = 10.0f;
+    fd->restitution = 0.1f;
+  } //for
+
+  //ramp
+
+  sizes.GetSize(eSprite::Ramp, w, h);
+  fd = &AddPolygon(m_cPrototype[(UINT)eSprite::Ramp], vRamp, 3, w, h);
+  fd->density = 10.0f;
+  fd->restitution = 0.3f;
+  fd->filter.groupIndex = -10;
+
+  //bumper, whose restitution is a tuning parameter
+
+  sizes.GetSize(eSprite::Bumper, w, h);
+  fd = &AddBox(m_cPrototype[(UINT)eSprite::Bumper], w, h);
+  fd->density = 10.0f;
+  fd->restitution = CTuning().m_fBumperRestitution;
+  fd->filter.groupIndex = -10;
+
+  //circle bumper
+
+  fd = &AddCircle(m_cPrototype[(UINT)eSprite::Circlebumper],
+    sizes.GetWidth(eSprite::Circlebumper));
+  fd->density = 10.0f;
+  fd->restitution = 1.0f;
+
+  //ball
+
+  CPrototype* p = &m_cPrototype[(UINT)eSprite::Ball];
+  p->m_eType = b2_dynamicBody;
+  fd = &AddCircle(*p, sizes.GetWidth(eSprite::Ball));
+  fd->density = 1.0f;
+  fd->restitution = 0.3f;
+
+  //heavy ball, whose density is a tuning parameter
+
+  p = &m_cPrototype[(UINT)eSprite::Heavyball];
+  p->m_eType = b2_dynamicBody;
+  fd = &AddCircle(*p, sizes.GetWidth(eSprite::Heavyball));
+  fd->density = CTuning().m_fHeavyBallDensity;
+  fd->restitution = 0.3f;
+
+  //bird
+
+  p = &m_cPrototype[(UINT)eSprite::Bird];
+  p->m_eType = b2_dynamicBody;
+  fd = &AddCircle(*p, sizes.GetWidth(eSprite::Bird));
+  fd->density = 1.0f;
+  fd->restitution = 0.1f;
+
+  //pin, which is the top and bottom of a bowling pin
+
+  p = &m_cPrototype[(UINT)eSprite::Pin];
+  p->m_eType = b2_dynamicBody;
+  sizes.GetSize(eSprite::Pin, w, h);
+
+  for(const Vector2* v: {vPinTop, vPinBottom}){ //for each part of the pin
+    fd = &AddPolygon(*p, v, 8, w, h);
+    fd->density = 1.0f;
+    fd->restitution = 0.1f;
+  } //for
+
+  //blocks and sticks for towers
+
+  for(eSprite t: {eSprite::Block, eSprite::Stick}){
+    p = &m_cPrototype[(UINT)t];
+    p->m_eType = b2_dynamicBody;
+    sizes.GetSize(t, w, h);
+    fd = &AddBox(*p, w, h);
+    fd->density = 0.2f;
+    fd->restitution = 0.5f;
+    fd->friction = 1.0f;
+  } //for
+
+  //propeller, which is the same size as a platform
+
+  p = &m_cPrototype[(UINT)eSprite::Propeller];
+  p->m_eType = b2_dynamicBody;
+  sizes.GetSize(eSprite::Platform, w, h);
+  fd = &AddBox(*p, w, h);
+  fd->density = 10.0f;
+  fd->restitution = 0.001f;
+  fd->filter.groupIndex = -10;
+
+  //catapult base, which is a triangle
+
+  p = &m_cPrototype[(UINT)eSprite::Base];
+  p->m_eType = b2_dynamicBody;
+  sizes.GetSize(eSprite::Base, w, h);
+  const Vector2 vBase[] = {Vector2(0.0f, h), Vector2(w, h), Vector2(w/2.0f, 0.0f)};
+  fd = &AddPolygon(*p, vBase, 3, w, h);
+  fd->density = 1.0f;
+  fd->restitution = 0.4f;
+  fd->filter.groupIndex = -5;
+
+  //catapult wheel
+
+  p = &m_cPrototype[(UINT)eSprite::Wheel];
+  p->m_eType = b2_dynamicBody;
+  fd = &AddCircle(*p, sizes.GetWidth(eSprite::Wheel));
+  fd->density = 0.8f;
+  fd->restitution = 0.6f;
+  fd->filter.groupIndex = -5;
+
+  //catapult arm and cup
+
+  p = &m_cPrototype[(UINT)eSprite::Catapult];
+  p->m_eType = b2_dynamicBody;
+  sizes.GetSize(eSprite::Catapult, w, h);
+
+  fd = &AddPolygon(*p, vArm, 4, w, h);
+  fd->density = 1.0f;
+  fd->restitution = 0.5f;
+  fd->filter.groupIndex = -5;
+
+  fd = &AddPolygon(*p, vCup, 4, w, h);
+  fd->density = 1.0f;
+  fd->restitution = 0.0f;
+  fd->filter.groupIndex = -5;
+
+  //tighter polygons from the hull file
+
+  if(hulls)
+    for(UINT i=0; i<(UINT)eSprite::Size; i++){ //for each sprite type
+      sizes.GetSize((eSprite)i, w, h);
+      AddHulls((eSprite)i, *hulls, w, h);
+    } //for
+
+  m_bBuilt = true;
+} //Build
+
+/// Mark the prototypes as needing to be built again, for example because
+/// a new hull file has been loaded.
+
+void CPrototypes::Clear(){
+  m_bBuilt = false;
+} //Clear
+
+/// Reader function for whether the prototypes have been built.
+/// \return true if they have been built.
+
+bool CPrototypes::IsBuilt() const{
+  return m_bBuilt;
+} //IsBuilt
+
+/// Reader function for the prototype for a sprite type.
+/// \param t Sprite type.
+/// \return Reference to the prototype, which has no fixtures if there
+///   is no prototype for that sprite type.
+
+const CPrototype& CPrototypes::Get(eSprite t) const{
+  return m_cPrototype[(UINT)t];
+} //Get
+
+/// Create a Physics World body from the prototype for a sprite type.
+/// \param w Pointer to Physics World.
+/// \param t Sprite type.
+/// \param pos Position in Physics World units.
+/// \param a Orientation in radians.
+/// \return Pointer to the new body.
+
+b2Body* CPrototypes::Create(b2World* w, eSprite t, const b2Vec2& pos, float a) const{
+  const CPrototype& p = m_cPrototype[(UINT)t];
+
+  b2BodyDef bd;
+  bd.type = p.m_eType;
+  bd.position = pos;
+  bd.angle = a;
+
+  b2Body* pBody = w->CreateBody(&bd);
+
+  for(UINT i=0; i<p.m_nFixtures; i++) //for each fixture
+    pBody->CreateFixture(&p.m_cFixture[i]);
+
+  return pBody;
+} //Create
@@ -0,0 +1,68 @@
+/// \file Prototypes.h
+/// \brief Interface for the shape prototype registry CPrototypes.
+
+#ifndef __L4RC_GAME_PROTOTYPES_H__
+#define __L4RC_GAME_PROTOTYPES_H__
+
+#include "GameDefines.h"
+
+class CSpriteSizes; //forward declarations
+class CHullFile;
+
+/// \brief A shape prototype.
+///
+/// A shape prototype is what it takes to make the Physics World body of one
+/// sort of object: its body type, and up to MAXFIXTURES shapes with a
+/// fixture definition for each of them. The fixture definitions point to
+/// the shapes, so a prototype must not be copied.
+
+struct CPrototype{
+  static const UINT MAXFIXTURES = 8; ///< Most fixtures in a prototype.
+
+  b2BodyType m_eType = b2_staticBody; ///< Body type.
+  UINT m_nFixtures = 0; ///< Number of fixtures.
+  b2PolygonShape m_cPolygon[MAXFIXTURES]; ///< Polygon shapes.
+  b2CircleShape m_cCircle; ///< Circle shape.
+  b2FixtureDef m_cFixture[MAXFIXTURES]; ///< Fixture definitions.
+
+  CPrototype() = default; ///< Default constructor.
+  CPrototype(const CPrototype&) = delete; ///< No copy constructor.
+  CPrototype& operator=(const CPrototype&) = delete; ///< No assignment.
+}; //CPrototype
+
+/// \brief The shape prototype registry.
+///
+/// Most of the objects in the machine have shapes that are made to fit their
+/// sprites, so working out a shape takes the sprite size and, for polygons,
+/// converting every vertex from the artist's coordinates to Physics World
+/// coordinates. The shape prototype registry does that once for each sprite
+/// type, after the sprite size table is filled in, so that building a level
+/// only has to create bodies and copy their fixtures from the prototypes.
+/// Sprite types that have no prototype, such as the pulley's baskets, are
+/// still built by hand. The polygons of the prototypes are hand-made, but
+/// they can be replaced by tighter ones from a hull file made from the
+/// sprites' alpha masks. Circles are kept, since they fit round sprites
+/// better than any polygon.
+
+class CPrototypes{
+  private:
+    CPrototype m_cPrototype[(UINT)eSprite::Size]; ///< Prototypes by sprite type.
+    bool m_bBuilt = false; ///< Whether the prototypes have been built.
+
+    b2FixtureDef& AddFixture(CPrototype& p, const b2Shape& s); ///< Add a fixture.
+    b2FixtureDef& AddBox(CPrototype& p, float w, float h); ///< Add a box.
+    b2FixtureDef& AddCircle(CPrototype& p, float d); ///< Add a circle.
+    b2FixtureDef& AddPolygon(CPrototype& p, const Vector2* v, UINT n,
+      float w, float h); ///< Add a polygon.
+    void AddHulls(eSprite t, const CHullFile& hulls, float w, float h); ///< Use hulls.
+
+  public:
+    void Build(const CSpriteSizes& sizes, const CHullFile* hulls=nullptr); ///< Build the prototypes.
+    void Clear(); ///< Mark the prototypes as needing to be built again.
+    bool IsBuilt() const; ///< Whether the prototypes have been built.
+
+    const CPrototype& Get(eSprite t) const; ///< Get a prototype.
+    b2Body* Create(b2World* w, eSprite t, const b2Vec2& pos, float a=0.0f) const; ///< Create a body.
+}; //CPrototypes
+
+#endif //__L4RC_GAME_PROTOTYPES_H__
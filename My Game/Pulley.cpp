@@ -2,22 +2,31 @@
 
 #include "GameDefines.h"
 #include "ObjectManager.h"
-#include "Renderer.h"
+#include "SpriteSizes.h"
 #include "ComponentIncludes.h"
 
+/// Number of points in the rope.
+
+static const UINT nRopePoints = 48;
+
+/// The rope goes from one basket up to the side of a wheel, over the top
+/// of it, across to the other wheel, over that, and down to the other
+/// basket. It is a rope component that is only for show, and the pulley
+/// joint says how long it is and where its ends are.
 /// \param x X coordinate in Physics World units.
 /// \param y Y coordinate in Physics World units.
 /// \param w Pulley wheel horizontal separation in Physics World units.
 
-CPulley::CPulley(float x, float y, float w) {
+CPulley::CPulley(CContext& c, float x, float y, float w):
+    CCommon(c), m_cRope(nRopePoints) {
     //crate calculations
-    const float fCrateWidth = m_pRenderer->GetWidth(eSprite::Basket); //crate width in Render World
-    const float fCrateHt = m_pRenderer->GetHeight(eSprite::Basket); //crate height in Render World
+    const float fCrateWidth = m_pSpriteSizes->GetWidth(eSprite::Basket); //crate width in Render World
+    const float fCrateHt = m_pSpriteSizes->GetHeight(eSprite::Basket); //crate height in Render World
     const float fCrateWidth2 = RW2PW(fCrateWidth) / 2.0f; //crate half width in Physics World
     const float fCrateHt2 = RW2PW(fCrateHt) / 2.0f; //crate half height in Physics World
 
     //pulley wheel calculations
-    const float fWheelDiam = m_pRenderer->GetWidth(eSprite::Pulleywheel); //pulley wheel diameter in Render World
+    const float fWheelDiam = m_pSpriteSizes->GetWidth(eSprite::Pulleywheel); //pulley wheel diameter in Render World
     m_fWheelRad = RW2PW(fWheelDiam) / 2.0f - RW2PW(4); //pulley wheel radius in Physics World
     const float fWheelSep2 = w / 2.0f; //half pulley wheel separation in Physics World
     const float fWheelAlt = 2.0f * (y - 1.2f * m_fWheelRad); //wheel altitude on screen
@@ -31,8 +40,8 @@ CPulley::CPulley(float x, float y, float w) {
     //create bodies
     b2Body* pCrate0 = CreateBasket(vCratePos0.x, vCratePos0.y);
     b2Body* pCrate1 = CreateBasket(vCratePos1.x, vCratePos1.y);
-    m_pWheel0 = CreateWheel(vWheelPos0.x, vWheelPos0.y);
-    m_pWheel1 = CreateWheel(vWheelPos1.x, vWheelPos1.y);
+    m_pWheel0 = CreateWheel(vWheelPos0.x, vWheelPos0.y, 0.0f, m_hWheel0);
+    m_pWheel1 = CreateWheel(vWheelPos1.x, vWheelPos1.y, 2.4f, m_hWheel1); // slightly offset right wheel
 
     //calculate anchor points
     const b2Vec2 vCrateAnchor0 = vCratePos0 + b2Vec2(0.0f, fCrateHt2);
@@ -50,38 +59,57 @@ CPulley::CPulley(float x, float y, float w) {
     m_pJoint = (b2PulleyJoint*)m_pPhysicsWorld->CreateJoint(&jd);
     m_fJointLenA = m_pJoint->GetCurrentLengthA();
 
-    //create lines to represent the rope
-    //rope from wheel0 to crate0
-    b2Vec2 offset0 = b2Vec2(-m_fWheelRad, 0.0f);
-    b2Vec2 offset1 = b2Vec2(0.0f, 0.0f);//fCrateHt2 - RW2PW(4));
-    m_pObjectManager->CreateLine(m_pWheel0, offset0, false, pCrate0, offset1, true);
+    //create the rope, which goes over the wheels and quarter of the way round each
+    const float fWheelRad = PW2RW(m_fWheelRad); //wheel radius in Render World
+    m_fRopeSpan = PW2RW(w) + XM_PI * fWheelRad;
 
-    //rope from wheel1 to crate1
-    offset0 = b2Vec2(m_fWheelRad, 0.0f);
-    offset1 = b2Vec2(0.0f, 0.0f);
-    m_pObjectManager->CreateLine(m_pWheel1, offset0, false, pCrate1, offset1, true);
+    m_cRope.AddCircle(PW2RW(vWheelPos0), fWheelRad);
+    m_cRope.AddCircle(PW2RW(vWheelPos1), fWheelRad);
+    Reset();
 
-    //rope from one pulley wheel across to the other
-    offset0 = b2Vec2(0.0f, m_fWheelRad);
-    m_pObjectManager->CreateLine(m_pWheel0, offset0, false, m_pWheel1, offset0, false);
+    m_pObjectManager->AddRope(&m_cRope);
 } //constructor
 
+/// Lay the rope out along the path it takes when it is taut, with the
+/// curves over the wheels cut short, and forget how far the wheels have
+/// turned, since they are back where they were when they were made.
+
+void CPulley::Reset() {
+    const float r = PW2RW(m_fWheelRad); //wheel radius in Render World
+    const float d = r * 0.70710678f; //wheel radius over root 2
+    const Vector2 c0 = PW2RW(m_pWheel0->GetPosition()); //left wheel center
+    const Vector2 c1 = PW2RW(m_pWheel1->GetPosition()); //right wheel center
+
+    const Vector2 path[] = {
+        PW2RW(m_pJoint->GetAnchorA()), //left basket
+        c0 + Vector2(-r, 0.0f), c0 + Vector2(-d, d), c0 + Vector2(0.0f, r), //over left wheel
+        c1 + Vector2(0.0f, r), c1 + Vector2(d, d), c1 + Vector2(r, 0.0f), //over right wheel
+        PW2RW(m_pJoint->GetAnchorB()) //right basket
+    }; //path
+
+    m_cRope.Reset(path, sizeof(path) / sizeof(path[0]));
+    m_fTheta = 0;
+} //Reset
+
 /// The pulley wheels are going to be static objects that we
 /// rotate ourselves depending on the positions of the objects
 /// that the pulley is attached to.
 /// \param x X coordinate in Physics World units.
 /// \param y Y coordinate in Physics World units.
+/// \param a Orientation.
+/// \param h [out] Handle of the wheel's object.
 /// \return Pointer to physics body.
 
-b2Body* CPulley::CreateWheel(float x, float y) {
+b2Body* CPulley::CreateWheel(float x, float y, float a, CHandle& h) {
     // body definition
     b2BodyDef bd;
     bd.type = b2_staticBody;
     bd.position.Set(x, y);
+    bd.angle = a;
 
     // create body
     b2Body* p = m_pPhysicsWorld->CreateBody(&bd);
-    m_pObjectManager->CreateObject(eSprite::Pulleywheel, p);
+    h = m_pObjectManager->CreateObject(eSprite::Pulleywheel, p);
 
     return p;
 } //CreateWheel
@@ -98,10 +126,9 @@ b2Body* CPulley::CreateBasket(float x, float y) {
 
     // create body
     b2Body* p = m_pPhysicsWorld->CreateBody(&bd);
-    m_pObjectManager->CreateObject(eSprite::Basket, p);
 
-    float cw = RW2PW(m_pRenderer->GetWidth(eSprite::Basket) / 2.0f); //crate half width 
-    float ch = RW2PW(m_pRenderer->GetHeight(eSprite::Basket) / 2.0f); //crate half height 
+    float cw = RW2PW(m_pSpriteSizes->GetWidth(eSprite::Basket) / 2.0f); //crate half width 
+    float ch = RW2PW(m_pSpriteSizes->GetHeight(eSprite::Basket) / 2.0f); //crate half height 
     const float sh = RW2PW(5) / 2.0f; //half height of crate floor
 
     // shape and fixture definition
@@ -121,19 +148,44 @@ b2Body* CPulley::CreateBasket(float x, float y) {
 
     // create fixture
     p->CreateFixture(&fd);
+    m_pObjectManager->CreateObject(eSprite::Basket, p);
     p->SetLinearDamping(0.2f);
     p->SetAngularDamping(0.1f);
 
     return p;
 }
 
-/// Animate the pulley wheels by setting their orientations
-/// to reflect the amount of rope that has gone over them.
-
-void CPulley::move() {
+/// Move the rope along by one time step with its ends on the baskets and
+/// its length set from the pulley joint, then
+/// animate the pulley wheels by setting their orientations
+/// to reflect the amount of rope that has gone over them. Setting the
+/// transform of a body makes Physics World move it in the broad phase,
+/// so it is only done when the wheels have to turn. The rope can't
+/// move while both baskets are asleep, and most of the time it doesn't.
+/// The wheels are static, so object manager is told that they moved.
+/// The rope goes to sleep by itself once it stops moving.
+/// \param t Time step in seconds.
+
+void CPulley::move(float t) {
     const float fLenA = m_pJoint->GetCurrentLengthA(); //current length of left rope
+    const float fLenB = m_pJoint->GetCurrentLengthB(); //current length of right rope
+
+    m_cRope.SetLength(PW2RW(fLenA + fLenB) + m_fRopeSpan);
+    m_cRope.Step(PW2RW(m_pJoint->GetAnchorA()), PW2RW(m_pJoint->GetAnchorB()), t);
+
+    if (!m_pJoint->GetBodyA()->IsAwake() && !m_pJoint->GetBodyB()->IsAwake())
+        return; // baskets asleep, so wheels can't turn
+
     const float theta = (fLenA - m_fJointLenA) / m_fWheelRad; //new wheel orientation
 
+    if (theta == m_fTheta)
+        return; // wheels already there
+
+    m_fTheta = theta;
+
     m_pWheel0->SetTransform(m_pWheel0->GetPosition(), theta); // left wheel
     m_pWheel1->SetTransform(m_pWheel1->GetPosition(), theta + 2.4f); // slighty offset right wheel
+
+    m_pObjectManager->Touch(m_hWheel0);
+    m_pObjectManager->Touch(m_hWheel1);
 } //move
@@ -1,6 +1,8 @@
 #pragma once
 #include "Object.h"
-#include "Box2D\Box2D.h"
+#include "Pool.h"
+#include "Rope.h"
+#include "box2d/box2d.h"
 
 #include "Common.h"
 #include "Component.h"
@@ -15,13 +17,20 @@ private:
 
     b2Body* m_pWheel0 = nullptr; ///< Pointer to the left pulley wheel.
     b2Body* m_pWheel1 = nullptr; ///< Pointer to the right pulley wheel.
+    CHandle m_hWheel0; ///< Handle of the left pulley wheel's object.
+    CHandle m_hWheel1; ///< Handle of the right pulley wheel's object.
     float m_fWheelRad = 1; ///< Pulley wheel radius.
+    float m_fTheta = 0; ///< Current wheel orientation.
 
-    b2Body* CreateWheel(float, float); ///< Create a pulley wheel.
+    CRope m_cRope; ///< Rope that goes over the wheels.
+    float m_fRopeSpan = 0; ///< Length of rope from one wheel to the other in Render World.
+
+    b2Body* CreateWheel(float, float, float, CHandle&); ///< Create a pulley wheel.
     b2Body* CreateBasket(float, float); ///< Create basket.
 
 public:
-    CPulley(float, float, float); ///< Constructor.
+    CPulley(CContext&, float, float, float); ///< Constructor.
 
-    void move(); ///< Rotate the pulley wheels.
+    void Reset(); ///< Lay the rope out again.
+    void move(float); ///< Move the rope and rotate the pulley wheels.
 }; //CPulley
\ No newline at end of file
@@ -10,7 +10,7 @@ CRenderer::CRenderer():
 
 /// Load the specific images needed for this game. This is where `eSprite`
 /// values from `GameDefines.h` get tied to the names of sprite tags in
-/// `gamesettings.xml`. Those sprite tags contain the name of the corresponding
+/// `gamesettings.xml` using GetSpriteName(). Those sprite tags contain the name of the corresponding
 /// image file. If the image tag or the image file are missing, then the game
 /// should abort from deeper in the Engine code leaving you with an error
 /// message in a dialog box.
@@ -18,128 +18,46 @@ CRenderer::CRenderer():
 void CRenderer::LoadImages(){  
   BeginResourceUpload();
 
-  Load(eSprite::Background, "background"); 
-  Load(eSprite::Ball, "ball"); 
-  Load(eSprite::Pig, "pig"); 
-  Load(eSprite::ClockFace, "clockface"); 
-  Load(eSprite::Line, "line");
-  Load(eSprite::Ramp, "ramp");
-  Load(eSprite::Bumper, "bumper");
-  Load(eSprite::Basket, "basket");
-  Load(eSprite::Platform, "platform");
-  Load(eSprite::Pin, "pin");
-  Load(eSprite::Heavyball, "heavyball");
-  Load(eSprite::Smallplatform, "smallplatform");
-
-  Load(eSprite::Pulleywheel, "pulleywheel");
-  Load(eSprite::Pulleyline, "pulleyline");
-  Load(eSprite::Circlebumper, "circlebumper");
-
-  Load(eSprite::Base, "cannonbase");
-  Load(eSprite::Wheel, "wheel");
-  Load(eSprite::Catapult, "catapult");
-
-  Load(eSprite::Block, "block");
-  Load(eSprite::Stick, "stick");
-  Load(eSprite::Bird, "bird");
-  Load(eSprite::Propeller, "propeller");
+  for(UINT i=0; i<(UINT)eSprite::Size; i++) //for each sprite type
+    Load((eSprite)i, GetSpriteName((eSprite)i)); //load it by name
 
   EndResourceUpload();
 } //LoadImages
 
-/// Draw a Box2D polygon shape using lines. Iterate through the polygon points,
-/// drawing a line from each one to the one before it. The line from the first
-/// point to the last one is a special case.
-/// \param t Line sprite type.
-/// \param p Pointer to a Box2D polygon shape.
-/// \param pos Position in Physics World.
-/// \param theta Orientation.
-
-void CRenderer::Drawb2Polygon(eSprite t, b2PolygonShape* p,
-  const b2Vec2 pos, float theta)
-{
-  const Vector2 p0 = PW2RW(pos + b2Mul(b2Rot(theta), p->m_vertices[0]));
-  Vector2 p1(p0); //first point
-
-  for(int32 i=1; i<p->m_count; i++){ //for each vertex after the first
-    const Vector2 p2 = PW2RW(pos + b2Mul(b2Rot(theta), p->m_vertices[i])); //second point
-    DrawLine(t, p1, p2); //draw from first point to second point
-    p1 = p2; //move on to next point
-  } //for
-              
-  DrawLine(eSprite::Line, p0, p1); //draw from first point to last point
-} //Drawb2Polygon
-
-/// Draw a Box2D edge shape as a line.
-/// \param t Line sprite type.
-/// \param p Pointer to a Box2D edge shape.
-/// \param pos Position in Physics World.
-
-void CRenderer::Drawb2Edge(eSprite t, b2EdgeShape* p, const b2Vec2 pos){
-  DrawLine(t, PW2RW(pos + p->m_vertex1),
-    PW2RW(pos + p->m_vertex2));
-} //Drawb2Edge
-
-/// Draw a Box2D circle shape by breaking it up into lots of little lines.
-/// \param t Line sprite type.
-/// \param p Pointer to a Box2D circle shape.
-/// \param pos Position in Physics World.
-
-void CRenderer::Drawb2Circle(eSprite t, b2CircleShape* p, const b2Vec2 pos){
-  const float r = PW2RW(p->m_radius); //radius
-  const UINT n = (UINT)ceilf(XM_2PI*r/GetWidth(eSprite::Line)) + 1; //number of lines
-
-  for(UINT i=0; i<n; i++){ //for each tiny line (almost a point really)
-    const float theta = XM_2PI*i/(float)n; //rotation angle
-    const Vector2 v2 = PW2RW(pos) + r*Vector2(cosf(theta), sinf(theta));
-    Draw(t, v2, XM_PI/2.0f + theta); //draw line tangent to circle
+/// Draw the impact particles as line sprites that fade out as they die.
+/// Sparks are stretched along their velocity, more the faster they go,
+/// and dust is drawn as larger, fainter blobs.
+/// \param p Impact particle system.
+
+void CRenderer::DrawParticles(const CImpactParticles& p){
+  const UINT n = p.GetCount(); //number of live particles
+  const float* x = p.GetX(); //x coordinates
+  const float* y = p.GetY(); //y coordinates
+  const float* vx = p.GetVelX(); //x velocities
+  const float* vy = p.GetVelY(); //y velocities
+  const float* life = p.GetLife(); //remaining lives
+  const float* fade = p.GetFade(); //reciprocals of lives at birth
+  const eParticle* kind = p.GetKind(); //kinds
+
+  LSpriteDesc2D desc; //sprite descriptor
+  desc.m_nSpriteIndex = (UINT)eSprite::Line;
+
+  for(UINT i=0; i<n; i++){ //for each particle
+    desc.m_vPos = Vector2(x[i], y[i]);
+    desc.m_fAlpha = life[i]*fade[i];
+
+    if(kind[i] == eParticle::Spark){
+      desc.m_fRoll = atan2f(vy[i], vx[i]);
+      desc.m_fXScale = 1.0f + sqrtf(vx[i]*vx[i] + vy[i]*vy[i])/100.0f;
+      desc.m_fYScale = 1.0f;
+    } //if
+
+    else{ //dust
+      desc.m_fRoll = 0.0f;
+      desc.m_fXScale = desc.m_fYScale = 3.0f;
+      desc.m_fAlpha *= 0.4f;
+    } //else
+
+    Draw(&desc);
   } //for
-} //Drawb2Circle
-
-/// Draw a Box2D chain shape using lines.
-/// This function is a stub that has not yet been implemented.
-/// \param t Line sprite type.
-/// \param p Pointer to a Box2D chain shape.
-/// \param pos Position in Physics World.
-
-void CRenderer::Drawb2Chain(eSprite t, b2ChainShape* p, const b2Vec2 pos){
-  //not implemented
-} //Drawb2Chain
-
-/// Draw a Box2D shape using lines. This is just a `switch` statement that
-/// calls one of Drawb2Circle(), Drawb2Edge(), Drawb2Polygon(), or Drawb2Chain()
-/// depending on the shape's type.
-/// \param t Line sprite type.
-/// \param p Pointer to a Box2D shape.
-/// \param pos Position in Physics World.
-/// \param theta Orientation.
-
-void CRenderer::Drawb2Shape(eSprite t, b2Shape* p, const b2Vec2 pos, float theta){
-  switch(p->GetType()){
-    case b2Shape::e_circle: 
-      Drawb2Circle(t, (b2CircleShape*)p, pos); 
-      break;
-
-		case b2Shape::e_edge:
-      Drawb2Edge(t, (b2EdgeShape*)p, pos);
-      break;
-
-		case b2Shape::e_polygon:
-      Drawb2Polygon(t, (b2PolygonShape*)p, pos, theta);
-      break;
-
-		case b2Shape::e_chain:
-      Drawb2Chain(t, (b2ChainShape*)p, pos);
-      break;
-  } //switch
-} //Drawb2Shape
-
-/// Draw a Box2D body using lines. Iterate through the fixtures attached to the
-/// body, calling Drawb2Shape() to draw the shape of each fixture.
-/// \param t Line sprite type.
-/// \param pBody Pointer to a Box2D body.
-
-void CRenderer::Drawb2Body(eSprite t, b2Body* pBody){ 
-  for(b2Fixture* p = pBody->GetFixtureList(); p; p = p->GetNext())
-    Drawb2Shape(t, p->GetShape(), pBody->GetPosition(), pBody->GetAngle());
-} //Drawb2Body
\ No newline at end of file
+} //DrawParticles
@@ -0,0 +1,503 @@
+/// \file Replay.cpp
+/// \brief Code for the replay CReplay, its recorder CReplayRecorder,
+/// and its player CReplayPlayer.
+
+#include <cmath>
+#include <cstring>
+#include <fstream>
+
+#include "Replay.h"
+
+static const float POSITION_SCALE = 8.0f; ///< Quantization steps per renderer unit.
+static const float ANGLE_SCALE = 65536.0f/XM_2PI; ///< Quantization steps per radian.
+
+//Frame flags. Each frame starts with a byte of these flags, which say
+//what follows it, in this order.
+
+static const BYTE FRAME_TIME = 1; ///< Frame time changed, followed by a float.
+static const BYTE FRAME_STATE = 2; ///< Game state changed, followed by a byte and the clock as a float.
+static const BYTE FRAME_OBJECTS = 4; ///< Number of objects changed, followed by it and the sprite types of any new objects.
+static const BYTE FRAME_LINES = 8; ///< Number of lines changed, followed by it.
+static const BYTE FRAME_MOVED = 16; ///< Objects moved, followed by a mask and the differences.
+static const BYTE FRAME_LINES_MOVED = 32; ///< Lines moved, followed by a mask and the differences.
+
+/// Quantize a value, clamping it so that it stays well inside the range
+/// of an int, even for an object that has flown off into the distance.
+/// \param x Value.
+/// \param scale Quantization steps per unit.
+/// \return Quantized value.
+
+static int Quantize(float x, float scale){
+  const float fLimit = 1073741824.0f; //2 to the 30
+  return (int)lroundf(std::fmax(-fLimit, std::fmin(fLimit, x*scale)));
+} //Quantize
+
+/// Append an unsigned integer in as few bytes as it needs, seven bits
+/// per byte, least significant first, with the top bit of each byte set
+/// if there is another byte to come.
+/// \param v [in, out] Bytes.
+/// \param n Unsigned integer.
+
+static void WriteUInt(std::vector<BYTE>& v, UINT n){
+  while(n >= 0x80){
+    v.push_back((BYTE)(n | 0x80));
+    n >>= 7;
+  } //while
+
+  v.push_back((BYTE)n);
+} //WriteUInt
+
+/// Append a signed integer, zig-zag encoded so that small negative
+/// differences take as few bytes as small positive ones.
+/// \param v [in, out] Bytes.
+/// \param n Signed integer.
+
+static void WriteDelta(std::vector<BYTE>& v, int n){
+  WriteUInt(v, ((UINT)n << 1) ^ (UINT)(n >> 31));
+} //WriteDelta
+
+/// Append the bytes of a value in native byte order.
+/// \param v [in, out] Bytes.
+/// \param x Value.
+
+template<class T> static void WriteValue(std::vector<BYTE>& v, const T& x){
+  const BYTE* p = (const BYTE*)&x;
+  v.insert(v.end(), p, p + sizeof(T));
+} //WriteValue
+
+/// Remove all frames and unload any replay file.
+
+void CReplay::Clear(){
+  m_stdData.clear();
+  m_cFile.Close();
+  m_pData = nullptr;
+  m_nSize = 0;
+  m_nFrames = 0;
+} //Clear
+
+/// Append bytes to the frames. This is for the recorder, which clears
+/// the replay first.
+/// \param p Pointer to bytes.
+/// \param n Number of bytes.
+
+void CReplay::Write(const BYTE* p, size_t n){
+  m_stdData.insert(m_stdData.end(), p, p + n);
+} //Write
+
+/// Count the frame that was just written.
+
+void CReplay::EndFrame(){
+  m_nFrames++;
+} //EndFrame
+
+/// Map a replay file into memory and check that its header and size are
+/// sensible. Any replay that was already loaded or recorded is cleared
+/// first.
+/// \param fname Replay file name.
+/// \return true if the replay file was loaded.
+
+bool CReplay::Load(const std::string& fname){
+  Clear();
+
+  if(!m_cFile.Open(fname))return false;
+
+  const size_t size = m_cFile.GetSize();
+  if(size < sizeof(CReplayHeader))return false;
+
+  const CReplayHeader* pHeader = (const CReplayHeader*)m_cFile.GetData();
+
+  if(memcmp(pHeader->m_pMagic, "RGMR", 4) != 0 || pHeader->m_nVersion != VERSION ||
+    size != sizeof(CReplayHeader) + pHeader->m_nSize)
+  {
+    m_cFile.Close();
+    return false;
+  } //if
+
+  m_pData = (const BYTE*)(pHeader + 1);
+  m_nSize = pHeader->m_nSize;
+  m_nFrames = pHeader->m_nFrames;
+
+  return true;
+} //Load
+
+/// Save the replay to a file, header first.
+/// \param fname Replay file name.
+/// \return true if the replay file was written.
+
+bool CReplay::Save(const std::string& fname) const{
+  const CReplayHeader header = {{'R', 'G', 'M', 'R'}, VERSION, m_nFrames, (UINT)GetSize()};
+  std::ofstream output(fname, std::ios::binary);
+
+  output.write((const char*)&header, sizeof(header));
+  output.write((const char*)GetData(), GetSize());
+
+  return (bool)output;
+} //Save
+
+/// Reader function for the frames, which are in the mapped file if the
+/// replay was loaded and in memory if it was recorded.
+/// \return Pointer to frames.
+
+const BYTE* CReplay::GetData() const{
+  return m_pData? m_pData: m_stdData.data();
+} //GetData
+
+/// Reader function for the number of bytes of frames.
+/// \return Number of bytes of frames.
+
+size_t CReplay::GetSize() const{
+  return m_pData? m_nSize: m_stdData.size();
+} //GetSize
+
+/// Reader function for the number of frames.
+/// \return Number of frames.
+
+UINT CReplay::GetFrameCount() const{
+  return m_nFrames;
+} //GetFrameCount
+
+/// Clear the replay and begin recording. The first frame recorded will
+/// hold everything, since there is no frame before it.
+
+void CReplayRecorder::Begin(){
+  m_cReplay.Clear();
+
+  m_stdObject.clear();
+  m_stdLine.clear();
+  m_fFrameTime = 0;
+  m_eGameState = eGameState::Initial;
+
+  m_bRecording = true;
+} //Begin
+
+/// End recording. The replay is kept until recording begins again.
+
+void CReplayRecorder::End(){
+  m_bRecording = false;
+} //End
+
+/// Reader function for whether recording.
+/// \return true if recording.
+
+bool CReplayRecorder::IsRecording() const{
+  return m_bRecording;
+} //IsRecording
+
+/// Record a frame, if recording. Objects are expected to be added to the
+/// end of the transform cache and never removed while recording, which is
+/// how object manager behaves during a run.
+/// \param t Frame time in seconds.
+/// \param c Transform cache, gathered after the step.
+/// \param lines Line ends in renderer units, two per line.
+/// \param s Game state.
+/// \param clock Time on the clock.
+
+void CReplayRecorder::Record(float t, const CTransformCache& c,
+  const std::vector<Vector2>& lines, eGameState s, float clock)
+{
+  if(!m_bRecording)return;
+
+  m_stdFrame.assign(1, 0); //room for the flags
+  BYTE flags = 0; //frame flags
+
+  if(t != m_fFrameTime){ //frame time changed
+    flags |= FRAME_TIME;
+    WriteValue(m_stdFrame, t);
+    m_fFrameTime = t;
+  } //if
+
+  if(s != m_eGameState){ //game state changed
+    flags |= FRAME_STATE;
+    m_stdFrame.push_back((BYTE)s);
+    WriteValue(m_stdFrame, clock);
+    m_eGameState = s;
+  } //if
+
+  const size_t n = c.GetSize(); //number of objects
+  const size_t m = lines.size()/2; //number of lines
+
+  if(3*n != m_stdObject.size()){ //number of objects changed
+    flags |= FRAME_OBJECTS;
+    WriteUInt(m_stdFrame, (UINT)n);
+
+    for(size_t i=m_stdObject.size()/3; i<n; i++) //for each new object
+      m_stdFrame.push_back((BYTE)c.GetSprite(i));
+
+    m_stdObject.resize(3*n, 0);
+  } //if
+
+  if(4*m != m_stdLine.size()){ //number of lines changed
+    flags |= FRAME_LINES;
+    WriteUInt(m_stdFrame, (UINT)m);
+    m_stdLine.resize(4*m, 0);
+  } //if
+
+  //objects
+
+  const float* x = c.GetX(); //x coordinates
+  const float* y = c.GetY(); //y coordinates
+  const float* a = c.GetAngle(); //orientations
+
+  size_t nMask = m_stdFrame.size(); //where the mask starts
+  m_stdFrame.resize(nMask + (n + 7)/8, 0);
+
+  for(size_t i=0; i<n; i++){ //for each object
+    const int q[3] = {
+      Quantize(x[i], POSITION_SCALE),
+      Quantize(y[i], POSITION_SCALE),
+      Quantize(a[i], ANGLE_SCALE)
+    }; //q
+
+    int* p = &m_stdObject[3*i]; //last frame
+
+    if(q[0] != p[0] || q[1] != p[1] || q[2] != p[2]){ //moved
+      m_stdFrame[nMask + i/8] |= 1 << (i%8);
+      flags |= FRAME_MOVED;
+
+      for(UINT j=0; j<3; j++){
+        WriteDelta(m_stdFrame, q[j] - p[j]);
+        p[j] = q[j];
+      } //for
+    } //if
+  } //for
+
+  if(!(flags & FRAME_MOVED))
+    m_stdFrame.resize(nMask); //no need for the mask
+
+  //lines
+
+  nMask = m_stdFrame.size();
+  m_stdFrame.resize(nMask + (m + 7)/8, 0);
+
+  for(size_t i=0; i<m; i++){ //for each line
+    const int q[4] = {
+      Quantize(lines[2*i].x, POSITION_SCALE),
+      Quantize(lines[2*i].y, POSITION_SCALE),
+      Quantize(lines[2*i + 1].x, POSITION_SCALE),
+      Quantize(lines[2*i + 1].y, POSITION_SCALE)
+    }; //q
+
+    int* p = &m_stdLine[4*i]; //last frame
+
+    if(q[0] != p[0] || q[1] != p[1] || q[2] != p[2] || q[3] != p[3]){ //moved
+      m_stdFrame[nMask + i/8] |= 1 << (i%8);
+      flags |= FRAME_LINES_MOVED;
+
+      for(UINT j=0; j<4; j++){
+        WriteDelta(m_stdFrame, q[j] - p[j]);
+        p[j] = q[j];
+      } //for
+    } //if
+  } //for
+
+  if(!(flags & FRAME_LINES_MOVED))
+    m_stdFrame.resize(nMask); //no need for the mask
+
+  m_stdFrame[0] = flags;
+  m_cReplay.Write(m_stdFrame.data(), m_stdFrame.size());
+  m_cReplay.EndFrame();
+} //Record
+
+/// Reader function for the replay, which is complete once recording ends.
+/// \return Reference to the replay.
+
+const CReplay& CReplayRecorder::GetReplay() const{
+  return m_cReplay;
+} //GetReplay
+
+/// Start playing a replay from its first frame. Nothing is decoded until
+/// the first call to Step().
+/// \param p Pointer to the replay, which must not change while it is played.
+
+void CReplayPlayer::Start(const CReplay* p){
+  m_pReplay = p;
+  m_nPos = 0;
+  m_nFrame = 0;
+
+  m_stdObject.clear();
+  m_stdLine.clear();
+  m_cTransforms.Clear();
+  m_stdLineEnd.clear();
+
+  m_fFrameTime = 0;
+  m_fTime = 0;
+  m_fStartTime = 0;
+  m_fTotalTime = 0;
+  m_eGameState = eGameState::Initial;
+} //Start
+
+/// Go back to the start of the replay that is being played.
+
+void CReplayPlayer::Rewind(){
+  Start(m_pReplay);
+} //Rewind
+
+/// Read bytes from the replay, if there are enough left.
+/// \param p [out] Pointer to where to put them.
+/// \param n Number of bytes.
+/// \return true if there were enough bytes.
+
+bool CReplayPlayer::Read(void* p, size_t n){
+  if(m_nPos + n > m_pReplay->GetSize())return false;
+  memcpy(p, m_pReplay->GetData() + m_nPos, n);
+  m_nPos += n;
+  return true;
+} //Read
+
+/// Read an unsigned integer written by WriteUInt().
+/// \param n [out] Unsigned integer.
+/// \return true if it was all there.
+
+bool CReplayPlayer::ReadUInt(UINT& n){
+  n = 0;
+
+  for(UINT shift=0; shift<32; shift+=7){ //for each byte
+    BYTE b = 0;
+    if(!Read(&b, 1))return false;
+    n |= (UINT)(b & 0x7F) << shift;
+    if(!(b & 0x80))return true;
+  } //for
+
+  return false; //too long
+} //ReadUInt
+
+/// Read a signed integer written by WriteDelta() and add it to a value.
+/// \param n [in, out] Value.
+/// \return true if it was all there.
+
+bool CReplayPlayer::ReadDelta(int& n){
+  UINT u = 0;
+  if(!ReadUInt(u))return false;
+  n += (int)(u >> 1) ^ -(int)(u & 1);
+  return true;
+} //ReadDelta
+
+/// Decode the next frame. If the replay turns out to be damaged, playing
+/// stops there.
+/// \return true if there was a frame to decode.
+
+bool CReplayPlayer::Step(){
+  if(m_pReplay == nullptr || IsFinished())return false;
+
+  BYTE flags = 0; //frame flags
+  bool bOK = Read(&flags, 1); //whether the frame is intact so far
+
+  if(bOK && (flags & FRAME_TIME))
+    bOK = Read(&m_fFrameTime, sizeof(float));
+
+  m_fTime += m_fFrameTime;
+
+  if(bOK && (flags & FRAME_STATE)){ //game state changed
+    BYTE s = 0; //game state
+    float clock = 0; //time on the clock
+    bOK = Read(&s, 1) && Read(&clock, sizeof(float));
+    m_eGameState = (eGameState)s;
+
+    if(m_eGameState == eGameState::Running)m_fStartTime = m_fTime - clock;
+    else if(m_eGameState == eGameState::Finished)m_fTotalTime = clock;
+  } //if
+
+  if(bOK && (flags & FRAME_OBJECTS)){ //number of objects changed
+    UINT n = 0; //number of objects
+    bOK = ReadUInt(n);
+
+    if(bOK){
+      m_cTransforms.Truncate(n);
+
+      for(size_t i=m_cTransforms.GetSize(); bOK && i<n; i++){ //for each new object
+        BYTE t = 0; //sprite type
+        bOK = Read(&t, 1) && t < (BYTE)eSprite::Size;
+        if(bOK)m_cTransforms.Add((eSprite)t, nullptr);
+      } //for
+
+      m_stdObject.resize(3*m_cTransforms.GetSize(), 0);
+    } //if
+  } //if
+
+  if(bOK && (flags & FRAME_LINES)){ //number of lines changed
+    UINT m = 0; //number of lines
+    bOK = ReadUInt(m);
+
+    if(bOK){
+      m_stdLine.resize(4*m, 0);
+      m_stdLineEnd.resize(2*m);
+    } //if
+  } //if
+
+  if(bOK && (flags & FRAME_MOVED)){ //objects moved
+    const size_t n = m_cTransforms.GetSize(); //number of objects
+    const size_t nMask = m_nPos; //where the mask starts
+    bOK = nMask + (n + 7)/8 <= m_pReplay->GetSize();
+    if(bOK)m_nPos += (n + 7)/8;
+
+    for(size_t i=0; bOK && i<n; i++) //for each object
+      if(m_pReplay->GetData()[nMask + i/8] & (1 << (i%8))){ //moved
+        int* p = &m_stdObject[3*i];
+        bOK = ReadDelta(p[0]) && ReadDelta(p[1]) && ReadDelta(p[2]);
+        m_cTransforms.Set(i, p[0]/POSITION_SCALE, p[1]/POSITION_SCALE, p[2]/ANGLE_SCALE);
+      } //if
+  } //if
+
+  if(bOK && (flags & FRAME_LINES_MOVED)){ //lines moved
+    const size_t m = m_stdLineEnd.size()/2; //number of lines
+    const size_t nMask = m_nPos; //where the mask starts
+    bOK = nMask + (m + 7)/8 <= m_pReplay->GetSize();
+    if(bOK)m_nPos += (m + 7)/8;
+
+    for(size_t i=0; bOK && i<m; i++) //for each line
+      if(m_pReplay->GetData()[nMask + i/8] & (1 << (i%8))){ //moved
+        int* p = &m_stdLine[4*i];
+        bOK = ReadDelta(p[0]) && ReadDelta(p[1]) && ReadDelta(p[2]) && ReadDelta(p[3]);
+        m_stdLineEnd[2*i] = Vector2(p[0]/POSITION_SCALE, p[1]/POSITION_SCALE);
+        m_stdLineEnd[2*i + 1] = Vector2(p[2]/POSITION_SCALE, p[3]/POSITION_SCALE);
+      } //if
+  } //if
+
+  if(!bOK){ //damaged, so stop here
+    m_nFrame = m_pReplay->GetFrameCount();
+    return false;
+  } //if
+
+  m_nFrame++;
+  return true;
+} //Step
+
+/// Reader function for whether all frames have been decoded.
+/// \return true if there are no more frames to decode.
+
+bool CReplayPlayer::IsFinished() const{
+  return m_pReplay == nullptr || m_nFrame >= m_pReplay->GetFrameCount();
+} //IsFinished
+
+/// Reader function for the object transforms decoded from the last frame.
+/// They have no Physics World bodies.
+/// \return Reference to the transform cache.
+
+const CTransformCache& CReplayPlayer::GetTransforms() const{
+  return m_cTransforms;
+} //GetTransforms
+
+/// Reader function for the line ends decoded from the last frame.
+/// \return Line ends in renderer units, two per line.
+
+const std::vector<Vector2>& CReplayPlayer::GetLines() const{
+  return m_stdLineEnd;
+} //GetLines
+
+/// Reader function for the game state in the last frame.
+/// \return Game state.
+
+eGameState CReplayPlayer::GetGameState() const{
+  return m_eGameState;
+} //GetGameState
+
+/// Get the time that the clock showed in the last frame.
+/// \return Time on the clock in seconds.
+
+float CReplayPlayer::GetClock() const{
+  switch(m_eGameState){
+    case eGameState::Running: return m_fTime - m_fStartTime;
+    case eGameState::Finished: return m_fTotalTime;
+    default: return 0.0f;
+  } //switch
+} //GetClock
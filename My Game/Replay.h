@@ -0,0 +1,132 @@
+/// \file Replay.h
+/// \brief Interface for the replay CReplay, its recorder CReplayRecorder,
+/// and its player CReplayPlayer.
+
+#ifndef __L4RC_GAME_REPLAY_H__
+#define __L4RC_GAME_REPLAY_H__
+
+#include <string>
+#include <vector>
+
+#include "GameDefines.h"
+#include "MappedFile.h"
+#include "TransformCache.h"
+
+/// \brief Replay file header.
+///
+/// The first thing in a replay file.
+
+struct CReplayHeader{
+  char m_pMagic[4]; ///< Must be "RGMR".
+  UINT m_nVersion; ///< Must be CReplay::VERSION.
+  UINT m_nFrames; ///< Number of frames.
+  UINT m_nSize; ///< Number of bytes of frames that follow.
+}; //CReplayHeader
+
+/// \brief A replay.
+///
+/// A replay is a recorded run of the machine, stored as a stream of
+/// frames. The first frame holds the sprite type and transform of every
+/// object, the ends of every line, and the game state. Each frame after
+/// that holds only what changed since the frame before it: positions and
+/// orientations are quantized to integers and stored as differences from
+/// the previous frame in variable-length bytes, and a bit mask says which
+/// objects and lines moved at all, so that resting objects cost a bit per
+/// frame and frames in which nothing moves cost a single byte. A replay is
+/// either recorded by CReplayRecorder into memory or loaded from a file,
+/// which like a level file is mapped into memory and played in place.
+
+class CReplay{
+  private:
+    std::vector<BYTE> m_stdData; ///< Recorded frames.
+    CMappedFile m_cFile; ///< Memory-mapped replay file.
+    const BYTE* m_pData = nullptr; ///< Frames in the mapped file, if loaded.
+    size_t m_nSize = 0; ///< Number of bytes of frames in the mapped file.
+    UINT m_nFrames = 0; ///< Number of frames.
+
+  public:
+    static const UINT VERSION = 1; ///< Replay file version.
+
+    void Clear(); ///< Remove all frames.
+    void Write(const BYTE* p, size_t n); ///< Append bytes to the frames.
+    void EndFrame(); ///< Count a frame.
+
+    bool Load(const std::string& fname); ///< Load replay file.
+    bool Save(const std::string& fname) const; ///< Save replay file.
+
+    const BYTE* GetData() const; ///< Get pointer to frames.
+    size_t GetSize() const; ///< Get number of bytes of frames.
+    UINT GetFrameCount() const; ///< Get number of frames.
+}; //CReplay
+
+/// \brief The replay recorder.
+///
+/// The replay recorder encodes the state of the machine after each step
+/// into a replay, from when it is begun until it is ended.
+
+class CReplayRecorder{
+  private:
+    CReplay m_cReplay; ///< The replay being recorded.
+    bool m_bRecording = false; ///< Whether recording.
+
+    std::vector<int> m_stdObject; ///< Quantized x, y, and orientation of each object in the last frame.
+    std::vector<int> m_stdLine; ///< Quantized x and y of the ends of each line in the last frame.
+    float m_fFrameTime = 0; ///< Frame time in the last frame.
+    eGameState m_eGameState = eGameState::Initial; ///< Game state in the last frame.
+
+    std::vector<BYTE> m_stdFrame; ///< Frame being encoded.
+
+  public:
+    void Begin(); ///< Begin recording.
+    void End(); ///< End recording.
+    bool IsRecording() const; ///< Whether recording.
+
+    void Record(float t, const CTransformCache& c, const std::vector<Vector2>& lines,
+      eGameState s, float clock); ///< Record a frame.
+
+    const CReplay& GetReplay() const; ///< Get the replay.
+}; //CReplayRecorder
+
+/// \brief The replay player.
+///
+/// The replay player decodes the frames of a replay one at a time into
+/// a transform cache and a list of line ends, which object manager can
+/// draw from in place of Physics World, so playing a replay needs no
+/// physics. Only the current frame is decoded, so the memory needed is
+/// that of the replay itself and one frame.
+
+class CReplayPlayer{
+  private:
+    const CReplay* m_pReplay = nullptr; ///< The replay being played.
+    size_t m_nPos = 0; ///< Position in the replay's frames.
+    UINT m_nFrame = 0; ///< Number of frames decoded.
+
+    std::vector<int> m_stdObject; ///< Quantized x, y, and orientation of each object.
+    std::vector<int> m_stdLine; ///< Quantized x and y of the ends of each line.
+
+    CTransformCache m_cTransforms; ///< Object transforms, with no bodies.
+    std::vector<Vector2> m_stdLineEnd; ///< Line ends, two per line.
+
+    float m_fFrameTime = 0; ///< Frame time in seconds.
+    float m_fTime = 0; ///< Time since the first frame in seconds.
+    float m_fStartTime = 0; ///< Time the machine started.
+    float m_fTotalTime = 0; ///< Elapsed time at finish.
+    eGameState m_eGameState = eGameState::Initial; ///< Game state.
+
+    bool Read(void* p, size_t n); ///< Read bytes.
+    bool ReadUInt(UINT& n); ///< Read variable-length unsigned integer.
+    bool ReadDelta(int& n); ///< Read a difference and add it.
+
+  public:
+    void Start(const CReplay* p); ///< Start playing a replay.
+    void Rewind(); ///< Go back to the start.
+    bool Step(); ///< Decode the next frame.
+    bool IsFinished() const; ///< Whether all frames have been decoded.
+
+    const CTransformCache& GetTransforms() const; ///< Get object transforms.
+    const std::vector<Vector2>& GetLines() const; ///< Get line ends.
+    eGameState GetGameState() const; ///< Get game state.
+    float GetClock() const; ///< Get time on the clock.
+}; //CReplayPlayer
+
+#endif //__L4RC_GAME_REPLAY_H__
@@ -0,0 +1,371 @@
+/// \file Rope.cpp
+/// \brief Code for the rope CRope.
+
+#include <algorithm>
+
+#include "Rope.h"
+
+#if defined(_M_X64) || defined(__SSE2__)
+  #define ROPE_SSE //use SSE to move the rope
+  #include <xmmintrin.h>
+#endif
+
+/// Downwards acceleration of the rope in renderer units per second
+/// squared, the same as Physics World's gravity.
+
+static const float fGravity = 1000.0f;
+
+/// Fraction of its velocity that a point keeps from one step to the next.
+
+static const float fDamping = 0.98f;
+
+/// Most that a point can move in a step for the rope to count as still,
+/// in renderer units.
+
+static const float fSleepMotion = 0.05f;
+
+/// Number of steps in a row that the rope must be still to go to sleep.
+
+static const UINT nSleepSteps = 30;
+
+/// Least squared length of a segment or distance from a circle center,
+/// to stop a division by zero.
+
+static const float fTiny = 1e-6f;
+
+/// Allocate the arrays for the points. This is the only allocation the
+/// rope ever makes. The arrays are padded to a multiple of four points,
+/// and the padding has zero inverse mass, so that it never moves.
+/// \param n Number of points, at least three.
+
+CRope::CRope(UINT n):
+  m_nCount(std::max(n, 3U))
+{
+  const size_t size = (m_nCount + 3) & ~3U; //padded size
+  m_stdData.resize(5*size, 0.0f);
+
+  float* p = m_stdData.data(); //next array
+  m_pX = p; p += size;
+  m_pY = p; p += size;
+  m_pOldX = p; p += size;
+  m_pOldY = p; p += size;
+  m_pInvMass = p;
+
+  for(UINT i=1; i+1<m_nCount; i++) //all but the ends
+    m_pInvMass[i] = 1.0f;
+} //constructor
+
+/// Lay the rope out at rest, evenly spaced along a path. The segment
+/// length is set to fit the path exactly, but can be changed afterwards
+/// by SetLength().
+/// \param v Points along the path.
+/// \param n Number of points along the path, at least two.
+
+void CRope::Reset(const Vector2* v, UINT n){
+  float fPath = 0; //length of path
+
+  for(UINT i=1; i<n; i++)
+    fPath += (v[i] - v[i - 1]).Length();
+
+  m_fSegment = fPath/(m_nCount - 1);
+
+  UINT j = 1; //end of the piece of path that the next point is on
+  float fStart = 0; //distance along the path to the start of that piece
+
+  for(UINT i=0; i<m_nCount; i++){ //for each point
+    const float d = i*m_fSegment; //distance along the path
+    float fPiece = (v[j] - v[j - 1]).Length(); //length of the piece
+
+    while(j + 1 < n && d > fStart + fPiece){ //on to the next piece
+      fStart += fPiece;
+      j++;
+      fPiece = (v[j] - v[j - 1]).Length();
+    } //while
+
+    const float f = fPiece > 0.0f? std::min(1.0f, (d - fStart)/fPiece): 0.0f; //fraction of the way along it
+    const Vector2 p = v[j - 1] + (v[j] - v[j - 1])*f; //point
+
+    m_pX[i] = m_pOldX[i] = p.x;
+    m_pY[i] = m_pOldY[i] = p.y;
+  } //for
+
+  m_nStill = 0;
+  m_bAsleep = false;
+} //Reset
+
+/// Writer function for the length of the rope, which is shared equally
+/// between its segments.
+/// \param length Length in renderer units.
+
+void CRope::SetLength(float length){
+  m_fSegment = length/(m_nCount - 1);
+} //SetLength
+
+/// Add a circle that the points of the rope are kept out of. Circles after
+/// the first MAXCIRCLES are ignored.
+/// \param c Center.
+/// \param r Radius.
+
+void CRope::AddCircle(const Vector2& c, float r){
+  if(m_nCircles < MAXCIRCLES){
+    m_vCenter[m_nCircles] = c;
+    m_fRadius[m_nCircles] = r;
+    m_nCircles++;
+  } //if
+} //AddCircle
+
+/// Move the points by Verlet integration: each point carries on by the
+/// distance it moved in the last step, a little less for damping, and
+/// falls by gravity. Points with zero inverse mass do not move, and
+/// neither do the ends.
+/// \param t Time step in seconds.
+/// \return Most that a point moved in either direction in the last step.
+
+float CRope::Integrate(float t){
+#ifdef ROPE_SSE
+  const __m128 k = _mm_set1_ps(fDamping); //damping, four times
+  const __m128 g = _mm_set1_ps(fGravity*t*t); //fall, four times
+  const __m128 sign = _mm_set1_ps(-0.0f); //sign bit, four times
+  __m128 m = _mm_setzero_ps(); //most movement, four times
+
+  for(UINT i=0; i<m_nCount; i+=4){ //for each group of four
+    const __m128 x = _mm_loadu_ps(m_pX + i);
+    const __m128 y = _mm_loadu_ps(m_pY + i);
+    const __m128 w = _mm_loadu_ps(m_pInvMass + i);
+    const __m128 dx = _mm_sub_ps(x, _mm_loadu_ps(m_pOldX + i)); //movement in last step
+    const __m128 dy = _mm_sub_ps(y, _mm_loadu_ps(m_pOldY + i));
+
+    m = _mm_max_ps(m, _mm_max_ps(_mm_andnot_ps(sign, dx), _mm_andnot_ps(sign, dy)));
+
+    _mm_storeu_ps(m_pOldX + i, x);
+    _mm_storeu_ps(m_pOldY + i, y);
+    _mm_storeu_ps(m_pX + i, _mm_add_ps(x, _mm_mul_ps(w, _mm_mul_ps(dx, k))));
+    _mm_storeu_ps(m_pY + i, _mm_add_ps(y, _mm_mul_ps(w, _mm_sub_ps(_mm_mul_ps(dy, k), g))));
+  } //for
+
+  m = _mm_max_ps(m, _mm_shuffle_ps(m, m, _MM_SHUFFLE(1, 0, 3, 2)));
+  m = _mm_max_ps(m, _mm_shuffle_ps(m, m, _MM_SHUFFLE(2, 3, 0, 1)));
+  return _mm_cvtss_f32(m);
+#else
+  const float g = fGravity*t*t; //fall
+  float m = 0; //most movement
+
+  for(UINT i=0; i<m_nCount; i++){ //for each point
+    const float dx = m_pX[i] - m_pOldX[i]; //movement in last step
+    const float dy = m_pY[i] - m_pOldY[i];
+
+    m = std::max(m, std::max(fabsf(dx), fabsf(dy)));
+
+    m_pOldX[i] = m_pX[i];
+    m_pOldY[i] = m_pY[i];
+    m_pX[i] += m_pInvMass[i]*(dx*fDamping);
+    m_pY[i] += m_pInvMass[i]*(dy*fDamping - g);
+  } //for
+
+  return m;
+#endif //ROPE_SSE
+} //Integrate
+
+/// Pull every other segment back to its length, moving its two ends
+/// along it in proportion to their inverse masses. The segments done
+/// share no points, so four of them are done at once using SSE, from
+/// eight points loaded as two groups of four and shuffled into the
+/// points at the starts of the segments and the points at their ends.
+/// \param first Index of first segment, 0 for the even segments and 1
+///   for the odd ones.
+
+void CRope::Solve(UINT first){
+  UINT i = first; //start of next segment
+
+#ifdef ROPE_SSE
+  const __m128 rest = _mm_set1_ps(m_fSegment); //segment length, four times
+  const __m128 tiny = _mm_set1_ps(fTiny); //fTiny, four times
+
+  for(; i + 8<=m_nCount; i+=8){ //for each group of four segments
+    const __m128 x0 = _mm_loadu_ps(m_pX + i), x1 = _mm_loadu_ps(m_pX + i + 4);
+    const __m128 y0 = _mm_loadu_ps(m_pY + i), y1 = _mm_loadu_ps(m_pY + i + 4);
+    const __m128 w0 = _mm_loadu_ps(m_pInvMass + i), w1 = _mm_loadu_ps(m_pInvMass + i + 4);
+
+    __m128 px = _mm_shuffle_ps(x0, x1, _MM_SHUFFLE(2, 0, 2, 0)); //starts
+    __m128 py = _mm_shuffle_ps(y0, y1, _MM_SHUFFLE(2, 0, 2, 0));
+    __m128 qx = _mm_shuffle_ps(x0, x1, _MM_SHUFFLE(3, 1, 3, 1)); //ends
+    __m128 qy = _mm_shuffle_ps(y0, y1, _MM_SHUFFLE(3, 1, 3, 1));
+    const __m128 wp = _mm_shuffle_ps(w0, w1, _MM_SHUFFLE(2, 0, 2, 0));
+    const __m128 wq = _mm_shuffle_ps(w0, w1, _MM_SHUFFLE(3, 1, 3, 1));
+
+    const __m128 dx = _mm_sub_ps(qx, px);
+    const __m128 dy = _mm_sub_ps(qy, py);
+    const __m128 len = _mm_sqrt_ps(_mm_max_ps(tiny,
+      _mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dy, dy)))); //segment length
+    const __m128 s = _mm_div_ps(_mm_sub_ps(len, rest),
+      _mm_mul_ps(len, _mm_add_ps(wp, wq))); //how far to pull
+
+    px = _mm_add_ps(px, _mm_mul_ps(dx, _mm_mul_ps(s, wp)));
+    py = _mm_add_ps(py, _mm_mul_ps(dy, _mm_mul_ps(s, wp)));
+    qx = _mm_sub_ps(qx, _mm_mul_ps(dx, _mm_mul_ps(s, wq)));
+    qy = _mm_sub_ps(qy, _mm_mul_ps(dy, _mm_mul_ps(s, wq)));
+
+    _mm_storeu_ps(m_pX + i, _mm_unpacklo_ps(px, qx));
+    _mm_storeu_ps(m_pX + i + 4, _mm_unpackhi_ps(px, qx));
+    _mm_storeu_ps(m_pY + i, _mm_unpacklo_ps(py, qy));
+    _mm_storeu_ps(m_pY + i + 4, _mm_unpackhi_ps(py, qy));
+  } //for
+#endif //ROPE_SSE
+
+  for(; i + 1<m_nCount; i+=2){ //for each remaining segment
+    const float wp = m_pInvMass[i]; //inverse mass of start
+    const float wq = m_pInvMass[i + 1]; //inverse mass of end
+    const float dx = m_pX[i + 1] - m_pX[i];
+    const float dy = m_pY[i + 1] - m_pY[i];
+    const float len = sqrtf(std::max(fTiny, dx*dx + dy*dy)); //segment length
+    const float s = (len - m_fSegment)/(len*(wp + wq)); //how far to pull
+
+    m_pX[i] += dx*(s*wp);
+    m_pY[i] += dy*(s*wp);
+    m_pX[i + 1] -= dx*(s*wq);
+    m_pY[i + 1] -= dy*(s*wq);
+  } //for
+} //Solve
+
+/// Push any points that are inside a circle out to its edge, straight
+/// away from its center, four at a time using SSE. Groups of four with no
+/// points inside are skipped. The ends are left where they are pinned.
+
+void CRope::Collide(){
+  for(UINT j=0; j<m_nCircles; j++){ //for each circle
+    const float r = m_fRadius[j]; //radius
+    const Vector2& c = m_vCenter[j]; //center
+
+#ifdef ROPE_SSE
+    const __m128 cx = _mm_set1_ps(c.x); //center x coordinate, four times
+    const __m128 cy = _mm_set1_ps(c.y); //center y coordinate, four times
+    const __m128 rr = _mm_set1_ps(r); //radius, four times
+    const __m128 r2 = _mm_set1_ps(r*r); //radius squared, four times
+    const __m128 tiny = _mm_set1_ps(fTiny); //fTiny, four times
+    const __m128 zero = _mm_setzero_ps(); //zero, four times
+
+    for(UINT i=0; i<m_nCount; i+=4){ //for each group of four
+      const __m128 x = _mm_loadu_ps(m_pX + i);
+      const __m128 y = _mm_loadu_ps(m_pY + i);
+      const __m128 dx = _mm_sub_ps(x, cx);
+      const __m128 dy = _mm_sub_ps(y, cy);
+      const __m128 d2 = _mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dy, dy)); //distance squared
+      const __m128 inside = _mm_and_ps(_mm_cmplt_ps(d2, r2),
+        _mm_cmpgt_ps(_mm_loadu_ps(m_pInvMass + i), zero)); //inside and free to move
+
+      if(_mm_movemask_ps(inside) == 0)continue; //none inside
+
+      const __m128 s = _mm_div_ps(rr, _mm_sqrt_ps(_mm_max_ps(tiny, d2))); //scale to edge
+      const __m128 nx = _mm_add_ps(cx, _mm_mul_ps(dx, s));
+      const __m128 ny = _mm_add_ps(cy, _mm_mul_ps(dy, s));
+
+      _mm_storeu_ps(m_pX + i, _mm_or_ps(_mm_and_ps(inside, nx), _mm_andnot_ps(inside, x)));
+      _mm_storeu_ps(m_pY + i, _mm_or_ps(_mm_and_ps(inside, ny), _mm_andnot_ps(inside, y)));
+    } //for
+#else
+    for(UINT i=0; i<m_nCount; i++){ //for each point
+      const float dx = m_pX[i] - c.x;
+      const float dy = m_pY[i] - c.y;
+      const float d2 = dx*dx + dy*dy; //distance squared
+
+      if(d2 < r*r && m_pInvMass[i] > 0.0f){ //inside and free to move
+        const float s = r/sqrtf(std::max(fTiny, d2)); //scale to edge
+        m_pX[i] = c.x + dx*s;
+        m_pY[i] = c.y + dy*s;
+      } //if
+    } //for
+#endif //ROPE_SSE
+  } //for
+} //Collide
+
+/// Pin the ends of the rope. The ends are not moved by anything else, so
+/// where they were before is left as it was, and the next Integrate()
+/// sees how far they moved.
+/// \param a First end.
+/// \param b Last end.
+
+void CRope::Pin(const Vector2& a, const Vector2& b){
+  const UINT n = m_nCount - 1; //index of last end
+
+  m_pX[0] = a.x;
+  m_pY[0] = a.y;
+  m_pX[n] = b.x;
+  m_pY[n] = b.y;
+} //Pin
+
+/// Move the rope along by one time step. Its ends are pinned to the
+/// points given, then the other points are moved and the segments pulled
+/// back to length and the points pushed out of the circles, a number of
+/// times over. If the rope is asleep and its ends are where they were, it
+/// is left as it is. It goes to sleep when no point has moved further than
+/// a small distance in a step for a number of steps in a row.
+/// \param a Where to pin the first end.
+/// \param b Where to pin the last end.
+/// \param t Time step in seconds.
+
+void CRope::Step(const Vector2& a, const Vector2& b, float t){
+  const UINT n = m_nCount - 1; //index of last end
+
+  if(m_bAsleep && a.x == m_pX[0] && a.y == m_pY[0] && b.x == m_pX[n] && b.y == m_pY[n])
+    return; //asleep and ends haven't moved
+
+  m_bAsleep = false;
+
+  Pin(a, b);
+  const float fMotion = Integrate(t); //most movement in last step
+
+  for(UINT i=0; i<m_nIterations; i++){
+    Solve(0); //even segments
+    Solve(1); //odd segments
+    Collide();
+  } //for
+
+  m_nStill = fMotion < fSleepMotion? m_nStill + 1: 0;
+  m_bAsleep = m_nStill >= nSleepSteps;
+} //Step
+
+/// Reader function for the number of points.
+/// \return Number of points.
+
+UINT CRope::GetCount() const{
+  return m_nCount;
+} //GetCount
+
+/// Reader function for the x coordinates.
+/// \return Pointer to the x coordinates of the points.
+
+const float* CRope::GetX() const{
+  return m_pX;
+} //GetX
+
+/// Reader function for the y coordinates.
+/// \return Pointer to the y coordinates of the points.
+
+const float* CRope::GetY() const{
+  return m_pY;
+} //GetY
+
+/// Reader function for the length of each segment.
+/// \return Length that each segment is pulled back to.
+
+float CRope::GetSegmentLength() const{
+  return m_fSegment;
+} //GetSegmentLength
+
+/// Reader function for whether the rope is asleep.
+/// \return true if the rope has stopped moving.
+
+bool CRope::IsAsleep() const{
+  return m_bAsleep;
+} //IsAsleep
+
+/// Add the segments of the rope to a list of line ends, so that the rope
+/// can be drawn with the lines.
+/// \param v [in, out] Line ends, two per line.
+
+void CRope::GetLines(std::vector<Vector2>& v) const{
+  for(UINT i=1; i<m_nCount; i++){ //for each segment
+    v.push_back(Vector2(m_pX[i - 1], m_pY[i - 1]));
+    v.push_back(Vector2(m_pX[i], m_pY[i]));
+  } //for
+} //GetLines
@@ -0,0 +1,74 @@
+/// \file Rope.h
+/// \brief Interface for the rope CRope.
+
+#ifndef __L4RC_GAME_ROPE_H__
+#define __L4RC_GAME_ROPE_H__
+
+#include <vector>
+
+#include "GameDefines.h"
+
+/// \brief A rope.
+///
+/// A rope is a chain of points joined by segments of equal length, moved
+/// by Verlet integration, which keeps each point's last position instead
+/// of its velocity. After the points are moved, the segments are pulled
+/// back to their length a few times over. The segments that start at even
+/// points share no points, and neither do the ones that start at odd
+/// points, so each half is done four segments at a time using SSE. The
+/// points are kept in structure-of-arrays form so that four of them can
+/// be loaded at once. The ends of the rope are pinned to points given to
+/// Step(), and the points are kept out of up to MAXCIRCLES circles, such
+/// as pulley wheels. The rope is only for show; nothing in Physics World
+/// feels it, and the thing that moves its ends decides how long it is.
+/// A rope that has stopped moving goes to sleep until its ends move.
+/// Positions are in renderer coordinates. The arrays point into storage
+/// that the rope owns, so a rope must not be copied.
+
+class CRope{
+  private:
+    static const UINT MAXCIRCLES = 4; ///< Most circles the rope can be kept out of.
+
+    UINT m_nCount = 0; ///< Number of points.
+    UINT m_nIterations = 12; ///< Number of times the segments are pulled back to length.
+
+    std::vector<float> m_stdData; ///< Storage for all of the arrays.
+    float* m_pX = nullptr; ///< X coordinates.
+    float* m_pY = nullptr; ///< Y coordinates.
+    float* m_pOldX = nullptr; ///< X coordinates before the last step.
+    float* m_pOldY = nullptr; ///< Y coordinates before the last step.
+    float* m_pInvMass = nullptr; ///< Inverse masses, 0 for the pinned ends.
+
+    float m_fSegment = 0; ///< Length of each segment.
+
+    Vector2 m_vCenter[MAXCIRCLES]; ///< Centers of circles.
+    float m_fRadius[MAXCIRCLES] = {0}; ///< Radii of circles.
+    UINT m_nCircles = 0; ///< Number of circles.
+
+    UINT m_nStill = 0; ///< Number of steps in a row that the rope has been still.
+    bool m_bAsleep = false; ///< Whether the rope has stopped moving.
+
+    float Integrate(float t); ///< Move the points.
+    void Solve(UINT first); ///< Pull segments back to length.
+    void Collide(); ///< Push points out of the circles.
+    void Pin(const Vector2& a, const Vector2& b); ///< Pin the ends.
+
+  public:
+    CRope(UINT n); ///< Constructor.
+    CRope(const CRope&) = delete; ///< No copy constructor.
+    CRope& operator=(const CRope&) = delete; ///< No assignment.
+
+    void Reset(const Vector2* v, UINT n); ///< Lay the rope along a path.
+    void SetLength(float length); ///< Set the length.
+    void AddCircle(const Vector2& c, float r); ///< Add a circle to keep out of.
+    void Step(const Vector2& a, const Vector2& b, float t); ///< Move the rope by one time step.
+
+    UINT GetCount() const; ///< Get number of points.
+    const float* GetX() const; ///< Get x coordinates.
+    const float* GetY() const; ///< Get y coordinates.
+    float GetSegmentLength() const; ///< Get length of each segment.
+    bool IsAsleep() const; ///< Whether the rope has stopped moving.
+    void GetLines(std::vector<Vector2>& v) const; ///< Add segments to line ends.
+}; //CRope
+
+#endif //__L4RC_GAME_ROPE_H__
@@ -0,0 +1,96 @@
+/// \file Snapshot.cpp
+/// \brief Code for the Physics World snapshot class CSnapshot.
+
+#include "Snapshot.h"
+#include "ObjectManager.h"
+
+/// \param c Simulation context.
+
+CSnapshot::CSnapshot(CContext& c):
+  CCommon(c){
+} //constructor
+
+/// Capture the state of every body in the Physics World, the motor speed
+/// of every revolute and wheel joint, and the number of objects and lines
+/// in object manager.
+
+void CSnapshot::Capture(){
+  m_stdBody.clear();
+  m_stdBody.reserve(m_pPhysicsWorld->GetBodyCount());
+
+  for(b2Body* p=m_pPhysicsWorld->GetBodyList(); p; p=p->GetNext())
+    m_stdBody.push_back({p, p->GetPosition(), p->GetAngle(),
+      p->GetLinearVelocity(), p->GetAngularVelocity(), p->IsAwake(),
+      p->GetType() == b2_staticBody});
+
+  m_stdJoint.clear();
+
+  for(b2Joint* p=m_pPhysicsWorld->GetJointList(); p; p=p->GetNext())
+    switch(p->GetType()){
+      case e_revoluteJoint:
+        m_stdJoint.push_back({p, ((b2RevoluteJoint*)p)->GetMotorSpeed()});
+      break;
+
+      case e_wheelJoint:
+        m_stdJoint.push_back({p, ((b2WheelJoint*)p)->GetMotorSpeed()});
+      break;
+
+      default: break; //no motor
+    } //switch
+
+  m_nObjects = m_pObjectManager->GetObjectCount();
+  m_nLines = m_pObjectManager->GetLineCount();
+  m_bCaptured = true;
+} //Capture
+
+/// Delete the objects and lines created since the snapshot was captured,
+/// then put every body and joint motor back the way it was. Each body that
+/// has moved is put back with a single transform, which moves its fixtures'
+/// proxies in the broadphase, and the Physics World then looks for new
+/// contacts once, on its next step. The contacts and joints still hold the
+/// impulses that the solver uses to warm start the next step, so warm
+/// starting is turned off for that step, which makes the solver start every
+/// contact and joint from zero, just as it did when the level was first
+/// built. Bodies that haven't moved, which include almost all of the static
+/// ones, are skipped.
+
+void CSnapshot::Restore(){
+  m_pObjectManager->Truncate(m_nObjects, m_nLines);
+
+  for(const CBodyState& s: m_stdBody){
+    b2Body* p = s.m_pBody;
+
+    if(p->GetPosition() != s.m_vPos || p->GetAngle() != s.m_fAngle)
+      p->SetTransform(s.m_vPos, s.m_fAngle);
+
+    if(!s.m_bStatic){
+      p->SetLinearVelocity(s.m_vVel);
+      p->SetAngularVelocity(s.m_fAngVel);
+      p->SetAwake(s.m_bAwake);
+    } //if
+  } //for
+
+  for(const CJointState& s: m_stdJoint)
+    if(s.m_pJoint->GetType() == e_revoluteJoint)
+      ((b2RevoluteJoint*)s.m_pJoint)->SetMotorSpeed(s.m_fMotorSpeed);
+    else ((b2WheelJoint*)s.m_pJoint)->SetMotorSpeed(s.m_fMotorSpeed);
+
+  m_pPhysicsWorld->SetWarmStarting(false); //back on after the next step
+} //Restore
+
+/// Forget the captured state, for example because the level
+/// is about to be rebuilt.
+
+void CSnapshot::Clear(){
+  m_stdBody.clear();
+  m_stdJoint.clear();
+  m_nObjects = m_nLines = 0;
+  m_bCaptured = false;
+} //Clear
+
+/// Reader function for whether a snapshot has been captured.
+/// \return true if a snapshot has been captured.
+
+bool CSnapshot::IsCaptured() const{
+  return m_bCaptured;
+} //IsCaptured
@@ -0,0 +1,59 @@
+/// \file Snapshot.h
+/// \brief Interface for the Physics World snapshot class CSnapshot.
+
+#ifndef __L4RC_GAME_SNAPSHOT_H__
+#define __L4RC_GAME_SNAPSHOT_H__
+
+#include <vector>
+
+#include "Common.h"
+
+/// \brief A snapshot of the Physics World.
+///
+/// Building the level creates hundreds of bodies, fixtures, and joints, and
+/// clearing it destroys them again one at a time. Nothing in the level is
+/// ever destroyed while the machine runs, so instead we capture the state of
+/// every body once, just after the level is built, and restore it to reset
+/// the machine. Restoring is a single pass over a contiguous array of body
+/// states, and another over the joints whose motors the machine drives.
+/// Objects and lines created after the snapshot was captured, such
+/// as the ball, are deleted.
+
+class CSnapshot: public CCommon{
+  private:
+    /// \brief The state of a body.
+
+    struct CBodyState{
+      b2Body* m_pBody; ///< Pointer to body.
+      b2Vec2 m_vPos; ///< Position.
+      float m_fAngle; ///< Orientation.
+      b2Vec2 m_vVel; ///< Linear velocity.
+      float m_fAngVel; ///< Angular velocity.
+      bool m_bAwake; ///< Whether awake.
+      bool m_bStatic; ///< Whether it is a static body.
+    }; //CBodyState
+
+    /// \brief The state of a joint with a motor.
+
+    struct CJointState{
+      b2Joint* m_pJoint; ///< Pointer to joint.
+      float m_fMotorSpeed; ///< Motor speed.
+    }; //CJointState
+
+    std::vector<CBodyState> m_stdBody; ///< Body states.
+    std::vector<CJointState> m_stdJoint; ///< Joint states.
+    size_t m_nObjects = 0; ///< Number of objects in object manager.
+    size_t m_nLines = 0; ///< Number of lines in object manager.
+    bool m_bCaptured = false; ///< Whether a snapshot has been captured.
+
+  public:
+    CSnapshot(CContext& c); ///< Constructor.
+
+    void Capture(); ///< Capture the state of the Physics World.
+    void Restore(); ///< Restore the Physics World to the captured state.
+    void Clear(); ///< Forget the captured state.
+
+    bool IsCaptured() const; ///< Whether a snapshot has been captured.
+}; //CSnapshot
+
+#endif //__L4RC_GAME_SNAPSHOT_H__
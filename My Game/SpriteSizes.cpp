@@ -0,0 +1,195 @@
+/// \file SpriteSizes.cpp
+/// \brief Code for the sprite size table CSpriteSizes.
+
+#include <fstream>
+#include <sstream>
+
+#include "SpriteSizes.h"
+#include "AtlasFile.h"
+
+/// Get the value of an attribute from an XML tag. This is not a general
+/// XML parser, just enough to read the simple one-line tags in
+/// `gamesettings.xml`.
+/// \param tag Text of the XML tag.
+/// \param name Attribute name.
+/// \return Attribute value, or the empty string if there isn't one.
+
+std::string CSpriteSizes::GetAttribute(const std::string& tag, const std::string& name){
+  const std::string key = " " + name + "=\"";
+  const size_t start = tag.find(key);
+  if(start == std::string::npos)return "";
+
+  const size_t first = start + key.size(); //first character of value
+  const size_t last = tag.find('"', first); //one past the last character of value
+  if(last == std::string::npos)return "";
+
+  return tag.substr(first, last - first);
+} //GetAttribute
+
+/// Get the folder that the files listed under a tag in `gamesettings.xml`
+/// are in, such as the sprites or the sounds. The path in the settings
+/// file is taken to be relative to the folder that the settings file's
+/// `Media` folder is in, which is the working directory of the game.
+/// \param settings Path to `gamesettings.xml`.
+/// \param xml Contents of `gamesettings.xml`.
+/// \param name Tag name.
+/// \return Folder, without a slash at the end.
+
+std::string CSpriteSizes::GetFolder(const std::string& settings,
+  const std::string& xml, const std::string& name)
+{
+  //root folder, which contains the Media folder
+
+  std::string root = settings;
+  const size_t media = root.rfind("Media");
+  root = media == std::string::npos? "": root.substr(0, media);
+
+  //path from the root folder
+
+  std::string path;
+  const size_t pos = xml.find("<" + name);
+
+  if(pos != std::string::npos)
+    path = GetAttribute(xml.substr(pos, xml.find('>', pos) - pos), "path");
+
+  for(char& c: path)
+    if(c == '\\')c = '/';
+
+  return root + path;
+} //GetFolder
+
+/// Set the size of a sprite.
+/// \param t Sprite type.
+/// \param w Width in renderer units.
+/// \param h Height in renderer units.
+
+void CSpriteSizes::SetSize(eSprite t, float w, float h){
+  m_vSize[(UINT)t] = Vector2(w, h);
+} //SetSize
+
+/// Read the width and height of an image from its PNG header. The first
+/// chunk of a PNG file must be IHDR, which starts with the width and height
+/// as big-endian 32-bit integers at byte offsets 16 and 20.
+/// \param fname Image file name.
+/// \param w [out] Image width in pixels.
+/// \param h [out] Image height in pixels.
+/// \return true if the file was a readable PNG file.
+
+bool CSpriteSizes::ReadPNGSize(const std::string& fname, float& w, float& h){
+  std::ifstream file(fname, std::ios::binary);
+  unsigned char header[24] = {0}; //signature, IHDR length and tag, width, height
+
+  if(!file.read((char*)header, sizeof(header)))return false;
+  if(header[1] != 'P' || header[2] != 'N' || header[3] != 'G')return false;
+  if(header[12] != 'I' || header[13] != 'H' || header[14] != 'D' || header[15] != 'R')return false;
+
+  auto BigEndian = [&](int i){ //read 32-bit big-endian integer at header[i]
+    return (UINT)header[i] << 24 | (UINT)header[i + 1] << 16 |
+      (UINT)header[i + 2] << 8 | (UINT)header[i + 3];
+  }; //BigEndian
+
+  w = (float)BigEndian(16);
+  h = (float)BigEndian(20);
+
+  return true;
+} //ReadPNGSize
+
+/// Get the names of the image files of the sprites by reading the sprite
+/// list from `gamesettings.xml`.
+/// \param settings Path to `gamesettings.xml`.
+/// \param fname [out] Image file name of each sprite type, which is empty
+///   for sprite types that are not in the settings file.
+/// \return true if the settings file could be read.
+
+bool CSpriteSizes::GetImageFiles(const std::string& settings,
+  std::vector<std::string>& fname)
+{
+  fname.assign((size_t)eSprite::Size, "");
+
+  std::ifstream file(settings);
+  if(!file)return false;
+
+  std::stringstream stream;
+  stream << file.rdbuf();
+  const std::string xml = stream.str(); //contents of settings file
+  const std::string path = GetFolder(settings, xml, "sprites"); //folder containing images
+
+  for(UINT i=0; i<(UINT)eSprite::Size; i++){ //for each sprite type
+    const std::string name = GetSpriteName((eSprite)i);
+    const size_t pos = xml.find("<sprite name=\"" + name + "\"");
+
+    if(pos != std::string::npos){
+      const std::string tag = xml.substr(pos, xml.find('>', pos) - pos);
+      fname[i] = path + "/" + GetAttribute(tag, "file");
+    } //if
+  } //for
+
+  return true;
+} //GetImageFiles
+
+/// Load the sprite sizes without a renderer by reading the size of each
+/// sprite from the header of its image file.
+/// \param settings Path to `gamesettings.xml`.
+/// \return true if every sprite type was found.
+
+bool CSpriteSizes::Load(const std::string& settings){
+  std::vector<std::string> fname; //image file names
+  if(!GetImageFiles(settings, fname))return false;
+
+  bool bFoundAll = true;
+
+  for(UINT i=0; i<(UINT)eSprite::Size; i++){ //for each sprite type
+    float w = 0, h = 0; //sprite width and height
+
+    if(fname[i].empty() || !ReadPNGSize(fname[i], w, h))
+      bFoundAll = false;
+
+    SetSize((eSprite)i, w, h);
+  } //for
+
+  return bFoundAll;
+} //Load
+
+/// Load the sprite sizes from an atlas manifest, which saves opening the
+/// image file of every sprite. The size of a sprite is the size of its
+/// rectangle in the atlas.
+/// \param atlas Atlas manifest.
+/// \return true if every sprite type was in the atlas.
+
+bool CSpriteSizes::Load(const CAtlasFile& atlas){
+  bool bFoundAll = true;
+
+  for(UINT i=0; i<(UINT)eSprite::Size; i++){ //for each sprite type
+    const CAtlasRecord* p = atlas.Get((eSprite)i); //where it is in the atlas
+    if(p == nullptr)bFoundAll = false;
+    SetSize((eSprite)i, p? (float)p->m_nWidth: 0.0f, p? (float)p->m_nHeight: 0.0f);
+  } //for
+
+  return bFoundAll;
+} //Load
+
+/// Reader function for the width and height of a sprite.
+/// \param t Sprite type.
+/// \param w [out] Width in renderer units.
+/// \param h [out] Height in renderer units.
+
+void CSpriteSizes::GetSize(eSprite t, float& w, float& h) const{
+  w = m_vSize[(UINT)t].x;
+  h = m_vSize[(UINT)t].y;
+} //GetSize
+
+/// Reader function for the width of a sprite.
+/// \param t Sprite type.
+/// \return Width in renderer units.
+
+float CSpriteSizes::GetWidth(eSprite t) const{
+  return m_vSize[(UINT)t].x;
+} //GetWidth
+
+/// Reader function for the height of a sprite.
+/// \param t Sprite type.
+/// \return Height in renderer units.
+
+float CSpriteSizes::GetHeight(eSprite t) const{
+  return m_vSize[(UINT)t].y;
+} //GetHeight
@@ -0,0 +1,47 @@
+/// \file SpriteSizes.h
+/// \brief Interface for the sprite size table CSpriteSizes.
+
+#ifndef __L4RC_GAME_SPRITESIZES_H__
+#define __L4RC_GAME_SPRITESIZES_H__
+
+#include <string>
+#include <vector>
+
+#include "GameDefines.h"
+
+class CAtlasFile; //forward declaration
+
+/// \brief The sprite size table.
+///
+/// The Physics World shapes of most objects are made to fit their sprites,
+/// so building the level needs sprite sizes but not the sprites themselves.
+/// The sprite size table remembers the width and height of each sprite in
+/// renderer units so that the level can be built without a renderer.
+/// It can be filled in from the renderer, read directly from the
+/// headers of the image files listed in `gamesettings.xml`, or taken from
+/// an atlas manifest, which has them all in one small file.
+
+class CSpriteSizes{
+  private:
+    Vector2 m_vSize[(UINT)eSprite::Size]; ///< Sprite sizes in renderer units.
+
+    bool ReadPNGSize(const std::string&, float&, float&); ///< Read size of PNG file.
+
+  public:
+    void SetSize(eSprite t, float w, float h); ///< Set sprite size.
+    bool Load(const std::string& settings); ///< Load sizes from image files.
+    bool Load(const CAtlasFile& atlas); ///< Load sizes from atlas manifest.
+
+    static bool GetImageFiles(const std::string& settings,
+      std::vector<std::string>& fname); ///< Get image file names.
+    static std::string GetAttribute(const std::string& tag,
+      const std::string& name); ///< Get attribute from settings tag.
+    static std::string GetFolder(const std::string& settings,
+      const std::string& xml, const std::string& name); ///< Get folder from settings.
+
+    void GetSize(eSprite t, float& w, float& h) const; ///< Get sprite size.
+    float GetWidth(eSprite t) const; ///< Get sprite width.
+    float GetHeight(eSprite t) const; ///< Get sprite height.
+}; //CSpriteSizes
+
+#endif //__L4RC_GAME_SPRITESIZES_H__
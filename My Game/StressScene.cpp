@@ -0,0 +1,218 @@
+/// \file StressScene.cpp
+/// \brief Code for the stress scene generator CStressScene.
+
+#include <algorithm>
+#include <cmath>
+
+#include "StressScene.h"
+#include "SpriteSizes.h"
+
+/// Number of bodies that a part of each sort makes when the level is built.
+/// \param t Sprite type of the part.
+/// \return Number of bodies.
+
+static UINT GetBodyCount(eSprite t){
+  switch(t){
+    case eSprite::Pulleywheel: return 4; //two wheels and two baskets
+    case eSprite::Catapult: return 4; //base, arm, and two wheels
+    case eSprite::Propeller: return 2; //propeller and its pivot
+    case eSprite::Background: return 0; //just the size of the world
+    default: return 1;
+  } //switch
+} //GetBodyCount
+
+/// \param c Simulation context.
+
+CStressScene::CStressScene(CContext& c):
+  CCommon(c){
+} //constructor
+
+/// Add a part to the level in the current tile, unless there are
+/// already enough bodies.
+/// \param t Sprite type of the part.
+/// \param x X coordinate relative to the left of the tile.
+/// \param y Y coordinate relative to the bottom of the tile.
+/// \param a Orientation in radians.
+/// \param param Part-specific parameter.
+/// \return true if the part was added.
+
+bool CStressScene::Add(eSprite t, float x, float y, float a, float param){
+  if(m_nBodies >= m_nTarget)return false;
+
+  const CLevelRecord r = {(UINT)t, m_fX + x, m_fY + y, a, param};
+  m_pLevel->Add(r);
+  m_nBodies += GetBodyCount(t);
+
+  return true;
+} //Add
+
+/// Add a floor of platforms laid end to end across the whole grid.
+/// \param y Height of the middle of the floor.
+/// \param w Width of the grid.
+
+void CStressScene::AddFloor(float y, float w){
+  const float pw = std::max(1.0f, m_pSpriteSizes->GetWidth(eSprite::Platform)); //platform width
+  const UINT n = (UINT)ceilf(w/pw); //number of platforms
+
+  m_fX = 0;
+  m_fY = y;
+
+  for(UINT i=0; i<n; i++) //for each platform
+    if(!Add(eSprite::Platform, (i + 0.5f)*pw, 0.0f))return;
+} //AddFloor
+
+/// Add three shelves, each of two platforms with a row of pins standing on
+/// them, ready to be knocked over.
+
+void CStressScene::AddPins(){
+  float pw, ph; //platform width and height
+  m_pSpriteSizes->GetSize(eSprite::Platform, pw, ph);
+  float w, h; //pin width and height
+  m_pSpriteSizes->GetSize(eSprite::Pin, w, h);
+
+  const float s = std::max(1.0f, 1.5f*w); //distance between pins
+  const UINT n = (UINT)(pw/s); //pins per platform
+
+  for(UINT j=1; j<=3; j++){ //for each shelf
+    const float y = 160.0f*j; //height of shelf
+
+    for(const float x: {m_nWinWidth/4.0f, 3.0f*m_nWinWidth/4.0f}){ //for each platform
+      if(!Add(eSprite::Platform, x, y))return;
+
+      for(UINT i=0; i<n; i++) //for each pin
+        if(!Add(eSprite::Pin, x - pw/2.0f + (i + 0.5f)*s, y + (ph + h)/2.0f))
+          return;
+    } //for
+  } //for
+} //AddPins
+
+/// Add four towers like the one in the level file: a stick across two
+/// upright sticks, with a pyramid of six blocks on top.
+
+void CStressScene::AddTowers(){
+  float sw, sh; //stick width and height
+  m_pSpriteSizes->GetSize(eSprite::Stick, sw, sh);
+  float bw, bh; //block width and height
+  m_pSpriteSizes->GetSize(eSprite::Block, bw, bh);
+
+  const float y = sw + sh; //top of the stick across
+
+  for(UINT i=0; i<4; i++){ //for each tower
+    const float x = (i + 0.5f)*m_nWinWidth/4.0f; //middle of tower
+
+    if(!Add(eSprite::Stick, x - (sw - sh)/2.0f, sw/2.0f, XM_PIDIV2) ||
+      !Add(eSprite::Stick, x + (sw - sh)/2.0f, sw/2.0f, XM_PIDIV2) ||
+      !Add(eSprite::Stick, x, y - sh/2.0f) ||
+      !Add(eSprite::Block, x - bw, y + bh/2.0f) ||
+      !Add(eSprite::Block, x, y + bh/2.0f) ||
+      !Add(eSprite::Block, x + bw, y + bh/2.0f) ||
+      !Add(eSprite::Block, x - bw/2.0f, y + 1.5f*bh) ||
+      !Add(eSprite::Block, x + bw/2.0f, y + 1.5f*bh) ||
+      !Add(eSprite::Block, x, y + 2.5f*bh))
+      return;
+  } //for
+} //AddTowers
+
+/// Add a field of circle bumpers in staggered rows for the balls to
+/// bounce down through.
+
+void CStressScene::AddBumpers(){
+  const float d = m_pSpriteSizes->GetWidth(eSprite::Circlebumper); //diameter
+  const float s = std::max(1.0f, 2.5f*d); //distance between bumpers
+  const UINT nx = (UINT)((m_nWinWidth - s/2.0f)/s); //bumpers per row
+  const UINT ny = (UINT)((m_nWinHeight - 350.0f)/s); //number of rows
+
+  for(UINT j=0; j<ny; j++){ //for each row
+    const float dx = j%2 == 0? 0.0f: s/2.0f; //stagger odd rows
+
+    for(UINT i=0; i<nx; i++) //for each bumper
+      if(!Add(eSprite::Circlebumper, dx + (i + 0.5f)*s, 150.0f + j*s))
+        return;
+  } //for
+} //AddBumpers
+
+/// Add two pulleys like the one in the level file. The pulley puts its
+/// baskets at fixed heights, so this must be done only in the bottom row.
+
+void CStressScene::AddPulleys(){
+  for(const float x: {m_nWinWidth/4.0f, 3.0f*m_nWinWidth/4.0f}) //for each pulley
+    if(!Add(eSprite::Pulleywheel, x, 275.0f, XM_2PI, 190.0f))
+      return;
+} //AddPulleys
+
+/// Add two catapults, each with a bird that drops onto its arm.
+
+void CStressScene::AddCatapults(){
+  for(const float x: {m_nWinWidth/4.0f, 3.0f*m_nWinWidth/4.0f}) //for each catapult
+    if(!Add(eSprite::Catapult, x, 50.0f) || !Add(eSprite::Bird, x - 72.0f, 300.0f))
+      return;
+} //AddCatapults
+
+/// Drop balls into the tile from a grid of cells, each of which may or may
+/// not have a ball in it, from some height to the top of the tile.
+/// \param bottom Height of the bottom of the grid.
+/// \param chance One in this many cells has a ball.
+
+void CStressScene::AddBalls(float bottom, UINT chance){
+  const float s = std::max(1.0f, 1.5f*m_pSpriteSizes->GetWidth(eSprite::Ball)); //cell size
+  const UINT nx = (UINT)(m_nWinWidth/s); //cells per row
+  const UINT ny = (UINT)((m_nWinHeight - bottom)/s); //number of rows
+
+  for(UINT j=0; j<ny; j++) //for each row
+    for(UINT i=0; i<nx; i++) //for each cell
+      if(m_stdRandom()%chance == 0 &&
+        !Add(eSprite::Ball, (i + 0.5f)*s, bottom + (j + 0.5f)*s))
+        return;
+} //AddBalls
+
+/// Generate a level with about a given number of bodies. The tiles are
+/// laid out in a roughly square grid, filled left to right and bottom to
+/// top, and the last tile is cut short when there are enough bodies. The
+/// size of the world is put at the end of the level.
+/// \param nBodies Number of bodies to aim for, including the world edges.
+/// \param seed Random number seed.
+/// \param level [out] The level.
+
+void CStressScene::Generate(UINT nBodies, UINT seed, CLevel& level){
+  level.Unload();
+  m_pLevel = &level;
+  m_stdRandom.seed(seed);
+  m_nTarget = nBodies;
+  m_nBodies = 1; //the world edges
+
+  const float w = (float)m_nWinWidth; //tile width
+  const float h = (float)m_nWinHeight; //tile height
+  const float fFloor = m_pSpriteSizes->GetHeight(eSprite::Platform); //floor thickness
+  const UINT nCols = std::max(1U, (UINT)ceilf(sqrtf(nBodies/100.0f))); //tiles per row
+  UINT nRows = 1; //number of rows of tiles
+
+  for(UINT i=0; m_nBodies<m_nTarget; i++){ //for each tile
+    const UINT row = i/nCols; //row of tile
+    const UINT col = i%nCols; //column of tile
+
+    if(col == 0 && row > 0){ //start of a new row
+      AddFloor(row*h, nCols*w);
+      nRows = row + 1;
+    } //if
+
+    m_fX = col*w;
+    m_fY = row == 0? 0.0f: row*h + fFloor/2.0f;
+
+    bool bDrop = true; //whether to drop balls in
+
+    switch(m_stdRandom()%(row == 0? 6: 5)){ //pulleys only in the bottom row
+      case 0: AddPins(); break;
+      case 1: AddTowers(); break;
+      case 2: AddBumpers(); break;
+      case 3: AddCatapults(); break;
+      case 4: AddBalls(0.0f, 2); bDrop = false; break; //nothing but balls
+      case 5: AddPulleys(); break;
+    } //switch
+
+    if(bDrop)
+      AddBalls(h - 150.0f, 4); //a ball in one cell in four at the top
+  } //for
+
+  const CLevelRecord r = {(UINT)eSprite::Background, nCols*w, (nRows + 1)*h, 0.0f, 0.0f};
+  level.Add(r); //size of world, with a tile of space above the top row
+} //Generate
@@ -0,0 +1,55 @@
+/// \file StressScene.h
+/// \brief Interface for the stress scene generator CStressScene.
+
+#ifndef __L4RC_GAME_STRESSSCENE_H__
+#define __L4RC_GAME_STRESSSCENE_H__
+
+#include <random>
+
+#include "Common.h"
+#include "Settings.h"
+#include "Level.h"
+
+/// \brief The stress scene generator.
+///
+/// The stress scene generator makes levels of any size out of the parts
+/// of the machine, so that we can find out where object manager, the
+/// contact listener, and Physics World stop scaling. The level is a grid
+/// of tiles the size of the window. Each tile is filled with one sort of
+/// part chosen at random: rows of pins on platforms, towers of blocks and
+/// sticks, a field of circle bumpers, pulleys, catapults with their birds,
+/// or nothing but balls. Then balls are dropped into it from above. Every
+/// row of tiles but the bottom one stands on a floor of platforms, and the
+/// world edges go around the whole grid. Parts are added until there are
+/// enough bodies. The same number of bodies and seed always give the same
+/// level.
+
+class CStressScene:
+  public LSettings,
+  public CCommon{
+
+  private:
+    std::mt19937 m_stdRandom; ///< Random number generator.
+    CLevel* m_pLevel = nullptr; ///< The level being generated.
+    UINT m_nBodies = 0; ///< Number of bodies so far.
+    UINT m_nTarget = 0; ///< Number of bodies to aim for.
+    float m_fX = 0; ///< Left of the current tile.
+    float m_fY = 0; ///< Bottom of the current tile.
+
+    bool Add(eSprite t, float x, float y, float a=XM_2PI, float param=0.0f); ///< Add a part.
+
+    void AddFloor(float y, float w); ///< Add a floor of platforms.
+    void AddPins(); ///< Add rows of pins on platforms.
+    void AddTowers(); ///< Add towers of blocks and sticks.
+    void AddBumpers(); ///< Add a field of circle bumpers.
+    void AddPulleys(); ///< Add pulleys.
+    void AddCatapults(); ///< Add catapults and birds.
+    void AddBalls(float bottom, UINT chance); ///< Drop balls in.
+
+  public:
+    CStressScene(CContext& c); ///< Constructor.
+
+    void Generate(UINT nBodies, UINT seed, CLevel& level); ///< Generate a level.
+}; //CStressScene
+
+#endif //__L4RC_GAME_STRESSSCENE_H__
@@ -0,0 +1,344 @@
+/// \file TransformCache.cpp
+/// \brief Code for the transform cache CTransformCache.
+
+#include "TransformCache.h"
+
+//Body flags.
+
+static const BYTE FLAG_STATIC = 1; ///< Static body, or no body.
+static const BYTE FLAG_AWAKE = 2; ///< Awake at the last Gather(), or to be read by the next one anyway.
+static const BYTE FLAG_TOUCHED = 4; ///< Static body moved since the last Gather().
+static const BYTE FLAG_MOVED = 8; ///< In the list of bodies that moved.
+
+/// Add a body to the end of the cache and read its transform, which is
+/// both its current and its previous transform, since it did not exist
+/// before. A body that is not static is read by the next Gather() too.
+/// \param t Sprite type.
+/// \param p Pointer to Physics World body, or nullptr for none.
+
+void CTransformCache::Add(eSprite t, b2Body* p){
+  const UINT i = (UINT)m_stdBody.size(); //index of new body
+  const bool bStatic = p == nullptr || p->GetType() == b2_staticBody;
+
+  m_stdBody.push_back(p);
+  m_stdSprite.push_back(t);
+  m_stdFlags.push_back(bStatic? FLAG_STATIC: FLAG_AWAKE);
+
+  m_stdX.push_back(0);
+  m_stdY.push_back(0);
+  m_stdAngle.push_back(0);
+
+  m_stdPrevX.push_back(0);
+  m_stdPrevY.push_back(0);
+  m_stdPrevAngle.push_back(0);
+
+  if(p){
+    Read(i, m_stdX.data(), m_stdY.data(), m_stdAngle.data());
+    Read(i, m_stdPrevX.data(), m_stdPrevY.data(), m_stdPrevAngle.data());
+  } //if
+
+  if(!bStatic)
+    m_stdDynamic.push_back(i);
+} //Add
+
+/// Remove the bodies that were added after there were a given number of them.
+/// This is done when the machine is reset, and the bodies that are left
+/// may then be moved back to where they were, so every one of them is read
+/// again by the next Gather() or GatherPrevious().
+/// \param n Number of bodies to keep.
+
+void CTransformCache::Truncate(size_t n){
+  if(n < m_stdBody.size()){
+    m_stdBody.resize(n);
+    m_stdSprite.resize(n);
+    m_stdFlags.resize(n);
+    m_stdX.resize(n);
+    m_stdY.resize(n);
+    m_stdAngle.resize(n);
+    m_stdPrevX.resize(n);
+    m_stdPrevY.resize(n);
+    m_stdPrevAngle.resize(n);
+
+    while(!m_stdDynamic.empty() && m_stdDynamic.back() >= n)
+      m_stdDynamic.pop_back();
+  } //if
+
+  for(BYTE& f: m_stdFlags) //for each body
+    f &= ~(FLAG_TOUCHED | FLAG_MOVED);
+
+  m_stdTouched.clear();
+  m_stdMoved.clear();
+  m_bInvalid = true;
+  m_nGeneration++;
+} //Truncate
+
+/// Remove all bodies from the cache. The bodies themselves are not destroyed.
+
+void CTransformCache::Clear(){
+  Truncate(0);
+} //Clear
+
+/// Read the position and orientation of one body into float arrays,
+/// converting the position from Physics World units to renderer units.
+/// \param i Index.
+/// \param x [out] X coordinates.
+/// \param y [out] Y coordinates.
+/// \param a [out] Orientations.
+
+void CTransformCache::Read(size_t i, float* x, float* y, float* a) const{
+  const b2Body* p = m_stdBody[i];
+  const b2Vec2& v = p->GetPosition(); //position in Physics World units
+
+  x[i] = v.x*fPRV;
+  y[i] = v.y*fPRV;
+  a[i] = p->GetAngle();
+} //Read
+
+/// Read the transform of every body into both the current and the previous
+/// transforms, so that nothing is interpolated, and note which of them
+/// are awake. Every body counts as having moved.
+
+void CTransformCache::ReadAll(){
+  m_stdMoved.clear();
+
+  for(size_t i=0; i<m_stdBody.size(); i++){ //for each body
+    const b2Body* p = m_stdBody[i];
+    m_stdFlags[i] |= FLAG_MOVED;
+    m_stdMoved.push_back((UINT)i);
+    if(p == nullptr)continue;
+
+    Read(i, m_stdX.data(), m_stdY.data(), m_stdAngle.data());
+    m_stdPrevX[i] = m_stdX[i];
+    m_stdPrevY[i] = m_stdY[i];
+    m_stdPrevAngle[i] = m_stdAngle[i];
+
+    if(!(m_stdFlags[i] & FLAG_STATIC)){
+      if(p->IsAwake())m_stdFlags[i] |= FLAG_AWAKE;
+      else m_stdFlags[i] &= ~FLAG_AWAKE;
+    } //if
+  } //for
+
+  m_bInvalid = false;
+} //ReadAll
+
+/// Gather the current transforms from Physics World, but only of the
+/// bodies that can have moved since the last time: the non-static bodies
+/// that are awake now or were awake then, and the static bodies that were
+/// touched. A body that has fallen asleep is read one last time, and its
+/// previous transform is set to match, since it will stay where it is
+/// until it wakes. Box2D keeps a body awake for half a second after it
+/// comes to rest, so it cannot wake and fall asleep again between two
+/// calls. The same goes for a touched static body, which is not
+/// interpolated. The cost for each sleeping body is one flag test. The
+/// bodies that are read are added to the list of bodies that moved, if
+/// they are not in it already.
+
+void CTransformCache::Gather(){
+  if(m_bInvalid){ //read everything
+    ReadAll();
+    return;
+  } //if
+
+  m_stdRead.clear();
+
+  for(UINT i: m_stdDynamic){ //for each non-static body
+    BYTE& f = m_stdFlags[i];
+
+    if(m_stdBody[i]->IsAwake()){
+      f |= FLAG_AWAKE;
+      m_stdRead.push_back(i);
+    } //if
+
+    else if(f & FLAG_AWAKE){ //fallen asleep
+      f &= ~FLAG_AWAKE;
+      m_stdRead.push_back(i);
+    } //else if
+  } //for
+
+  for(UINT i: m_stdTouched){ //for each touched static body
+    m_stdFlags[i] &= ~FLAG_TOUCHED;
+    m_stdRead.push_back(i);
+  } //for
+
+  m_stdTouched.clear();
+
+  for(UINT i: m_stdRead){ //for each body to be read
+    BYTE& f = m_stdFlags[i];
+    Read(i, m_stdX.data(), m_stdY.data(), m_stdAngle.data());
+
+    if(!(f & FLAG_AWAKE)){ //won't move again until touched or woken
+      m_stdPrevX[i] = m_stdX[i];
+      m_stdPrevY[i] = m_stdY[i];
+      m_stdPrevAngle[i] = m_stdAngle[i];
+    } //if
+
+    if(!(f & FLAG_MOVED)){
+      f |= FLAG_MOVED;
+      m_stdMoved.push_back(i);
+    } //if
+  } //for
+} //Gather
+
+/// Gather the previous transforms from Physics World. This is done just
+/// before the last physics step of a frame, so that the draw pass can
+/// interpolate between the transforms before and after it. Only the
+/// non-static bodies that are awake, or were at the last Gather(), are
+/// read. Every other body's previous transform is already the same as
+/// its current one.
+
+void CTransformCache::GatherPrevious(){
+  if(m_bInvalid){ //read everything
+    ReadAll();
+    return;
+  } //if
+
+  for(UINT i: m_stdDynamic) //for each non-static body
+    if((m_stdFlags[i] & FLAG_AWAKE) || m_stdBody[i]->IsAwake())
+      Read(i, m_stdPrevX.data(), m_stdPrevY.data(), m_stdPrevAngle.data());
+} //GatherPrevious
+
+/// Replace the current transforms of the bodies that moved with a blend of
+/// their previous and current ones. The orientations from Box2D are not
+/// wrapped into a fixed range, so they can be blended directly. This
+/// leaves the current transforms wrong, but every body that it blends
+/// is either awake, and will be read again by the next Gather(), or has
+/// the same previous and current transforms.
+/// \param alpha Fraction of the way from previous to current, from 0 to 1.
+
+void CTransformCache::Interpolate(float alpha){
+  if(alpha >= 1.0f)return; //nothing to do
+
+  float* x = m_stdX.data(); //x coordinates
+  float* y = m_stdY.data(); //y coordinates
+  float* a = m_stdAngle.data(); //orientations
+
+  const float* px = m_stdPrevX.data(); //previous x coordinates
+  const float* py = m_stdPrevY.data(); //previous y coordinates
+  const float* pa = m_stdPrevAngle.data(); //previous orientations
+
+  for(UINT i: m_stdMoved){ //for each body that moved
+    x[i] = px[i] + alpha*(x[i] - px[i]);
+    y[i] = py[i] + alpha*(y[i] - py[i]);
+    a[i] = pa[i] + alpha*(a[i] - pa[i]);
+  } //for
+} //Interpolate
+
+/// Set a transform directly. This is for a cache whose bodies were added
+/// as nullptr, such as the one that a replay is decoded into, since
+/// Gather() would overwrite it.
+/// \param i Index.
+/// \param x X coordinate in renderer units.
+/// \param y Y coordinate in renderer units.
+/// \param a Orientation.
+
+void CTransformCache::Set(size_t i, float x, float y, float a){
+  m_stdX[i] = x;
+  m_stdY[i] = y;
+  m_stdAngle[i] = a;
+} //Set
+
+/// Note that a body has been moved by something other than a physics
+/// step, such as a static body that was moved with SetTransform(), so
+/// that the next Gather() reads it. Touching a body more than once before
+/// then does no more work.
+/// \param i Index.
+
+void CTransformCache::Touch(size_t i){
+  BYTE& f = m_stdFlags[i];
+
+  if(!(f & FLAG_STATIC))
+    f |= FLAG_AWAKE; //read it whether it is awake or not
+
+  else if(m_stdBody[i] && !(f & FLAG_TOUCHED)){
+    f |= FLAG_TOUCHED;
+    m_stdTouched.push_back((UINT)i);
+  } //else if
+} //Touch
+
+/// Empty the list of bodies that moved. This is done by the draw pass once
+/// it has drawn them.
+
+void CTransformCache::ClearMoved(){
+  for(UINT i: m_stdMoved) //for each body that moved
+    m_stdFlags[i] &= ~FLAG_MOVED;
+
+  m_stdMoved.clear();
+  m_nClearCount++;
+} //ClearMoved
+
+/// Reader function for the number of bodies.
+/// \return Number of bodies.
+
+size_t CTransformCache::GetSize() const{
+  return m_stdBody.size();
+} //GetSize
+
+/// Reader function for a body.
+/// \param i Index.
+/// \return Pointer to Physics World body.
+
+b2Body* CTransformCache::GetBody(size_t i) const{
+  return m_stdBody[i];
+} //GetBody
+
+/// Reader function for a sprite type.
+/// \param i Index.
+/// \return Sprite type.
+
+eSprite CTransformCache::GetSprite(size_t i) const{
+  return m_stdSprite[i];
+} //GetSprite
+
+/// Reader function for the generation, which changes whenever every body
+/// is to be read again, so that anything kept for each body since the
+/// last generation must be worked out again too.
+/// \return Generation.
+
+UINT CTransformCache::GetGeneration() const{
+  return m_nGeneration;
+} //GetGeneration
+
+/// Reader function for the number of times that the list of bodies that
+/// moved has been emptied by ClearMoved(). Anything kept up to date from
+/// that list must have seen it before each time.
+/// \return Number of times that the list was emptied.
+
+UINT CTransformCache::GetClearCount() const{
+  return m_nClearCount;
+} //GetClearCount
+
+/// Reader function for the number of bodies read since the last ClearMoved().
+/// \return Number of bodies that moved.
+
+size_t CTransformCache::GetMovedCount() const{
+  return m_stdMoved.size();
+} //GetMovedCount
+
+/// Reader function for the indices of the bodies read since the last
+/// ClearMoved(), in the order that they were first read.
+/// \return Pointer to indices of bodies that moved.
+
+const UINT* CTransformCache::GetMoved() const{
+  return m_stdMoved.data();
+} //GetMoved
+
+/// Reader function for the X coordinates gathered by the last call to Gather().
+/// \return Pointer to X coordinates in renderer units.
+
+const float* CTransformCache::GetX() const{
+  return m_stdX.data();
+} //GetX
+
+/// Reader function for the Y coordinates gathered by the last call to Gather().
+/// \return Pointer to Y coordinates in renderer units.
+
+const float* CTransformCache::GetY() const{
+  return m_stdY.data();
+} //GetY
+
+/// Reader function for the orientations gathered by the last call to Gather().
+/// \return Pointer to orientations.
+
+const float* CTransformCache::GetAngle() const{
+  return m_stdAngle.data();
+} //GetAngle
@@ -0,0 +1,84 @@
+/// \file TransformCache.h
+/// \brief Interface for the transform cache CTransformCache.
+
+#ifndef __L4RC_GAME_TRANSFORMCACHE_H__
+#define __L4RC_GAME_TRANSFORMCACHE_H__
+
+#include <vector>
+
+#include "GameDefines.h"
+
+/// \brief The transform cache.
+///
+/// The transform cache keeps the Physics World bodies of the game objects
+/// and their sprite types in parallel arrays, in the order that they were
+/// created. Once per frame, Gather() copies the position and orientation of
+/// every body into contiguous arrays of floats and converts the positions
+/// to renderer units in a single pass over those arrays, so that the draw
+/// pass can read them in order instead of chasing a pointer to each body.
+/// GatherPrevious() keeps a second copy from before the last physics step,
+/// so that the draw pass can blend the two with Interpolate() when the
+/// frame falls between physics steps.
+///
+/// Most of a level is static or asleep most of the time, so only the
+/// bodies that can have moved are read. Static bodies are read when they
+/// are added and never again, unless the code that moves them says so
+/// with Touch(). Non-static bodies are read while they are awake, and
+/// once more after they fall asleep. The bodies that have been read since
+/// the last ClearMoved() are listed, so that the work done on them by the
+/// draw pass also scales with the number of bodies that moved. After
+/// Truncate(), every body is read again, since the bodies that are left
+/// may have been moved back to where they were.
+
+class CTransformCache{
+  private:
+    std::vector<b2Body*> m_stdBody; ///< Physics World bodies.
+    std::vector<eSprite> m_stdSprite; ///< Sprite types.
+    std::vector<BYTE> m_stdFlags; ///< Body flags.
+
+    std::vector<UINT> m_stdDynamic; ///< Indices of non-static bodies.
+    std::vector<UINT> m_stdTouched; ///< Indices of static bodies moved since the last Gather().
+    std::vector<UINT> m_stdRead; ///< Indices of bodies to be read by Gather().
+    std::vector<UINT> m_stdMoved; ///< Indices of bodies read since the last ClearMoved().
+    bool m_bInvalid = false; ///< Whether every body must be read again.
+    UINT m_nGeneration = 0; ///< Incremented when every body must be read again.
+    UINT m_nClearCount = 0; ///< Number of times that the list of bodies that moved was emptied.
+
+    std::vector<float> m_stdX; ///< X coordinates in renderer units.
+    std::vector<float> m_stdY; ///< Y coordinates in renderer units.
+    std::vector<float> m_stdAngle; ///< Orientations.
+
+    std::vector<float> m_stdPrevX; ///< Previous X coordinates in renderer units.
+    std::vector<float> m_stdPrevY; ///< Previous Y coordinates in renderer units.
+    std::vector<float> m_stdPrevAngle; ///< Previous orientations.
+
+    void Read(size_t i, float* x, float* y, float* a) const; ///< Read a transform from Physics World.
+    void ReadAll(); ///< Read every transform from Physics World.
+
+  public:
+    void Add(eSprite t, b2Body* p); ///< Add a body.
+    void Truncate(size_t n); ///< Remove newest bodies.
+    void Clear(); ///< Remove all bodies.
+
+    void Gather(); ///< Gather transforms from Physics World.
+    void GatherPrevious(); ///< Gather previous transforms from Physics World.
+    void Interpolate(float alpha); ///< Blend previous and current transforms.
+    void Set(size_t i, float x, float y, float a); ///< Set a transform.
+    void Touch(size_t i); ///< Note that a body was moved by hand.
+    void ClearMoved(); ///< Empty the list of bodies that moved.
+
+    size_t GetSize() const; ///< Get number of bodies.
+    b2Body* GetBody(size_t i) const; ///< Get body.
+    eSprite GetSprite(size_t i) const; ///< Get sprite type.
+    UINT GetGeneration() const; ///< Get generation.
+    UINT GetClearCount() const; ///< Get number of times the list of bodies that moved was emptied.
+
+    size_t GetMovedCount() const; ///< Get number of bodies that moved.
+    const UINT* GetMoved() const; ///< Get indices of bodies that moved.
+
+    const float* GetX() const; ///< Get X coordinates.
+    const float* GetY() const; ///< Get Y coordinates.
+    const float* GetAngle() const; ///< Get orientations.
+}; //CTransformCache
+
+#endif //__L4RC_GAME_TRANSFORMCACHE_H__
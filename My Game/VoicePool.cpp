@@ -0,0 +1,254 @@
+/// \file VoicePool.cpp
+/// \brief Code for the voice pool CVoicePool.
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+
+#include "VoicePool.h"
+#include "SpriteSizes.h"
+#include "ComponentIncludes.h"
+
+/// Read the length of a sound from the header of its WAV file, which is
+/// the size of its data chunk divided by the number of bytes per second
+/// in its fmt chunk. Chunks are padded to an even number of bytes.
+/// \param fname Sound file name.
+/// \param length [out] Length of the sound in seconds.
+/// \return true if the file was a readable WAV file.
+
+bool CVoicePool::ReadWAVLength(const std::string& fname, float& length){
+  std::ifstream file(fname, std::ios::binary);
+  unsigned char header[12] = {0}; //RIFF tag, size, WAVE tag
+
+  if(!file.read((char*)header, sizeof(header)))return false;
+  if(memcmp(header, "RIFF", 4) || memcmp(header + 8, "WAVE", 4))return false;
+
+  auto LittleEndian = [](const unsigned char* p){ //read 32-bit little-endian integer at p
+    return (UINT)p[0] | (UINT)p[1] << 8 | (UINT)p[2] << 16 | (UINT)p[3] << 24;
+  }; //LittleEndian
+
+  UINT nByteRate = 0; //bytes per second, from the fmt chunk
+  unsigned char chunk[12] = {0}; //chunk tag and size, then start of fmt chunk
+
+  while(file.read((char*)chunk, 8)){ //for each chunk
+    const UINT size = LittleEndian(chunk + 4); //chunk size without padding
+    UINT skip = size + (size & 1); //bytes to the next chunk
+
+    if(!memcmp(chunk, "data", 4)){
+      if(nByteRate == 0)return false; //no fmt chunk before it
+      length = (float)size/nByteRate;
+      return true;
+    } //if
+
+    if(!memcmp(chunk, "fmt ", 4)){
+      if(size < 12 || !file.read((char*)chunk, 12))return false;
+      nByteRate = LittleEndian(chunk + 8);
+      skip -= 12;
+    } //if
+
+    file.seekg(skip, std::ios::cur);
+  } //while
+
+  return false;
+} //ReadWAVLength
+
+/// Set the number of voices of every sound to its number of instances in
+/// `gamesettings.xml`, which is how many the audio player can play at
+/// once, and its length to the length of its sound file. A sound tag
+/// without an instances attribute has one instance.
+/// \param settings Path to `gamesettings.xml`.
+/// \return true if every sound was found and its sound file could be read.
+
+bool CVoicePool::Load(const std::string& settings){
+  std::ifstream file(settings);
+  if(!file)return false;
+
+  std::stringstream stream;
+  stream << file.rdbuf();
+  const std::string xml = stream.str(); //contents of settings file
+  const std::string path = CSpriteSizes::GetFolder(settings, xml, "sounds"); //folder containing sounds
+
+  bool bFoundAll = true;
+
+  for(UINT i=0; i<eSound::Size; i++){ //for each sound
+    const std::string name = GetSoundName((eSound)i);
+    const size_t pos = xml.find("<sound name=\"" + name + "\"");
+
+    UINT n = 0; //number of instances
+    float length = 0; //length in seconds
+
+    if(pos == std::string::npos)bFoundAll = false;
+
+    else{
+      const std::string tag = xml.substr(pos, xml.find('>', pos) - pos);
+      const std::string instances = CSpriteSizes::GetAttribute(tag, "instances");
+      n = instances.empty()? 1: (UINT)strtoul(instances.c_str(), nullptr, 10);
+
+      if(!ReadWAVLength(path + "/" + CSpriteSizes::GetAttribute(tag, "file"), length))
+        bFoundAll = false;
+    } //else
+
+    SetVoices((eSound)i, n, length);
+  } //for
+
+  return bFoundAll;
+} //Load
+
+/// Set how many instances of a sound the audio player can play at once,
+/// which should be the number of instances in `gamesettings.xml`, and how
+/// long the sound is. A sound with no voices is never played. Load() does
+/// this for every sound.
+/// \param t Sound.
+/// \param n Number of voices, at most MAXVOICES.
+/// \param length Length of the sound in seconds.
+
+void CVoicePool::SetVoices(eSound t, UINT n, float length){
+  m_nVoices[t] = std::min(n, MAXVOICES);
+  m_fLength[t] = length;
+
+  for(CVoice& v: m_pVoice[t])
+    v = CVoice();
+} //SetVoices
+
+/// Writer function for the cluster radius.
+/// \param r Cluster radius in renderer units.
+
+void CVoicePool::SetRadius(float r){
+  m_fRadius = r;
+} //SetRadius
+
+/// How loud a voice still is, which is its volume scaled down linearly
+/// from when it started to the end of the sound.
+/// \param t Sound.
+/// \param v Voice.
+/// \param time Current time in seconds.
+/// \return Loudness, 0 if it has finished.
+
+float CVoicePool::GetLoudness(eSound t, const CVoice& v, float time) const{
+  const float age = time - v.m_fStart; //how long it has been playing
+  if(age >= m_fLength[t] || age < 0.0f)return 0.0f;
+  return v.m_fVolume*(1.0f - age/m_fLength[t]);
+} //GetLoudness
+
+/// Ask for a sound to be played at a position at the end of the frame.
+/// If a sound the same was asked for nearby this frame, the request is
+/// merged into its cluster, which takes the position and volume of the
+/// louder of the two. Otherwise it starts a new cluster. If there are
+/// already as many clusters as there can be, it replaces the quietest if
+/// it is louder than that.
+/// \param t Sound.
+/// \param pos Position in renderer coordinates.
+/// \param vol Volume.
+
+void CVoicePool::Add(eSound t, const Vector2& pos, float vol){
+  m_nRequests++;
+
+  const float r2 = m_fRadius*m_fRadius; //cluster radius squared
+  CSoundEvent* pQuietest = nullptr; //quietest cluster
+
+  for(UINT i=0; i<m_nEvents; i++){ //for each cluster
+    CSoundEvent& e = m_pEvent[i];
+    const float dx = e.m_vPos.x - pos.x, dy = e.m_vPos.y - pos.y;
+
+    if(e.m_eSound == t && dx*dx + dy*dy <= r2){ //merge
+      if(vol > e.m_fVolume){
+        e.m_vPos = pos;
+        e.m_fVolume = vol;
+      } //if
+
+      return;
+    } //if
+
+    if(pQuietest == nullptr || e.m_fVolume < pQuietest->m_fVolume)
+      pQuietest = &e;
+  } //for
+
+  CSoundEvent* p = nullptr; //where it goes
+
+  if(m_nEvents < MAXEVENTS)p = &m_pEvent[m_nEvents++]; //new cluster
+  else if(vol > pQuietest->m_fVolume)p = pQuietest; //replaces the quietest
+  else return; //full, and quieter than all of the clusters
+
+  p->m_eSound = t;
+  p->m_vPos = pos;
+  p->m_fVolume = vol;
+} //Add
+
+/// Play the sounds asked for this frame, loudest first. Each cluster gets
+/// the voice of its sound that is least loud now, provided that it is
+/// louder than that voice, and the audio player is asked to play it. The
+/// clusters are then forgotten.
+/// \param time Current time in seconds.
+/// \return Number of sounds played.
+
+UINT CVoicePool::Flush(float time){
+  std::sort(m_pEvent, m_pEvent + m_nEvents, [](const CSoundEvent& a, const CSoundEvent& b){
+    return a.m_fVolume > b.m_fVolume;
+  }); //sort
+
+  UINT nPlays = 0; //number of sounds played
+
+  for(UINT i=0; i<m_nEvents; i++){ //for each cluster, loudest first
+    const CSoundEvent& e = m_pEvent[i];
+    CVoice* pVoice = nullptr; //least loud voice
+    float fLeast = 0; //its loudness
+
+    for(UINT j=0; j<m_nVoices[e.m_eSound]; j++){ //for each voice of this sound
+      CVoice& v = m_pVoice[e.m_eSound][j];
+      const float f = GetLoudness(e.m_eSound, v, time);
+
+      if(pVoice == nullptr || f < fLeast){
+        pVoice = &v;
+        fLeast = f;
+      } //if
+    } //for
+
+    if(pVoice != nullptr && e.m_fVolume > fLeast){ //free, or faded below it
+      pVoice->m_fStart = time;
+      pVoice->m_fVolume = e.m_fVolume;
+      m_pAudio->play(e.m_eSound, e.m_vPos, e.m_fVolume);
+      nPlays++;
+    } //if
+  } //for
+
+  m_nEvents = 0;
+  m_nPlays += nPlays;
+  return nPlays;
+} //Flush
+
+/// Forget the sounds asked for this frame and the voices that are playing,
+/// for when the audio player has been stopped, and reset the counts.
+
+void CVoicePool::Clear(){
+  m_nEvents = 0;
+  m_nRequests = m_nPlays = 0;
+
+  for(UINT i=0; i<eSound::Size; i++)
+    for(CVoice& v: m_pVoice[i])
+      v = CVoice();
+} //Clear
+
+/// Reader function for the number of requests, which is the number of
+/// times Add() was called since Clear().
+/// \return Number of requests.
+
+UINT CVoicePool::GetRequestCount() const{
+  return m_nRequests;
+} //GetRequestCount
+
+/// Reader function for the number of sounds played since Clear().
+/// \return Number of sounds played.
+
+UINT CVoicePool::GetPlayCount() const{
+  return m_nPlays;
+} //GetPlayCount
+
+/// Reader function for the number of voices of a sound.
+/// \param t Sound.
+/// \return Number of voices.
+
+UINT CVoicePool::GetVoiceCount(eSound t) const{
+  return m_nVoices[t];
+} //GetVoiceCount
@@ -0,0 +1,81 @@
+/// \file VoicePool.h
+/// \brief Interface for the voice pool CVoicePool.
+
+#ifndef __L4RC_GAME_VOICEPOOL_H__
+#define __L4RC_GAME_VOICEPOOL_H__
+
+#include <string>
+
+#include "Component.h"
+#include "GameDefines.h"
+
+/// \brief A sound event.
+///
+/// A request to play a sound at a position, or the cluster of requests
+/// near the same position that it has been merged with.
+
+struct CSoundEvent{
+  eSound m_eSound = eSound::Size; ///< Sound.
+  Vector2 m_vPos; ///< Position in renderer coordinates.
+  float m_fVolume = 0; ///< Volume.
+}; //CSoundEvent
+
+/// \brief A voice.
+///
+/// One of the instances of a sound that the audio player can play at once,
+/// as the voice pool thinks of it.
+
+struct CVoice{
+  float m_fStart = 0; ///< Time it started, in seconds.
+  float m_fVolume = 0; ///< Volume it started at, 0 if it has never played.
+}; //CVoice
+
+/// \brief The voice pool.
+///
+/// The audio player can only play a few instances of each sound at once,
+/// so there is no point asking it for dozens when a tower falls over,
+/// which only makes work that is thrown away. Instead, requests are added
+/// to the voice pool during a frame and sent to the audio player at the
+/// end of it by Flush(). Requests for the same sound near one another are
+/// merged into one cluster that is as loud as the loudest of them, and
+/// only the loudest clusters get a voice. A voice that is still playing
+/// is taken over by a louder cluster once it has faded below it, where a
+/// voice's loudness is its volume scaled down linearly over the length of
+/// the sound. Sounds that don't go through the voice pool are unaffected.
+/// How many voices each sound has, and how long it is, are read from
+/// `gamesettings.xml` and the sound files by Load().
+
+class CVoicePool: public LComponent{
+  private:
+    static const UINT MAXEVENTS = 32; ///< Most clusters per frame.
+    static const UINT MAXVOICES = 8; ///< Most voices per sound.
+
+    CSoundEvent m_pEvent[MAXEVENTS]; ///< Clusters gathered this frame.
+    UINT m_nEvents = 0; ///< Number of clusters gathered this frame.
+
+    CVoice m_pVoice[eSound::Size][MAXVOICES]; ///< Voices of each sound.
+    UINT m_nVoices[eSound::Size] = {0}; ///< Number of voices of each sound.
+    float m_fLength[eSound::Size] = {0}; ///< Length of each sound in seconds.
+    float m_fRadius = 64.0f; ///< Cluster radius in renderer units.
+
+    UINT m_nRequests = 0; ///< Number of requests since Clear().
+    UINT m_nPlays = 0; ///< Number of sounds played since Clear().
+
+    float GetLoudness(eSound t, const CVoice& v, float time) const; ///< Get loudness of a voice.
+    bool ReadWAVLength(const std::string&, float&); ///< Read length of WAV file.
+
+  public:
+    bool Load(const std::string& settings); ///< Load numbers of voices and lengths.
+    void SetVoices(eSound t, UINT n, float length); ///< Set number of voices of a sound.
+    void SetRadius(float r); ///< Set cluster radius.
+
+    void Add(eSound t, const Vector2& pos, float vol); ///< Ask for a sound.
+    UINT Flush(float time); ///< Play the loudest sounds asked for.
+    void Clear(); ///< Forget the sounds asked for and the voices playing.
+
+    UINT GetRequestCount() const; ///< Get number of requests.
+    UINT GetPlayCount() const; ///< Get number of sounds played.
+    UINT GetVoiceCount(eSound t) const; ///< Get number of voices of a sound.
+}; //CVoicePool
+
+#endif //__L4RC_GAME_VOICEPOOL_H__
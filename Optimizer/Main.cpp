@@ -0,0 +1,77 @@
+/// \file Main.cpp
+/// \brief Command-line parameter optimizer for the machine.
+///
+/// Searches for the tuning parameters that make the Rube Goldberg machine
+/// reach the pig in the shortest simulated time, using COptimizer. Each
+/// candidate set of parameters is tried by running the level headless in
+/// a new simulation context and Physics World until it finishes or times
+/// out. Candidates are run in batches spread over the threads. The
+/// search starts with the hand-tuned parameters and a number of random
+/// ones, then refines the best so far by trying steps up and down in each
+/// parameter and a fixed number of random steps in all of them, halving
+/// the step size whenever a round finds nothing better. The candidates
+/// are chosen on the main thread from a seeded random number generator,
+/// so for a given seed the results do not depend on the number of
+/// threads. Output is comma-separated values, one line per candidate,
+/// followed by the best candidate. Usage:
+///
+///     Optimizer [-settings file] [-level file] [-hulls file] [-dt seconds]
+///       [-timeout seconds] [-samples n] [-rounds n] [-threads n] [-seed n]
+///
+/// The settings and level files default to the ones that the headless
+/// driver uses, and as there, the hand-made collision shapes are used
+/// unless `-hulls` gives a hull file. There are 64 random samples and at
+/// most 32 rounds of refinement by default, and one thread per hardware
+/// thread.
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <thread>
+
+#include "Optimizer.h"
+
+/// Read the command line arguments, then initialize and run the optimizer.
+/// \param argc Number of command line arguments.
+/// \param argv Command line arguments.
+/// \return 0 if any candidate finished, otherwise 1.
+
+int main(int argc, char* argv[]){
+  std::string settings = "Media/XML/gamesettings.xml"; //settings file
+  std::string level = "Media/Levels/machine.lvl"; //level file
+  std::string hulls; //hull file, none by default
+  float dt = fStepTime; //frame time
+  float timeout = 120.0f; //timeout in seconds of simulated time
+  UINT samples = 64; //number of random samples
+  UINT rounds = 32; //greatest number of rounds of refinement
+  UINT threads = std::thread::hardware_concurrency(); //number of threads
+  UINT seed = 1; //random number seed
+
+  for(int i=1; i<argc; i++){ //for each argument
+    const bool bHasValue = i + 1 < argc;
+
+    if(bHasValue && !strcmp(argv[i], "-settings"))settings = argv[++i];
+    else if(bHasValue && !strcmp(argv[i], "-level"))level = argv[++i];
+    else if(bHasValue && !strcmp(argv[i], "-hulls"))hulls = argv[++i];
+    else if(bHasValue && !strcmp(argv[i], "-dt"))dt = (float)atof(argv[++i]);
+    else if(bHasValue && !strcmp(argv[i], "-timeout"))timeout = (float)atof(argv[++i]);
+    else if(bHasValue && !strcmp(argv[i], "-samples"))samples = (UINT)atoi(argv[++i]);
+    else if(bHasValue && !strcmp(argv[i], "-rounds"))rounds = (UINT)atoi(argv[++i]);
+    else if(bHasValue && !strcmp(argv[i], "-threads"))threads = (UINT)atoi(argv[++i]);
+    else if(bHasValue && !strcmp(argv[i], "-seed"))seed = (UINT)atoi(argv[++i]);
+
+    else{
+      fprintf(stderr, "Usage: %s [-settings file] [-level file] [-hulls file] [-dt seconds]"
+        " [-timeout seconds] [-samples n] [-rounds n] [-threads n] [-seed n]\n", argv[0]);
+      return 1;
+    } //else
+  } //for
+
+  COptimizer cOptimizer(threads, seed); //the optimizer
+
+  if(!cOptimizer.Initialize(settings, level, hulls, dt, timeout))
+    return 1;
+
+  return cOptimizer.Run(samples, rounds)? 0: 1;
+} //main
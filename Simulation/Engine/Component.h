@@ -0,0 +1,52 @@
+/// \file Component.h
+/// \brief Headless stand-in for the Engine's component class LComponent.
+
+#ifndef __L4RC_HEADLESS_COMPONENT_H__
+#define __L4RC_HEADLESS_COMPONENT_H__
+
+#include "Defines.h"
+
+/// \brief Headless timer.
+///
+/// There is no real time in a headless simulation, so the timer just counts
+/// simulated time in frames of a fixed length. Tick() advances the clock by
+/// one frame and calls its argument, just like the Engine's timer does.
+
+class LTimer{
+  private:
+    float m_fTime = 0.0f; ///< Simulated time in seconds.
+    float m_fFrameTime = 1.0f/60.0f; ///< Frame time in seconds.
+
+  public:
+    void SetFrameTime(float t){m_fFrameTime = t;}; ///< Set frame time.
+    void Tick(const std::function<void()>& f){m_fTime += m_fFrameTime; f();}; ///< Advance one frame.
+
+    float GetTime() const{return m_fTime;}; ///< Get simulated time.
+    float GetFrameTime() const{return m_fFrameTime;}; ///< Get frame time.
+}; //LTimer
+
+/// \brief Headless audio player.
+///
+/// There is nobody to listen, so all of the audio functions do nothing.
+
+class LSound{
+  public:
+    void Initialize(UINT){}; ///< Initialize.
+    void Load(UINT, const char*){}; ///< Load a sound.
+    void play(UINT){}; ///< Play a sound.
+    void play(UINT, const Vector2&, float){}; ///< Play a sound at a position.
+    void stop(){}; ///< Stop all sounds.
+    void BeginFrame(){}; ///< Notify of start of frame.
+}; //LSound
+
+/// \brief Headless component.
+///
+/// The simulation's share of the Engine components.
+
+class LComponent{
+  protected:
+    static LTimer* m_pTimer; ///< Pointer to timer.
+    static LSound* m_pAudio; ///< Pointer to audio player.
+}; //LComponent
+
+#endif //__L4RC_HEADLESS_COMPONENT_H__
@@ -0,0 +1,9 @@
+/// \file ComponentIncludes.h
+/// \brief Headless stand-in for the Engine's component includes.
+
+#ifndef __L4RC_HEADLESS_COMPONENTINCLUDES_H__
+#define __L4RC_HEADLESS_COMPONENTINCLUDES_H__
+
+#include "Component.h"
+
+#endif //__L4RC_HEADLESS_COMPONENTINCLUDES_H__
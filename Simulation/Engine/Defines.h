@@ -0,0 +1,50 @@
+/// \file Defines.h
+/// \brief Headless stand-in for the Engine's basic defines.
+///
+/// The simulation uses only a handful of the basic types that the LARC Engine
+/// gets from Windows and DirectXMath. This header provides portable versions
+/// of them so that the simulation can be compiled without Windows,
+/// Direct3D, or the Engine.
+
+#ifndef __L4RC_HEADLESS_DEFINES_H__
+#define __L4RC_HEADLESS_DEFINES_H__
+
+#include <cmath>
+#include <string>
+#include <functional>
+
+typedef unsigned int UINT; ///< Unsigned integer, as in Windows.
+typedef unsigned char BYTE; ///< Byte, as in Windows.
+
+const float XM_PI     = 3.141592654f; ///< Pi, as in DirectXMath.
+const float XM_2PI    = 6.283185307f; ///< Two pi, as in DirectXMath.
+const float XM_PIDIV2 = 1.570796327f; ///< Pi over two, as in DirectXMath.
+const float XM_PIDIV4 = 0.785398163f; ///< Pi over four, as in DirectXMath.
+
+/// \brief A 2D vector.
+///
+/// Just enough of DirectX::SimpleMath::Vector2 for the simulation.
+
+struct Vector2{
+  float x = 0.0f; ///< X coordinate.
+  float y = 0.0f; ///< Y coordinate.
+
+  Vector2(){}; ///< Default constructor.
+  Vector2(float a, float b): x(a), y(b){}; ///< Constructor.
+
+  Vector2& operator+=(const Vector2& v){x += v.x; y += v.y; return *this;}; ///< Add.
+  Vector2& operator-=(const Vector2& v){x -= v.x; y -= v.y; return *this;}; ///< Subtract.
+  Vector2& operator*=(float a){x *= a; y *= a; return *this;}; ///< Scale.
+  Vector2 operator-() const{return Vector2(-x, -y);}; ///< Negate.
+
+  float Length() const{return sqrtf(x*x + y*y);}; ///< Length.
+  float LengthSquared() const{return x*x + y*y;}; ///< Length squared.
+}; //Vector2
+
+inline Vector2 operator+(const Vector2& u, const Vector2& v){return Vector2(u.x + v.x, u.y + v.y);};
+inline Vector2 operator-(const Vector2& u, const Vector2& v){return Vector2(u.x - v.x, u.y - v.y);};
+inline Vector2 operator*(const Vector2& v, float a){return Vector2(v.x*a, v.y*a);};
+inline Vector2 operator*(float a, const Vector2& v){return Vector2(v.x*a, v.y*a);};
+inline Vector2 operator/(const Vector2& v, float a){return Vector2(v.x/a, v.y/a);};
+
+#endif //__L4RC_HEADLESS_DEFINES_H__
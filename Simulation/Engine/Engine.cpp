@@ -0,0 +1,15 @@
+/// \file Engine.cpp
+/// \brief Static members of the headless Engine stand-ins.
+
+#include "Component.h"
+#include "Settings.h"
+
+static LTimer g_cTimer; ///< The timer.
+static LSound g_cAudio; ///< The audio player.
+
+LTimer* LComponent::m_pTimer = &g_cTimer;
+LSound* LComponent::m_pAudio = &g_cAudio;
+
+UINT LSettings::m_nWinWidth = 1024;
+UINT LSettings::m_nWinHeight = 768;
+Vector2 LSettings::m_vWinCenter = Vector2(512.0f, 384.0f);
@@ -0,0 +1,9 @@
+/// \file ParticleEngine.h
+/// \brief Headless stand-in for the Engine's particle engine.
+
+#ifndef __L4RC_HEADLESS_PARTICLEENGINE_H__
+#define __L4RC_HEADLESS_PARTICLEENGINE_H__
+
+class LParticleEngine2D; ///< Particles are only drawn, never simulated headless.
+
+#endif //__L4RC_HEADLESS_PARTICLEENGINE_H__
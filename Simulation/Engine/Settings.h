@@ -0,0 +1,22 @@
+/// \file Settings.h
+/// \brief Headless stand-in for the Engine's settings class LSettings.
+
+#ifndef __L4RC_HEADLESS_SETTINGS_H__
+#define __L4RC_HEADLESS_SETTINGS_H__
+
+#include "Defines.h"
+
+/// \brief Headless settings.
+///
+/// The window size still matters without a window because the edges of the
+/// Physics World are at the edges of the window. The defaults are the ones
+/// in `gamesettings.xml`.
+
+class LSettings{
+  protected:
+    static UINT m_nWinWidth; ///< Window width in pixels.
+    static UINT m_nWinHeight; ///< Window height in pixels.
+    static Vector2 m_vWinCenter; ///< Window center.
+}; //LSettings
+
+#endif //__L4RC_HEADLESS_SETTINGS_H__
@@ -0,0 +1,14 @@
+/// \file SpriteDesc.h
+/// \brief Headless stand-in for the Engine's sprite descriptor.
+
+#ifndef __L4RC_HEADLESS_SPRITEDESC_H__
+#define __L4RC_HEADLESS_SPRITEDESC_H__
+
+/// \brief Headless sprite descriptor.
+///
+/// Nothing gets drawn, so there is nothing to describe.
+
+class LSpriteDesc2D{
+}; //LSpriteDesc2D
+
+#endif //__L4RC_HEADLESS_SPRITEDESC_H__
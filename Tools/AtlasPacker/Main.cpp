@@ -0,0 +1,422 @@
+/// \file Main.cpp
+/// \brief Sprite atlas packer.
+///
+/// Packs the sprite images into one or a few big images, called pages,
+/// and writes an atlas manifest that says where each sprite is. For now
+/// the game reads only the sprite sizes from the manifest, since the
+/// engine's sprite renderer draws whole textures. Usage:
+///
+///     AtlasPacker [-size pixels] [-padding pixels] [-pot] settings-file atlas-file
+///
+/// The sprites and their images are as in `gamesettings.xml`. Sprites
+/// that share an image file share a rectangle. The pages go in the same
+/// folder as the manifest, named after it, so `Media/Images/atlas.atl`
+/// gets `Media/Images/atlas0.png` and so on. The images are packed like
+/// this:
+///
+/// - The images are sorted by their longer side, longest first, and placed
+///   one at a time with the MaxRects algorithm, which keeps a list of the
+///   largest empty rectangles in the page, and puts each image in the
+///   corner of the one that makes the used part of the page grow least.
+/// - Images that don't fit go to the next page. A page is at most the
+///   maximum size (2048 pixels square by default), and is then cut down to
+///   the smallest multiple of 4 pixels in each direction that holds its
+///   images, or the smallest power of two if `-pot` is given.
+/// - Each image is surrounded by a border (1 pixel by default) that copies
+///   its edge pixels outward, so that filtering at the edge of a sprite
+///   never picks up its neighbors.
+///
+/// The pages and manifest are loaded back in and every sprite is checked
+/// against its image file.
+
+#include <algorithm>
+#include <climits>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "AtlasFile.h"
+#include "Image.h"
+#include "SpriteSizes.h"
+
+/// \brief A rectangle.
+///
+/// A rectangle on a page, in pixels from the top left.
+
+struct CRect{
+  int x = 0; ///< Left edge.
+  int y = 0; ///< Top edge.
+  int w = 0; ///< Width.
+  int h = 0; ///< Height.
+}; //CRect
+
+/// \brief An image to be packed.
+///
+/// An image file and the sprites that use it.
+
+struct CItem{
+  std::string m_strFile; ///< Image file name.
+  CImage m_cImage; ///< The image.
+  std::vector<eSprite> m_stdSprite; ///< Sprites that use it.
+  UINT m_nPage = 0; ///< Page that it is on.
+  CRect m_cRect; ///< Where it is on that page, with its border.
+}; //CItem
+
+/// \brief Atlas packer settings.
+///
+/// The settings that say how big the pages can be and how much room
+/// there is around each image.
+
+struct CPackerSettings{
+  UINT m_nSize = 2048; ///< Largest width and height of a page.
+  UINT m_nPadding = 1; ///< Width of the border around each image.
+  bool m_bPowerOfTwo = false; ///< Whether page sizes must be powers of two.
+}; //CPackerSettings
+
+/// Whether one rectangle is inside another.
+/// \param a One rectangle.
+/// \param b The other rectangle.
+/// \return true if a is inside b.
+
+static bool Inside(const CRect& a, const CRect& b){
+  return a.x >= b.x && a.y >= b.y && a.x + a.w <= b.x + b.w && a.y + a.h <= b.y + b.h;
+} //Inside
+
+/// Find where a rectangle fits best among the empty rectangles, which is
+/// where it makes the used part of the page grow the least, and then where
+/// it leaves the least space along the shorter side of the empty rectangle.
+/// \param free Empty rectangles.
+/// \param used Width and height of the part of the page used so far.
+/// \param w Width.
+/// \param h Height.
+/// \param r [out] Where it goes.
+/// \return true if it fits anywhere.
+
+static bool FindPlace(const std::vector<CRect>& free, const CRect& used,
+  int w, int h, CRect& r)
+{
+  long long bestArea = LLONG_MAX; //least used area so far
+  int bestShort = INT_MAX; //least space left so far
+
+  for(const CRect& f: free) //for each empty rectangle
+    if(w <= f.w && h <= f.h){
+      const long long area = (long long)std::max(used.w, f.x + w)*std::max(used.h, f.y + h);
+      const int nShort = std::min(f.w - w, f.h - h); //space left
+
+      if(area < bestArea || (area == bestArea && nShort < bestShort)){
+        bestArea = area;
+        bestShort = nShort;
+        r = {f.x, f.y, w, h};
+      } //if
+    } //if
+
+  return bestArea != LLONG_MAX;
+} //FindPlace
+
+/// Take a rectangle out of the empty rectangles. Each empty rectangle that
+/// it overlaps is replaced by the up to four largest rectangles around it,
+/// and then any empty rectangle inside another is removed.
+/// \param free [in, out] Empty rectangles.
+/// \param r Rectangle that has been filled.
+
+static void Fill(std::vector<CRect>& free, const CRect& r){
+  std::vector<CRect> next; //new empty rectangles
+
+  for(const CRect& f: free){ //for each empty rectangle
+    if(r.x >= f.x + f.w || r.x + r.w <= f.x || r.y >= f.y + f.h || r.y + r.h <= f.y){
+      next.push_back(f); //no overlap
+      continue;
+    } //if
+
+    if(r.x > f.x)next.push_back({f.x, f.y, r.x - f.x, f.h}); //left
+    if(r.x + r.w < f.x + f.w)next.push_back({r.x + r.w, f.y, f.x + f.w - r.x - r.w, f.h}); //right
+    if(r.y > f.y)next.push_back({f.x, f.y, f.w, r.y - f.y}); //top
+    if(r.y + r.h < f.y + f.h)next.push_back({f.x, r.y + r.h, f.w, f.y + f.h - r.y - r.h}); //bottom
+  } //for
+
+  free.clear();
+
+  for(size_t i=0; i<next.size(); i++){ //keep the ones not inside another
+    bool bInside = false;
+
+    for(size_t j=0; j<next.size() && !bInside; j++)
+      bInside = j != i && Inside(next[i], next[j]) &&
+        (!Inside(next[j], next[i]) || j < i); //of two the same, keep the first
+
+    if(!bInside)free.push_back(next[i]);
+  } //for
+} //Fill
+
+/// Round a page width or height up to a power of two or a multiple of 4,
+/// which is what block-compressed textures need.
+/// \param n Width or height in pixels.
+/// \param bPowerOfTwo Whether to round up to a power of two.
+/// \return Rounded width or height.
+
+static UINT RoundUp(UINT n, bool bPowerOfTwo){
+  if(!bPowerOfTwo)return (n + 3) & ~3U;
+
+  UINT p = 1;
+  while(p < n)p <<= 1;
+  return p;
+} //RoundUp
+
+/// Pack the images into pages. Each page takes as many of the images that
+/// are left as will fit, in order from the longest side down.
+/// \param item [in, out] Images, which are given their pages and rectangles.
+/// \param s Settings.
+/// \param size [out] Width and height of each page.
+/// \return true if every image fits on a page.
+
+static bool Pack(std::vector<CItem>& item, const CPackerSettings& s,
+  std::vector<std::pair<UINT, UINT>>& size)
+{
+  const int pad = (int)s.m_nPadding; //border width
+  std::vector<CItem*> order; //images in packing order
+
+  for(CItem& p: item){
+    const int w = (int)p.m_cImage.GetWidth() + 2*pad;
+    const int h = (int)p.m_cImage.GetHeight() + 2*pad;
+
+    if(w > (int)s.m_nSize || h > (int)s.m_nSize){
+      fprintf(stderr, "%s is too big for a page\n", p.m_strFile.c_str());
+      return false;
+    } //if
+
+    order.push_back(&p);
+  } //for
+
+  std::stable_sort(order.begin(), order.end(), [](const CItem* a, const CItem* b){
+    const UINT la = std::max(a->m_cImage.GetWidth(), a->m_cImage.GetHeight());
+    const UINT lb = std::max(b->m_cImage.GetWidth(), b->m_cImage.GetHeight());
+    return la > lb || (la == lb && a->m_cImage.GetWidth()*a->m_cImage.GetHeight() >
+      b->m_cImage.GetWidth()*b->m_cImage.GetHeight());
+  }); //sort
+
+  size.clear();
+
+  while(!order.empty()){ //for each page
+    const UINT page = (UINT)size.size(); //page index
+    std::vector<CRect> free = {{0, 0, (int)s.m_nSize, (int)s.m_nSize}}; //empty rectangles
+    std::vector<CItem*> left; //images that don't fit on this page
+    CRect used = {0, 0, 1, 1}; //part of the page used
+
+    for(CItem* p: order){ //for each image left
+      CRect r; //where it goes
+
+      if(FindPlace(free, used, (int)p->m_cImage.GetWidth() + 2*pad,
+        (int)p->m_cImage.GetHeight() + 2*pad, r))
+      {
+        Fill(free, r);
+        p->m_nPage = page;
+        p->m_cRect = r;
+        used.w = std::max(used.w, r.x + r.w);
+        used.h = std::max(used.h, r.y + r.h);
+      } //if
+
+      else left.push_back(p);
+    } //for
+
+    size.push_back({RoundUp(used.w, s.m_bPowerOfTwo), RoundUp(used.h, s.m_bPowerOfTwo)});
+    order = left;
+  } //while
+
+  return true;
+} //Pack
+
+/// Draw an image on a page with its border, which copies its nearest
+/// edge pixel.
+/// \param page [in, out] Page.
+/// \param p Image and where it goes.
+/// \param pad Border width.
+
+static void Draw(CImage& page, const CItem& p, UINT pad){
+  const CImage& image = p.m_cImage;
+  const int w = (int)image.GetWidth(), h = (int)image.GetHeight(); //image size
+
+  page.Blit(image, p.m_cRect.x + pad, p.m_cRect.y + pad);
+
+  for(int y=-(int)pad; y<h + (int)pad; y++) //for each row of the border
+    for(int x=-(int)pad; x<w + (int)pad; x++) //for each column of the border
+      if(x < 0 || y < 0 || x >= w || y >= h){ //outside the image
+        const int sx = std::max(0, std::min(w - 1, x)); //nearest pixel
+        const int sy = std::max(0, std::min(h - 1, y));
+        memcpy(page.GetPixel(p.m_cRect.x + pad + x, p.m_cRect.y + pad + y),
+          image.GetPixel(sx, sy), 4);
+      } //if
+} //Draw
+
+/// Check the atlas by loading the manifest and pages back in and comparing
+/// every sprite to its image file.
+/// \param fname Manifest file name.
+/// \param item Images.
+/// \return true if every sprite is where the manifest says it is.
+
+static bool Check(const std::string& fname, const std::vector<CItem>& item){
+  CAtlasFile atlas; //manifest
+  if(!atlas.Load(fname))return false;
+
+  std::vector<CImage> page(atlas.GetPageCount()); //pages
+
+  for(UINT i=0; i<atlas.GetPageCount(); i++)
+    if(!page[i].LoadPNG(atlas.GetPageFileName(i)) ||
+      page[i].GetWidth() != atlas.GetPage(i).m_nWidth ||
+      page[i].GetHeight() != atlas.GetPage(i).m_nHeight)
+      return false;
+
+  for(const CItem& p: item) //for each image
+    for(eSprite t: p.m_stdSprite){ //for each sprite that uses it
+      const CAtlasRecord* r = atlas.Get(t); //where it is
+      const CImage& image = p.m_cImage;
+
+      if(r == nullptr || r->m_nWidth != image.GetWidth() || r->m_nHeight != image.GetHeight())
+        return false;
+
+      for(UINT y=0; y<r->m_nHeight; y++)
+        if(memcmp(page[r->m_nPage].GetPixel(r->m_nLeft, r->m_nTop + y),
+          image.GetPixel(0, y), 4*(size_t)r->m_nWidth) != 0)
+          return false;
+    } //for
+
+  return true;
+} //Check
+
+/// Read the settings from the command line, load the sprite images, pack
+/// them, and save the pages and manifest.
+/// \param argc Number of command line arguments.
+/// \param argv Command line arguments.
+/// \return 0 if the atlas was made, otherwise 1.
+
+int main(int argc, char* argv[]){
+  CPackerSettings s; //settings
+  std::vector<std::string> arg; //arguments that are not options
+
+  for(int i=1; i<argc; i++){
+    const std::string a = argv[i];
+    const bool bValue = i + 1 < argc; //whether there is a value after it
+
+    if(a == "-size" && bValue)s.m_nSize = (UINT)std::max(16, atoi(argv[++i]));
+    else if(a == "-padding" && bValue)s.m_nPadding = (UINT)std::max(0, atoi(argv[++i]));
+    else if(a == "-pot")s.m_bPowerOfTwo = true;
+    else arg.push_back(a);
+  } //for
+
+  if(arg.size() != 2){
+    fprintf(stderr, "Usage: %s [-size pixels] [-padding pixels] [-pot] settings-file atlas-file\n", argv[0]);
+    return 1;
+  } //if
+
+  std::vector<std::string> fname; //image file names
+
+  if(!CSpriteSizes::GetImageFiles(arg[0], fname)){
+    fprintf(stderr, "Cannot read %s\n", arg[0].c_str());
+    return 1;
+  } //if
+
+  //load each image file once
+
+  std::vector<CItem> item; //images
+
+  for(UINT i=0; i<(UINT)eSprite::Size; i++){ //for each sprite type
+    if(fname[i].empty()){
+      fprintf(stderr, "No image for %s\n", GetSpriteName((eSprite)i));
+      continue;
+    } //if
+
+    size_t j = 0;
+    while(j < item.size() && item[j].m_strFile != fname[i])j++;
+
+    if(j == item.size()){ //new image file
+      item.emplace_back();
+      item[j].m_strFile = fname[i];
+
+      if(!item[j].m_cImage.LoadPNG(fname[i])){
+        fprintf(stderr, "Cannot load %s\n", fname[i].c_str());
+        return 1;
+      } //if
+    } //if
+
+    item[j].m_stdSprite.push_back((eSprite)i);
+  } //for
+
+  std::vector<std::pair<UINT, UINT>> size; //page sizes
+  if(!Pack(item, s, size))return 1;
+
+  //draw and save the pages
+
+  const size_t slash = arg[1].find_last_of("/\\"); //end of folder name
+  const std::string folder = slash == std::string::npos? "": arg[1].substr(0, slash + 1);
+  std::string base = arg[1].substr(folder.size());
+  base = base.substr(0, base.rfind('.'));
+
+  std::vector<CAtlasPage> pages; //page records
+
+  for(UINT i=0; i<size.size(); i++){ //for each page
+    CAtlasPage page = {{0}, size[i].first, size[i].second};
+    const std::string name = base + std::to_string(i) + ".png";
+
+    if(name.size() >= sizeof(page.m_szFile)){
+      fprintf(stderr, "Page name %s is too long\n", name.c_str());
+      return 1;
+    } //if
+
+    strcpy(page.m_szFile, name.c_str());
+    pages.push_back(page);
+
+    CImage image; //page image
+    image.Create(page.m_nWidth, page.m_nHeight);
+    size_t nUsed = 0; //pixels used
+
+    for(const CItem& p: item)
+      if(p.m_nPage == i){
+        Draw(image, p, s.m_nPadding);
+        nUsed += (size_t)p.m_cImage.GetWidth()*p.m_cImage.GetHeight();
+      } //if
+
+    if(!image.SavePNG(folder + name)){
+      fprintf(stderr, "Cannot write %s\n", (folder + name).c_str());
+      return 1;
+    } //if
+
+    printf("%s %4u x %4u, %5.1f%% used\n", name.c_str(), page.m_nWidth, page.m_nHeight,
+      100.0*nUsed/((double)page.m_nWidth*page.m_nHeight));
+  } //for
+
+  //sprite records, in sprite order
+
+  std::vector<CAtlasRecord> records; //sprite records
+
+  for(UINT t=0; t<(UINT)eSprite::Size; t++) //for each sprite type
+    for(const CItem& p: item)
+      if(std::find(p.m_stdSprite.begin(), p.m_stdSprite.end(), (eSprite)t) != p.m_stdSprite.end()){
+        const CAtlasPage& page = pages[p.m_nPage];
+        CAtlasRecord r;
+        r.m_nSprite = t;
+        r.m_nPage = p.m_nPage;
+        r.m_nLeft = p.m_cRect.x + s.m_nPadding;
+        r.m_nTop = p.m_cRect.y + s.m_nPadding;
+        r.m_nWidth = p.m_cImage.GetWidth();
+        r.m_nHeight = p.m_cImage.GetHeight();
+        r.m_fU0 = (float)r.m_nLeft/page.m_nWidth;
+        r.m_fV0 = (float)r.m_nTop/page.m_nHeight;
+        r.m_fU1 = (float)(r.m_nLeft + r.m_nWidth)/page.m_nWidth;
+        r.m_fV1 = (float)(r.m_nTop + r.m_nHeight)/page.m_nHeight;
+        records.push_back(r);
+      } //if
+
+  if(!CAtlasFile::Save(arg[1], pages, records)){
+    fprintf(stderr, "Cannot write %s\n", arg[1].c_str());
+    return 1;
+  } //if
+
+  if(!Check(arg[1], item)){
+    fprintf(stderr, "%s does not match the sprite images\n", arg[1].c_str());
+    return 1;
+  } //if
+
+  printf("Packed %u sprites from %u images into %u pages in %s\n",
+    (UINT)records.size(), (UINT)item.size(), (UINT)pages.size(), arg[1].c_str());
+  return 0;
+} //main
@@ -0,0 +1,692 @@
+/// \file Main.cpp
+/// \brief Collision hull builder.
+///
+/// Makes the collision shapes of the sprites from the alpha masks of their
+/// images and saves them to a hull file that the machine loads when it
+/// builds the level. Usage:
+///
+///     HullBuilder [-alpha n] [-vertices n] [-fixtures n] [-tolerance pixels]
+///       settings-file hull-file [sprite ...]
+///
+/// The sprites are named as in `gamesettings.xml`, which says where their
+/// images are. If none are named, the sprites whose shapes are polygons
+/// are done. Each sprite's shape is found like this:
+///
+/// - The pixels whose alpha is at least the alpha threshold (128 by
+///   default) make a mask, of which only the largest 4-connected piece is
+///   kept. Places where pixels touch only at a corner are filled in, so
+///   that its outline is a simple polygon on the pixel grid.
+/// - The outline is simplified with the Douglas-Peucker algorithm, which
+///   keeps every point of the outline within the tolerance (1.5 pixels by
+///   default) of the simplified polygon.
+/// - The simplified polygon is cut into triangles by ear clipping, and then
+///   the triangles are merged back together into convex polygons with the
+///   Hertel-Mehlhorn algorithm, removing the longest diagonals first, as
+///   long as no polygon has more than the vertex budget (8 by default,
+///   which is the most that Box2D allows).
+/// - If that makes more polygons than the fixture budget (3 by default),
+///   the tolerance is increased and it is all done again. If even the
+///   coarsest outline needs too many, the convex hull of the outline is
+///   used instead, with corners cut off until it is within the vertex
+///   budget.
+///
+/// The vertices are all on the pixel grid, so they are kept as integers
+/// and the geometry is exact.
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "HullFile.h"
+#include "Image.h"
+#include "SpriteSizes.h"
+
+/// \brief A point on the pixel grid.
+///
+/// A corner of a pixel, in pixels from the top left of the image.
+
+struct CPoint{
+  int x = 0; ///< X coordinate.
+  int y = 0; ///< Y coordinate.
+}; //CPoint
+
+typedef std::vector<CPoint> CPolygon; ///< A polygon, as its vertices in order.
+typedef std::vector<UINT> CPiece; ///< A piece of a polygon, as vertex indices.
+
+/// \brief Hull builder settings.
+///
+/// The settings that say how closely and with how many fixtures and
+/// vertices the sprites' shapes are fitted.
+
+struct CHullSettings{
+  BYTE m_nAlpha = 128; ///< Least alpha of a pixel in the shape.
+  UINT m_nVertices = CHullFile::MAXVERTICES; ///< Most vertices in a polygon.
+  UINT m_nFixtures = 3; ///< Most polygons in a shape.
+  double m_fTolerance = 1.5; ///< Initial simplification tolerance in pixels.
+}; //CHullSettings
+
+/// Twice the signed area of a triangle, which is positive if its vertices
+/// are in the same order as those of the outlines.
+/// \param a First vertex.
+/// \param b Second vertex.
+/// \param c Third vertex.
+/// \return The cross product of b - a and c - a.
+
+static long long Cross(const CPoint& a, const CPoint& b, const CPoint& c){
+  return (long long)(b.x - a.x)*(c.y - a.y) - (long long)(b.y - a.y)*(c.x - a.x);
+} //Cross
+
+/// Twice the signed area of a polygon.
+/// \param p Polygon.
+/// \return Twice its area.
+
+static long long Area2(const CPolygon& p){
+  long long a = 0; //twice the area
+
+  for(size_t i=0, j=p.size() - 1; i<p.size(); j=i++) //for each edge
+    a += (long long)p[j].x*p[i].y - (long long)p[i].x*p[j].y;
+
+  return a;
+} //Area2
+
+/// Find the outline of the shape in an image. The pixels whose alpha is
+/// at least the threshold make a mask. Only the largest 4-connected piece
+/// of the mask is kept, and pixels are added where two of its pixels touch
+/// only at a corner, so that its outline is a simple polygon. The outline
+/// goes around the outside of the mask, filling any holes, with a vertex
+/// wherever it turns a corner.
+/// \param image Image.
+/// \param alpha Alpha threshold.
+/// \param outline [out] Outline, with positive area.
+/// \param nPixels [out] Number of pixels in the mask.
+/// \return true if there were any pixels in the mask.
+
+static bool GetOutline(const CImage& image, BYTE alpha, CPolygon& outline,
+  UINT& nPixels)
+{
+  const int w = (int)image.GetWidth(); //image width
+  const int h = (int)image.GetHeight(); //image height
+  std::vector<int> mask((size_t)w*h, 0); //piece number of each pixel, 0 for none
+  auto At = [&](int x, int y){return x >= 0 && y >= 0 && x < w && y < h && mask[y*w + x] > 0;};
+
+  for(int y=0; y<h; y++)
+    for(int x=0; x<w; x++)
+      mask[y*w + x] = image.GetAlpha(x, y) >= alpha? -1: 0; //-1 means not numbered yet
+
+  //number the 4-connected pieces, and find the largest
+
+  int nLargest = 0; //largest piece
+  size_t nLargestSize = 0; //size of largest piece
+  std::vector<int> stack; //pixels to visit
+
+  for(int i=0, n=1; i<w*h; i++) //for each pixel
+    if(mask[i] < 0){ //start a new piece
+      size_t size = 0; //size of this piece
+      mask[i] = n;
+      stack.push_back(i);
+
+      while(!stack.empty()){
+        const int j = stack.back(); //next pixel
+        const int x = j%w, y = j/w; //its coordinates
+        stack.pop_back();
+        size++;
+
+        for(int k: {x > 0? j - 1: -1, x < w - 1? j + 1: -1, y > 0? j - w: -1, y < h - 1? j + w: -1})
+          if(k >= 0 && mask[k] < 0){
+            mask[k] = n;
+            stack.push_back(k);
+          } //if
+      } //while
+
+      if(size > nLargestSize){
+        nLargest = n;
+        nLargestSize = size;
+      } //if
+
+      n++;
+    } //if
+
+  if(nLargest == 0)return false;
+
+  for(int& m: mask) //keep the largest piece only
+    m = m == nLargest? 1: 0;
+
+  //fill in where pixels touch only at a corner
+
+  for(bool bChanged=true; bChanged;){
+    bChanged = false;
+
+    for(int y=0; y<h - 1; y++)
+      for(int x=0; x<w - 1; x++){
+        const bool a = At(x, y), b = At(x + 1, y); //top left and right
+        const bool c = At(x, y + 1), d = At(x + 1, y + 1); //bottom left and right
+
+        if(a && d && !b && !c){mask[y*w + x + 1] = 1; bChanged = true;}
+        else if(b && c && !a && !d){mask[y*w + x] = 1; bChanged = true;}
+      } //for
+  } //for
+
+  nPixels = (UINT)std::count(mask.begin(), mask.end(), 1);
+
+  //boundary edges, going clockwise on the screen around each pixel,
+  //indexed by the corner that they start at
+
+  const int stride = w + 1; //corners per row
+  std::vector<int> next((size_t)stride*(h + 1), -1); //end of edge from each corner
+  int start = -1; //corner to start at
+
+  for(int y=0; y<h; y++)
+    for(int x=0; x<w; x++)
+      if(At(x, y)){
+        const int c = y*stride + x; //top left corner
+
+        if(!At(x, y - 1))next[c] = c + 1; //top
+        if(!At(x + 1, y))next[c + 1] = c + 1 + stride; //right
+        if(!At(x, y + 1))next[c + 1 + stride] = c + stride; //bottom
+        if(!At(x - 1, y))next[c + stride] = c; //left
+
+        if(start < 0)start = c; //the top of the first pixel is on the outline
+      } //if
+
+  //follow the edges around the outside, keeping the corners where it turns
+
+  CPolygon path; //every corner on the outline
+
+  for(int c=start; path.empty() || c != start; c=next[c]){
+    if(c < 0 || path.size() > next.size())return false; //broken outline, which can't happen
+    path.push_back({c%stride, c/stride});
+  } //for
+
+  outline.clear();
+
+  for(size_t i=0; i<path.size(); i++){ //for each corner
+    const CPoint& a = path[(i + path.size() - 1)%path.size()];
+    const CPoint& c = path[(i + 1)%path.size()];
+    if(Cross(a, path[i], c) != 0)outline.push_back(path[i]);
+  } //for
+
+  if(Area2(outline) < 0)
+    std::reverse(outline.begin(), outline.end());
+
+  return true;
+} //GetOutline
+
+/// Distance from a point to a line segment.
+/// \param p Point.
+/// \param a One end of the line segment.
+/// \param b The other end of the line segment.
+/// \return Distance.
+
+static double Distance(const CPoint& p, const CPoint& a, const CPoint& b){
+  const double dx = b.x - a.x, dy = b.y - a.y; //direction of line segment
+  const double len2 = dx*dx + dy*dy; //its length squared
+  double t = len2 > 0? ((p.x - a.x)*dx + (p.y - a.y)*dy)/len2: 0; //parameter of nearest point
+
+  t = std::max(0.0, std::min(1.0, t));
+  return hypot(p.x - a.x - t*dx, p.y - a.y - t*dy);
+} //Distance
+
+/// Mark the points of an open chain that the Douglas-Peucker algorithm
+/// keeps. The ends are already kept.
+/// \param p Points, which wrap around.
+/// \param first Index of first end of chain.
+/// \param last Index of last end of chain, which may be less than first.
+/// \param t Tolerance.
+/// \param keep [in, out] Whether to keep each point.
+
+static void DouglasPeucker(const CPolygon& p, size_t first, size_t last,
+  double t, std::vector<bool>& keep)
+{
+  const size_t n = p.size(); //number of points
+  double dmax = 0; //greatest distance from chord
+  size_t imax = first; //point at that distance
+
+  for(size_t i=(first + 1)%n; i!=last; i=(i + 1)%n){ //for each point between
+    const double d = Distance(p[i], p[first], p[last]);
+
+    if(d > dmax){
+      dmax = d;
+      imax = i;
+    } //if
+  } //for
+
+  if(dmax > t){
+    keep[imax] = true;
+    DouglasPeucker(p, first, imax, t, keep);
+    DouglasPeucker(p, imax, last, t, keep);
+  } //if
+} //DouglasPeucker
+
+/// Simplify a closed outline with the Douglas-Peucker algorithm. It is
+/// split into two chains at its first vertex and the vertex farthest from
+/// that, and each chain is simplified separately.
+/// \param outline Outline.
+/// \param t Tolerance.
+/// \param p [out] Simplified outline.
+
+static void Simplify(const CPolygon& outline, double t, CPolygon& p){
+  const size_t n = outline.size(); //number of points
+  size_t far = 0; //point farthest from the first
+  double dmax = 0; //its distance
+
+  for(size_t i=1; i<n; i++){
+    const double d = hypot(outline[i].x - outline[0].x, outline[i].y - outline[0].y);
+
+    if(d > dmax){
+      dmax = d;
+      far = i;
+    } //if
+  } //for
+
+  std::vector<bool> keep(n, false); //whether to keep each point
+  keep[0] = keep[far] = true;
+  DouglasPeucker(outline, 0, far, t, keep);
+  DouglasPeucker(outline, far, 0, t, keep);
+
+  p.clear();
+
+  for(size_t i=0; i<n; i++)
+    if(keep[i])p.push_back(outline[i]);
+} //Simplify
+
+/// Whether two line segments touch or cross.
+/// \param a One end of the first line segment.
+/// \param b The other end of the first line segment.
+/// \param c One end of the second line segment.
+/// \param d The other end of the second line segment.
+/// \return true if they have a point in common.
+
+static bool Intersect(const CPoint& a, const CPoint& b, const CPoint& c, const CPoint& d){
+  const long long d1 = Cross(c, d, a), d2 = Cross(c, d, b); //sides of a and b
+  const long long d3 = Cross(a, b, c), d4 = Cross(a, b, d); //sides of c and d
+
+  if(((d1 > 0 && d2 < 0) || (d1 < 0 && d2 > 0)) && ((d3 > 0 && d4 < 0) || (d3 < 0 && d4 > 0)))
+    return true; //they cross
+
+  auto OnSegment = [](const CPoint& p, const CPoint& q, const CPoint& r){ //r on pq, given collinear
+    return std::min(p.x, q.x) <= r.x && r.x <= std::max(p.x, q.x) &&
+      std::min(p.y, q.y) <= r.y && r.y <= std::max(p.y, q.y);
+  }; //OnSegment
+
+  return (d1 == 0 && OnSegment(c, d, a)) || (d2 == 0 && OnSegment(c, d, b)) ||
+    (d3 == 0 && OnSegment(a, b, c)) || (d4 == 0 && OnSegment(a, b, d));
+} //Intersect
+
+/// Whether a polygon is simple, that is, whether its edges meet only at
+/// the ends of neighboring edges. Simplifying an outline can make it cross
+/// itself where the shape is thin.
+/// \param p Polygon.
+/// \return true if it is simple.
+
+static bool IsSimple(const CPolygon& p){
+  const size_t n = p.size(); //number of vertices
+
+  for(size_t i=0; i<n; i++){ //for each vertex
+    const CPoint& a = p[(i + n - 1)%n], b = p[i], c = p[(i + 1)%n]; //it and its neighbors
+
+    if(Cross(a, b, c) == 0 && (long long)(b.x - a.x)*(c.x - b.x) + (long long)(b.y - a.y)*(c.y - b.y) < 0)
+      return false; //doubles back on itself
+  } //for
+
+  for(size_t i=0; i<n; i++) //for each edge
+    for(size_t j=i + 2; j<n; j++) //for each later edge that is not its neighbor
+      if((i > 0 || j < n - 1) && Intersect(p[i], p[i + 1], p[j], p[(j + 1)%n]))
+        return false;
+
+  return true;
+} //IsSimple
+
+/// Whether a point is in a triangle or on its boundary.
+/// \param p Point.
+/// \param a First vertex of triangle, which has positive area.
+/// \param b Second vertex of triangle.
+/// \param c Third vertex of triangle.
+/// \return true if the point is in the triangle.
+
+static bool InTriangle(const CPoint& p, const CPoint& a, const CPoint& b, const CPoint& c){
+  return Cross(a, b, p) >= 0 && Cross(b, c, p) >= 0 && Cross(c, a, p) >= 0;
+} //InTriangle
+
+/// Cut a simple polygon into triangles by ear clipping. An ear is a vertex
+/// where the polygon turns left and whose triangle with its neighbors has
+/// no other vertex in it. Cutting off an ear leaves a simple polygon with
+/// one vertex fewer. Vertices where the polygon goes straight on are
+/// dropped without making a triangle.
+/// \param p Polygon, which must be simple with positive area.
+/// \param tri [out] Triangles, as vertex indices.
+/// \return true if it was triangulated.
+
+static bool Triangulate(const CPolygon& p, std::vector<CPiece>& tri){
+  CPiece v(p.size()); //vertices left
+  for(UINT i=0; i<(UINT)v.size(); i++)v[i] = i;
+
+  tri.clear();
+
+  while(v.size() > 3){
+    const size_t n = v.size(); //number of vertices left
+    size_t ear = n; //ear found
+    size_t flat = n; //vertex found where the polygon goes straight on
+
+    for(size_t i=0; i<n && ear == n; i++){ //look for an ear
+      const UINT a = v[(i + n - 1)%n], b = v[i], c = v[(i + 1)%n];
+      const long long cross = Cross(p[a], p[b], p[c]);
+
+      if(cross == 0 && flat == n)flat = i;
+      if(cross <= 0)continue; //not convex
+
+      bool bEar = true;
+
+      for(size_t j=0; j<n && bEar; j++){ //check other vertices are outside
+        const UINT k = v[j];
+        if(k != a && k != b && k != c && InTriangle(p[k], p[a], p[b], p[c]))
+          bEar = false;
+      } //for
+
+      if(bEar)ear = i;
+    } //for
+
+    if(ear < n){ //cut off the ear
+      tri.push_back({v[(ear + n - 1)%n], v[ear], v[(ear + 1)%n]});
+      v.erase(v.begin() + ear);
+    } //if
+
+    else if(flat < n)v.erase(v.begin() + flat); //drop the flat vertex
+    else return false; //no ear, which can't happen for a simple polygon
+  } //while
+
+  if(Cross(p[v[0]], p[v[1]], p[v[2]]) > 0)
+    tri.push_back(v);
+
+  return true;
+} //Triangulate
+
+/// Merge two convex pieces that share an edge, if the result is convex
+/// and has no more than the vertex budget. Vertices where the result goes
+/// straight on are dropped.
+/// \param p Polygon that the pieces are of.
+/// \param a First piece, in which the shared edge goes from a[i] to a[i + 1].
+/// \param i Index in a of the start of the shared edge.
+/// \param b Second piece, in which the shared edge goes from b[j] to b[j + 1].
+/// \param j Index in b of the start of the shared edge.
+/// \param nMax Vertex budget.
+/// \param merged [out] Merged piece.
+/// \return true if they were merged.
+
+static bool Merge(const CPolygon& p, const CPiece& a, size_t i, const CPiece& b,
+  size_t j, UINT nMax, CPiece& merged)
+{
+  CPiece v; //vertices of merged piece
+
+  for(size_t k=1; k<=a.size(); k++) //around a, from the end of the shared edge to its start
+    v.push_back(a[(i + k)%a.size()]);
+
+  for(size_t k=2; k<b.size(); k++) //around b, skipping the shared edge
+    v.push_back(b[(j + k)%b.size()]);
+
+  merged.clear();
+
+  for(size_t k=0; k<v.size(); k++){ //for each vertex
+    const long long cross = Cross(p[v[(k + v.size() - 1)%v.size()]], p[v[k]], p[v[(k + 1)%v.size()]]);
+    if(cross < 0)return false; //not convex
+    if(cross > 0)merged.push_back(v[k]);
+  } //for
+
+  return merged.size() <= nMax;
+} //Merge
+
+/// Merge triangles into convex pieces with the Hertel-Mehlhorn algorithm.
+/// Two pieces that share an edge are merged if the result is convex and
+/// within the vertex budget. The longest shared edges are removed first,
+/// since they tend to leave the fewest pieces.
+/// \param p Polygon that the pieces are of.
+/// \param nMax Vertex budget.
+/// \param piece [in, out] Pieces.
+
+static void MergePieces(const CPolygon& p, UINT nMax, std::vector<CPiece>& piece){
+  for(;;){
+    long long best = -1; //length squared of the longest edge that can be removed
+    size_t bestA = 0, bestB = 0; //pieces on either side of it
+    CPiece bestMerged; //piece that removing it would make
+    CPiece merged; //piece made by removing an edge
+
+    for(size_t a=0; a<piece.size(); a++) //for each piece
+      for(size_t i=0; i<piece[a].size(); i++){ //for each edge
+        const UINT u = piece[a][i], v = piece[a][(i + 1)%piece[a].size()]; //its ends
+        const long long dx = p[v].x - p[u].x, dy = p[v].y - p[u].y;
+        if(dx*dx + dy*dy <= best)continue;
+
+        for(size_t b=a + 1; b<piece.size(); b++) //look for it in a later piece
+          for(size_t j=0; j<piece[b].size(); j++)
+            if(piece[b][j] == v && piece[b][(j + 1)%piece[b].size()] == u &&
+              Merge(p, piece[a], i, piece[b], j, nMax, merged))
+            {
+              best = dx*dx + dy*dy;
+              bestA = a;
+              bestB = b;
+              bestMerged = merged;
+            } //if
+      } //for
+
+    if(best < 0)return; //nothing more can be merged
+
+    piece[bestA] = bestMerged;
+    piece.erase(piece.begin() + bestB);
+  } //for
+} //MergePieces
+
+/// Find the convex hull of a polygon by Andrew's monotone chain algorithm,
+/// then cut off the corners that lose the least area until it has no more
+/// than the vertex budget.
+/// \param outline Polygon.
+/// \param nMax Vertex budget.
+/// \param hull [out] Convex hull, with positive area.
+
+static void ConvexHull(const CPolygon& outline, UINT nMax, CPolygon& hull){
+  CPolygon p = outline;
+
+  std::sort(p.begin(), p.end(), [](const CPoint& a, const CPoint& b){
+    return a.x < b.x || (a.x == b.x && a.y < b.y);});
+
+  hull.assign(2*p.size(), CPoint());
+  size_t k = 0; //number of hull vertices so far
+
+  for(size_t i=0; i<p.size(); i++){ //lower hull
+    while(k >= 2 && Cross(hull[k - 2], hull[k - 1], p[i]) <= 0)k--;
+    hull[k++] = p[i];
+  } //for
+
+  for(size_t i=p.size() - 1, t=k + 1; i>0; i--){ //upper hull
+    while(k >= t && Cross(hull[k - 2], hull[k - 1], p[i - 1]) <= 0)k--;
+    hull[k++] = p[i - 1];
+  } //for
+
+  hull.resize(k - 1); //the last point is the first
+
+  while(hull.size() > nMax){ //cut off corners
+    const size_t n = hull.size(); //number of vertices
+    size_t best = 0; //corner that loses the least area
+    long long least = -1; //twice that area
+
+    for(size_t i=0; i<n; i++){
+      const long long a = Cross(hull[(i + n - 1)%n], hull[i], hull[(i + 1)%n]);
+
+      if(least < 0 || a < least){
+        least = a;
+        best = i;
+      } //if
+    } //for
+
+    hull.erase(hull.begin() + best);
+  } //while
+} //ConvexHull
+
+/// Cut an outline into convex polygons within the vertex and fixture
+/// budgets, fitting the outline as closely as possible. The tolerance
+/// starts at the initial tolerance and goes up by half each time there
+/// are too many polygons. Tiny slivers are dropped.
+/// \param outline Outline.
+/// \param size Larger of the image width and height, which is the
+///   coarsest tolerance.
+/// \param s Settings.
+/// \param result [out] Convex polygons.
+/// \param t [out] Tolerance used, or zero if the convex hull was used.
+
+static void Decompose(const CPolygon& outline, int size, const CHullSettings& s,
+  std::vector<CPolygon>& result, double& t)
+{
+  CPolygon p; //simplified outline
+  std::vector<CPiece> piece; //pieces of it
+
+  for(t=s.m_fTolerance; t<=size; t*=1.5){
+    Simplify(outline, t, p);
+
+    if(p.size() < 3 || Area2(p) <= 0 || !IsSimple(p) || !Triangulate(p, piece))
+      continue;
+
+    MergePieces(p, s.m_nVertices, piece);
+    result.clear();
+
+    for(const CPiece& v: piece){ //for each piece
+      CPolygon q; //its vertices
+      for(UINT i: v)q.push_back(p[i]);
+      if(Area2(q) >= 4)result.push_back(q); //drop slivers of less than 2 square pixels
+    } //for
+
+    if(!result.empty() && result.size() <= s.m_nFixtures)
+      return;
+  } //for
+
+  t = 0; //no good, so use the convex hull
+  result.assign(1, CPolygon());
+  ConvexHull(outline, s.m_nVertices, result[0]);
+} //Decompose
+
+/// Make the collision shape of a sprite from the alpha mask of its image,
+/// add its hull records, and print what was made.
+/// \param t Sprite type.
+/// \param fname Image file name.
+/// \param s Settings.
+/// \param records [in, out] Hull records.
+/// \return true if the image could be read and had a shape in it.
+
+static bool MakeHulls(eSprite t, const std::string& fname, const CHullSettings& s,
+  std::vector<CHullRecord>& records)
+{
+  CImage image;
+
+  if(!image.LoadPNG(fname)){
+    fprintf(stderr, "Cannot read %s\n", fname.c_str());
+    return false;
+  } //if
+
+  CPolygon outline; //outline of the mask
+  UINT nPixels = 0; //number of pixels in the mask
+
+  if(!GetOutline(image, s.m_nAlpha, outline, nPixels)){
+    fprintf(stderr, "Nothing opaque in %s\n", fname.c_str());
+    return false;
+  } //if
+
+  std::vector<CPolygon> hull; //convex polygons
+  double tolerance = 0; //tolerance used
+  Decompose(outline, (int)std::max(image.GetWidth(), image.GetHeight()), s, hull, tolerance);
+
+  long long area = 0; //twice the area of the polygons
+  UINT nVertices = 0; //number of vertices in them
+
+  for(const CPolygon& p: hull){ //for each polygon
+    CHullRecord r = {(unsigned short)t, (unsigned short)p.size(), {{0}}};
+
+    for(size_t i=0; i<p.size(); i++){
+      r.m_nVertex[i][0] = (unsigned short)p[i].x;
+      r.m_nVertex[i][1] = (unsigned short)p[i].y;
+    } //for
+
+    records.push_back(r);
+    area += Area2(p);
+    nVertices += (UINT)p.size();
+  } //for
+
+  printf("%-14s %2u fixtures %3u vertices, %s %4.1f, area %7.1f of %6u pixels, box %6u\n",
+    GetSpriteName(t), (UINT)hull.size(), nVertices,
+    tolerance > 0? "tolerance": "hull     ", tolerance, area/2.0, nPixels,
+    image.GetWidth()*image.GetHeight());
+
+  return true;
+} //MakeHulls
+
+/// Read the settings from the command line, make the hulls of the sprites
+/// named on it, or the polygon ones by default, and save them.
+/// \param argc Number of command line arguments.
+/// \param argv Command line arguments.
+/// \return 0 if the hull file was made, otherwise 1.
+
+int main(int argc, char* argv[]){
+  CHullSettings s; //settings
+  std::vector<std::string> arg; //arguments that are not options
+
+  for(int i=1; i<argc; i++){
+    const std::string a = argv[i];
+    const bool bValue = i + 1 < argc; //whether there is a value after it
+
+    if(a == "-alpha" && bValue)s.m_nAlpha = (BYTE)std::max(1, std::min(255, atoi(argv[++i])));
+    else if(a == "-vertices" && bValue)s.m_nVertices = (UINT)std::max(3, std::min((int)CHullFile::MAXVERTICES, atoi(argv[++i])));
+    else if(a == "-fixtures" && bValue)s.m_nFixtures = (UINT)std::max(1, atoi(argv[++i]));
+    else if(a == "-tolerance" && bValue)s.m_fTolerance = std::max(0.5, atof(argv[++i]));
+    else arg.push_back(a);
+  } //for
+
+  if(arg.size() < 2){
+    fprintf(stderr, "Usage: %s [-alpha n] [-vertices n] [-fixtures n] [-tolerance pixels] "
+      "settings-file hull-file [sprite ...]\n", argv[0]);
+    return 1;
+  } //if
+
+  std::vector<std::string> fname; //image file names
+
+  if(!CSpriteSizes::GetImageFiles(arg[0], fname)){
+    fprintf(stderr, "Cannot read %s\n", arg[0].c_str());
+    return 1;
+  } //if
+
+  std::vector<eSprite> sprite; //sprites to do
+
+  if(arg.size() == 2) //the sprites whose shapes are polygons
+    sprite = {eSprite::Pig, eSprite::Ramp, eSprite::Bumper, eSprite::Platform,
+      eSprite::Smallplatform, eSprite::Pin, eSprite::Block, eSprite::Stick,
+      eSprite::Base, eSprite::Catapult};
+
+  for(size_t i=2; i<arg.size(); i++){ //look up sprite names
+    UINT t = 0; //sprite type
+    while(t < (UINT)eSprite::Size && arg[i] != GetSpriteName((eSprite)t))t++;
+
+    if(t == (UINT)eSprite::Size){
+      fprintf(stderr, "Unknown sprite %s\n", arg[i].c_str());
+      return 1;
+    } //if
+
+    sprite.push_back((eSprite)t);
+  } //for
+
+  std::vector<CHullRecord> records; //hull records
+
+  for(eSprite t: sprite) //for each sprite to do
+    if(fname[(UINT)t].empty() || !MakeHulls(t, fname[(UINT)t], s, records)){
+      fprintf(stderr, "No hull for %s\n", GetSpriteName(t));
+      return 1;
+    } //if
+
+  CHullFile hulls; //check by loading it back in
+
+  if(!CHullFile::Save(arg[1], records) || !hulls.Load(arg[1])){
+    fprintf(stderr, "Cannot write %s\n", arg[1].c_str());
+    return 1;
+  } //if
+
+  printf("Wrote %u hulls to %s\n", hulls.GetCount(), arg[1].c_str());
+  return 0;
+} //main
@@ -0,0 +1,44 @@
+/// \file Main.cpp 
+/// \brief Level converter.
+///
+/// Converts a level from the readable text form to the binary form that
+/// the game loads. Usage:
+///
+///     LevelConverter text-file binary-file
+///
+/// See CLevel::Convert() for the text form.
+
+#include <cstdio>
+#include <string>
+
+#include "Level.h"
+
+/// Convert the text level file named by the first argument to a binary
+/// level file named by the second argument.
+/// \param argc Number of command line arguments.
+/// \param argv Command line arguments.
+/// \return 0 if the conversion succeeded, otherwise 1.
+
+int main(int argc, char* argv[]){
+  if(argc != 3){
+    fprintf(stderr, "Usage: %s text-file binary-file\n", argv[0]);
+    return 1;
+  } //if
+
+  std::string error; //error message
+
+  if(!CLevel::Convert(argv[1], argv[2], error)){
+    fprintf(stderr, "%s\n", error.c_str());
+    return 1;
+  } //if
+
+  CLevel level; //check by loading it back in
+
+  if(!level.Load(argv[2])){
+    fprintf(stderr, "Cannot load %s\n", argv[2]);
+    return 1;
+  } //if
+
+  printf("Wrote %u parts to %s\n", level.GetCount(), argv[2]);
+  return 0;
+} //main